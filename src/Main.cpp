@@ -14,12 +14,14 @@
 //
 // SPDX-License-Identifier: Apache-2.0
 
+#include <errno.h>
+#include <fcntl.h>
 #include <signal.h>
 #include <stdlib.h>
+#include <unistd.h>
 
-#include <sstream>
-#include <fstream>
 #include <gio/gio.h>
+#include <glib-unix.h>
 
 #include "MainDaemon.h"
 #include "util/Logger.h"
@@ -27,42 +29,59 @@
 
 static const char* CLASS_NAME = "Main";
 
-void signal_handler(int signal, siginfo_t *siginfo, void *context)
-{
-    string buf;
-    stringstream stream;
-    string sender_pid, sender_cmdline;
-    int si_code;
+// The signal handler only writes the signal to the pipe. It is handled in the main loop,
+// because logging takes locks and reading /proc is not async-signal-safe.
+struct SignalInfo {
+    int signal;
+    int code;
+    pid_t pid;
+    uid_t uid;
+};
 
-    // abstract sender_pid from struct
-    stream << siginfo->si_pid;
-    sender_pid = stream.str();
-    sender_cmdline = "/proc/" + sender_pid + "/cmdline";
-    si_code = siginfo->si_code;
+static int s_signalPipe[2] = { -1, -1 };
 
-    Logger::warning(CLASS_NAME, __FUNCTION__, Logger::format("signal(%d) si_code(%d) sender_pid(%s) sender_cmdline(%s)", signal, si_code, sender_pid.c_str(), sender_cmdline.c_str()));
-    buf = File::readFile(sender_cmdline.c_str());
-    if (buf.empty()) {
-        Logger::warning(CLASS_NAME, __FUNCTION__, Logger::format("signal(%d) si_code(%d) si_pid(%d), si_uid(%d)", signal, si_code, siginfo->si_pid, siginfo->si_uid));
-        goto Done;
+void signal_handler(int signal, siginfo_t *siginfo, void *context)
+{
+    SignalInfo info = { signal, siginfo->si_code, siginfo->si_pid, siginfo->si_uid };
+    int savedErrno = errno;
+    if (write(s_signalPipe[1], &info, sizeof(info)) == -1) {
+        // The pipe is full. The signal is dropped
     }
+    errno = savedErrno;
+}
 
-    Logger::warning(CLASS_NAME, __FUNCTION__, Logger::format("signal(%d) si_code(%d) sender(%s) si_pid(%d), si_uid(%d)", signal, si_code, buf.c_str(), siginfo->si_pid, siginfo->si_uid));
+static gboolean onSignal(gint fd, GIOCondition condition, gpointer data)
+{
+    SignalInfo info;
+    while (read(fd, &info, sizeof(info)) == sizeof(info)) {
+        string cmdline = File::readFile(Logger::format("/proc/%d/cmdline", (int)info.pid).c_str());
+        if (cmdline.empty()) {
+            Logger::warning(CLASS_NAME, __FUNCTION__, Logger::format("signal(%d) si_code(%d) si_pid(%d), si_uid(%d)", info.signal, info.code, (int)info.pid, (int)info.uid));
+        } else {
+            Logger::warning(CLASS_NAME, __FUNCTION__, Logger::format("signal(%d) si_code(%d) sender(%s) si_pid(%d), si_uid(%d)", info.signal, info.code, cmdline.c_str(), (int)info.pid, (int)info.uid));
+        }
 
-Done:
-    if (signal == SIGHUP || signal == SIGINT || signal == SIGPIPE) {
-        Logger::warning(CLASS_NAME, __FUNCTION__, "Ignore received signal");
-        return;
-    } else {
+        if (info.signal == SIGHUP || info.signal == SIGINT || info.signal == SIGPIPE) {
+            Logger::warning(CLASS_NAME, __FUNCTION__, "Ignore received signal");
+            continue;
+        }
         Logger::warning(CLASS_NAME, __FUNCTION__, "Try to terminate SAM process");
+        MainDaemon::getInstance().stop();
     }
-
-    MainDaemon::getInstance().stop();
+    return G_SOURCE_CONTINUE;
 }
 
 int main(int argc, char **argv)
 {
-    Logger::info(CLASS_NAME, __FUNCTION__, "Start SAM process");
+    LOG_INFO(CLASS_NAME, __FUNCTION__, "Start SAM process");
+    if (!g_unix_open_pipe(s_signalPipe, FD_CLOEXEC, NULL) ||
+        !g_unix_set_fd_nonblocking(s_signalPipe[0], TRUE, NULL) ||
+        !g_unix_set_fd_nonblocking(s_signalPipe[1], TRUE, NULL)) {
+        Logger::error(CLASS_NAME, __FUNCTION__, "Failed to create signal pipe");
+        return EXIT_FAILURE;
+    }
+    g_unix_fd_add(s_signalPipe[0], G_IO_IN, onSignal, NULL);
+    Logger::getInstance().startAsync();
 
     // tracking sender if we get some signal
     struct sigaction act;
@@ -86,7 +105,8 @@ int main(int argc, char **argv)
         MainDaemon::getInstance().start();
         MainDaemon::getInstance().finalize();
     } catch(...) {
-        Logger::info(CLASS_NAME, __FUNCTION__, "Failed to start SAM");
+        LOG_INFO(CLASS_NAME, __FUNCTION__, "Failed to start SAM");
     }
+    Logger::getInstance().stopAsync();
     return EXIT_SUCCESS;
 }
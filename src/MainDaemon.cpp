@@ -37,8 +37,23 @@
 #include "bus/client/SettingService.h"
 #include "bus/client/WAM.h"
 #include "bus/service/ApplicationManager.h"
+#include "conf/Persistence.h"
 #include "conf/RuntimeInfo.h"
 #include "conf/SAMConf.h"
+#include "manager/ApiMetrics.h"
+#include "manager/BatchLauncher.h"
+#include "manager/FlightRecorder.h"
+#include "manager/LaunchStatistics.h"
+#include "manager/PreloadManager.h"
+#include "manager/ProcessSupervisor.h"
+#include "manager/MemoryEstimator.h"
+#include "manager/NativeLogManager.h"
+#include "manager/ResidentAppManager.h"
+#include "manager/ResourceSampler.h"
+#include "manager/RunnerPool.h"
+#include "manager/RunningAppSnapshot.h"
+#include "manager/TransitionTimer.h"
+#include "manager/Watchdog.h"
 #include "util/File.h"
 #include "util/JValueUtil.h"
 
@@ -60,9 +75,21 @@ MainDaemon::~MainDaemon()
 
 void MainDaemon::initialize()
 {
+    Persistence::getInstance().initialize();
     RuntimeInfo::getInstance().initialize();
     SAMConf::getInstance().initialize();
+    Watchdog::getInstance().initialize();
+    FlightRecorder::getInstance().initialize();
+    ResourceSampler::getInstance().initialize();
+    MemoryEstimator::getInstance().initialize();
+    LaunchStatistics::getInstance().initialize();
+    NativeLogManager::getInstance().initialize();
+    ProcessSupervisor::getInstance().initialize();
+    TransitionTimer::getInstance().initialize();
+    ResidentAppManager::getInstance().initialize();
+    ApiMetrics::getInstance().initialize();
     AppDescriptionList::getInstance().scanFull();
+    RunningAppSnapshot::getInstance().initialize();
 
     if (!ApplicationManager::getInstance().attach(m_mainLoop))
         return;
@@ -78,12 +105,28 @@ void MainDaemon::initialize()
     SettingService::getInstance().initialize();
     WAM::getInstance().initialize();
 
+    RunnerPool::getInstance().initialize();
+    PreloadManager::getInstance().initialize();
+
     Bootd::getInstance().EventGetBootStatus.connect(boost::bind(&MainDaemon::onGetBootStatus, this, boost::placeholders::_1));
     Configd::getInstance().EventGetConfigs.connect(boost::bind(&MainDaemon::onGetConfigs, this, boost::placeholders::_1));
 }
 
 void MainDaemon::finalize()
 {
+    RunnerPool::getInstance().finalize();
+    PreloadManager::getInstance().finalize();
+    LaunchStatistics::getInstance().finalize();
+    NativeLogManager::getInstance().finalize();
+    ProcessSupervisor::getInstance().finalize();
+    TransitionTimer::getInstance().finalize();
+    ResidentAppManager::getInstance().finalize();
+    RunningAppSnapshot::getInstance().finalize();
+    ApiMetrics::getInstance().finalize();
+    Watchdog::getInstance().finalize();
+    ResourceSampler::getInstance().finalize();
+    FlightRecorder::getInstance().finalize();
+
     AppInstallService::getInstance().finalize();
     Bootd::getInstance().finalize();
     Configd::getInstance().finalize();
@@ -95,11 +138,14 @@ void MainDaemon::finalize()
     WAM::getInstance().finalize();
 
     ApplicationManager::getInstance().detach();
+
+    // Pending files of all modules are written before exit
+    Persistence::getInstance().finalize();
 }
 
 void MainDaemon::start()
 {
-    Logger::info(getClassName(), __FUNCTION__, "Start event handler thread");
+    LOG_INFO(getClassName(), __FUNCTION__, "Start event handler thread");
     g_main_loop_run(m_mainLoop);
 }
 
@@ -142,16 +188,21 @@ void MainDaemon::checkPreconditions()
         return;
 
     if (!m_isConfigsReceived) {
-        Logger::info(getClassName(), __FUNCTION__, "Wait for receiving 'getConfigs' response");
+        LOG_INFO(getClassName(), __FUNCTION__, "Wait for receiving 'getConfigs' response");
         return;
     }
     if (!m_isCBDGenerated) {
-        Logger::info(getClassName(), __FUNCTION__, "Wait for receiving 'getBootStatus' response");
+        LOG_INFO(getClassName(), __FUNCTION__, "Wait for receiving 'getBootStatus' response");
         return;
     }
-    Logger::info(getClassName(), __FUNCTION__, "All initial components are ready");
+    LOG_INFO(getClassName(), __FUNCTION__, "All initial components are ready");
     isFired = true;
 
     ApplicationManager::getInstance().enablePosting();
+
+    // Boot list should be launched only once after booting
+    if (!SAMConf::getInstance().isRespawned()) {
+        BatchLauncher::getInstance().launchBootList();
+    }
 }
 
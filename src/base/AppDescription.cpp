@@ -210,8 +210,8 @@ bool AppDescription::scan()
 
 bool AppDescription::scan(const string& folderPath, const AppLocation& appLocation)
 {
-    Logger::debug(CLASS_NAME, __FUNCTION__, m_appId,
-                  Logger::format("folderPath(%s) appLocation(%s)", folderPath.c_str(), toString(appLocation)));
+    LOG_DEBUG(CLASS_NAME, __FUNCTION__, m_appId,
+              Logger::format("folderPath(%s) appLocation(%s)", folderPath.c_str(), toString(appLocation)));
     m_folderPath = folderPath;
     m_appLocation = appLocation;
     return scan();
@@ -301,7 +301,7 @@ bool AppDescription::loadAppinfo()
 
         JValue localeAppinfo = JDomParser::fromFile(AbsoluteLocaleAppinfoPath.c_str());
         if (localeAppinfo.isNull()) {
-            Logger::info(CLASS_NAME, __FUNCTION__, "IGNORRED", Logger::format("failed_to_load_localication: %s", localizationDir.c_str()));
+            LOG_INFO(CLASS_NAME, __FUNCTION__, "IGNORRED", Logger::format("failed_to_load_localication: %s", localizationDir.c_str()));
             continue;
         }
 
@@ -419,7 +419,7 @@ bool AppDescription::readAsset()
 
             // set asset without variant
             pathToCheck = m_folderPath + string("/") + assetPath;
-            Logger::debug(CLASS_NAME, __FUNCTION__, Logger::format("patch_to_check: %s\n", pathToCheck.c_str()));
+            LOG_DEBUG(CLASS_NAME, __FUNCTION__, Logger::format("patch_to_check: %s\n", pathToCheck.c_str()));
 
             if (0 == access(pathToCheck.c_str(), F_OK)) {
                 m_appinfo.put(key, assetPath);
@@ -438,3 +438,10 @@ bool AppDescription::readAsset()
     return true;
 }
 
+
+size_t AppDescription::getMemoryUsage() const
+{
+    return sizeof(AppDescription) +
+           m_folderPath.capacity() + m_appId.capacity() + m_absMain.capacity() + m_absSplashBackground.capacity() +
+           JValueUtil::getMemoryUsage(m_appinfo);
+}
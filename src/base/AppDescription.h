@@ -106,6 +106,9 @@ public:
         json = m_appinfo.duplicate();
     }
 
+    // Approximate heap bytes including appinfo DOM
+    size_t getMemoryUsage() const;
+
     const string& getFolderPath() const
     {
         return m_folderPath;
@@ -194,6 +197,14 @@ public:
         return requiredMemory;
     }
 
+    // MB. Native apps are throttled over this value if they run in cgroup
+    int getMemoryLimit() const
+    {
+        int memoryLimit = 0;
+        JValueUtil::getValue(m_appinfo, "memoryLimit", memoryLimit);
+        return memoryLimit;
+    }
+
     const string& getSplashBackground() const
     {
         return m_absSplashBackground;
@@ -17,9 +17,12 @@
 #include "base/AppDescriptionList.h"
 
 #include "base/LaunchPointList.h"
+#include "bus/client/NativeContainer.h"
 #include "bus/service/ApplicationManager.h"
 #include "conf/SAMConf.h"
+#include "manager/NativeLogManager.h"
 #include "util/File.h"
+#include "util/Tracer.h"
 
 bool AppDescriptionList::compare(AppDescriptionPtr me, AppDescriptionPtr another)
 {
@@ -71,6 +74,7 @@ void AppDescriptionList::changeLocale()
 
 void AppDescriptionList::scanApp(const string& appId)
 {
+    TRACE_SCOPE("scan", __FUNCTION__, appId.c_str(), 0);
     AppDescriptionPtr newAppDesc = AppDescriptionList::getInstance().create(appId);
     if (newAppDesc == nullptr) {
         Logger::warning(getInstance().getClassName(), __FUNCTION__, appId, "Failed to create new AppDescription");
@@ -117,6 +121,7 @@ void AppDescriptionList::scanApp(const string& appId)
 
 void AppDescriptionList::scanFull()
 {
+    TRACE_SCOPE("scan", __FUNCTION__, nullptr, 0);
     JValue applicationPaths = SAMConf::getInstance().getApplicationPaths();
     for (int i = 0; i < applicationPaths.arraySize(); i++) {
         string path = "";
@@ -136,8 +141,8 @@ void AppDescriptionList::scanFull()
             continue;
         }
         if (appLocation == AppLocation::AppLocation_Devmode && !SAMConf::getInstance().isDevmodeEnabled()) {
-            Logger::info(getClassName(), __FUNCTION__,
-                         Logger::format("Devmode directory is skipped: path(%s) typeByDir(%s)", path.c_str(), typeByDir.c_str()));
+            LOG_INFO(getClassName(), __FUNCTION__,
+                     Logger::format("Devmode directory is skipped: path(%s) typeByDir(%s)", path.c_str(), typeByDir.c_str()));
             continue;
         }
 
@@ -153,6 +158,7 @@ void AppDescriptionList::scanFull()
 
 void AppDescriptionList::scanDir(const string& path, const AppLocation& appLocation)
 {
+    TRACE_SCOPE("scan", __FUNCTION__, path.c_str(), 0);
     dirent** entries = NULL;
     int entryCount = ::scandir(path.c_str(), &entries, 0, alphasort);
     if (entries == NULL || entryCount == 0) {
@@ -167,14 +173,14 @@ void AppDescriptionList::scanDir(const string& path, const AppLocation& appLocat
         }
         string folderPath = File::join(path, entries[i]->d_name);
         if (SAMConf::getInstance().isBlockedApp(entries[i]->d_name)) {
-            Logger::info(getClassName(), __FUNCTION__, "BLOCKED",
-                         Logger::format("forderPath(%s)", folderPath.c_str()));
+            LOG_INFO(getClassName(), __FUNCTION__, "BLOCKED",
+                     Logger::format("forderPath(%s)", folderPath.c_str()));
             continue;
         }
         if (appLocation == AppLocation::AppLocation_System_ReadOnly &&
             SAMConf::getInstance().isDeletedSystemApp(entries[i]->d_name)) {
-            Logger::info(getClassName(), __FUNCTION__, "DELETED",
-                         Logger::format("forderPath(%s)", folderPath.c_str()));
+            LOG_INFO(getClassName(), __FUNCTION__, "DELETED",
+                     Logger::format("forderPath(%s)", folderPath.c_str()));
             continue;
         }
         if (!File::isDirectory(folderPath)) {
@@ -237,7 +243,7 @@ bool AppDescriptionList::add(AppDescriptionPtr newAppDesc)
     }
 
     if (m_map.find(newAppDesc->getAppId()) == m_map.end()) {
-        Logger::info(getClassName(), __FUNCTION__, newAppDesc->getAppId() + " is added");
+        LOG_INFO(getClassName(), __FUNCTION__, newAppDesc->getAppId() + " is added");
         m_map[newAppDesc->getAppId()] = newAppDesc;
         ApplicationManager::getInstance().postListApps(newAppDesc, "added", "");
         LaunchPointPtr launchPoint = LaunchPointList::getInstance().createDefault(newAppDesc);
@@ -245,6 +251,8 @@ bool AppDescriptionList::add(AppDescriptionPtr newAppDesc)
         return true;
     }
 
+    // The existing AppDescription can be rescanned below, even if it is not replaced
+    NativeContainer::getInstance().removeLaunchPlan(newAppDesc->getAppId());
     if (m_map[newAppDesc->getAppId()]->getFolderPath() == newAppDesc->getFolderPath()) {
         // same directory means *update*
         AppDescriptionPtr oldAppDesc = m_map[newAppDesc->getAppId()];
@@ -311,10 +319,12 @@ void AppDescriptionList::toJson(JValue& json, JValue& properties, bool devmode)
 void AppDescriptionList::onRemove(AppDescriptionPtr appDesc)
 {
     if (appDesc->isSystemApp()) {
-        Logger::info(getClassName(), __FUNCTION__, appDesc->getAppId(), "remove system-app in read-write area");
+        LOG_INFO(getClassName(), __FUNCTION__, appDesc->getAppId(), "remove system-app in read-write area");
         SAMConf::getInstance().appendDeletedSystemApp(appDesc->getAppId());
     }
     LaunchPointList::getInstance().removeByAppDesc(appDesc);
-    Logger::info(getClassName(), __FUNCTION__, appDesc->getAppId());
+    NativeContainer::getInstance().removeLaunchPlan(appDesc->getAppId());
+    NativeLogManager::getInstance().remove(appDesc->getAppId());
+    LOG_INFO(getClassName(), __FUNCTION__, appDesc->getAppId());
     ApplicationManager::getInstance().postListApps(appDesc, "removed", "");
 }
@@ -51,6 +51,11 @@ public:
     bool isExist(const string& appId);
     void toJson(JValue& json, JValue& properties, bool devmode = false);
 
+    const map<string, AppDescriptionPtr>& getAll() const
+    {
+        return m_map;
+    }
+
 private:
     AppDescriptionList();
 
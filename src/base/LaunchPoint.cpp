@@ -134,3 +134,8 @@ void LaunchPoint::toJson(JValue& json) const
     json.put("imageForRecents", getImageForRecents());
     json.put("largeIcon", getLargeIcon());
 }
+
+size_t LaunchPoint::getMemoryUsage() const
+{
+    return sizeof(LaunchPoint) + m_launchPointId.capacity() + JValueUtil::getMemoryUsage(m_database);
+}
@@ -195,6 +195,9 @@ public:
 
     void toJson(JValue& json) const;
 
+    // Approximate heap bytes including database DOM. AppDescription is not included
+    size_t getMemoryUsage() const;
+
 private:
     LaunchPoint(const LaunchPoint&);
     LaunchPoint& operator=(const LaunchPoint&) const;
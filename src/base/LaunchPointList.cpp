@@ -249,7 +249,7 @@ string LaunchPointList::generateLaunchPointId(LaunchPointType type, const string
 
 void LaunchPointList::onAdd(LaunchPointPtr launchPoint)
 {
-    Logger::info(getClassName(), __FUNCTION__, launchPoint->getLaunchPointId() + " is added");
+    LOG_INFO(getClassName(), __FUNCTION__, launchPoint->getLaunchPointId() + " is added");
     launchPoint->syncDatabase();
     m_list.push_back(launchPoint);
     ApplicationManager::getInstance().postListLaunchPoints(launchPoint, "added");
@@ -257,13 +257,13 @@ void LaunchPointList::onAdd(LaunchPointPtr launchPoint)
 
 void LaunchPointList::onUpdate(LaunchPointPtr launchPoint)
 {
-    Logger::info(getClassName(), __FUNCTION__, launchPoint->getLaunchPointId() + " is updated");
+    LOG_INFO(getClassName(), __FUNCTION__, launchPoint->getLaunchPointId() + " is updated");
     ApplicationManager::getInstance().postListLaunchPoints(launchPoint, "updated");
 }
 
 void LaunchPointList::onRemove(LaunchPointPtr launchPoint)
 {
-    Logger::info(getClassName(), __FUNCTION__, launchPoint->getLaunchPointId() + " is removed");
+    LOG_INFO(getClassName(), __FUNCTION__, launchPoint->getLaunchPointId() + " is removed");
     RunningAppList::getInstance().removeAllByLaunchPoint(launchPoint);
     DB8::getInstance().deleteLaunchPoint(launchPoint->getLaunchPointId());
     ApplicationManager::getInstance().postListLaunchPoints(launchPoint, "removed");
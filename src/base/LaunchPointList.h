@@ -54,6 +54,11 @@ public:
     bool isExist(const string& launchPointId);
     void toJson(JValue& json);
 
+    const list<LaunchPointPtr>& getAll() const
+    {
+        return m_list;
+    }
+
 private:
     string generateLaunchPointId(LaunchPointType type, const string& appId);
 
@@ -0,0 +1,108 @@
+// Copyright (c) 2020 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#include "LaunchTrace.h"
+
+const char* LaunchTrace::toString(LaunchStage stage)
+{
+    switch (stage) {
+    case LaunchStage::LaunchStage_RECEIVED:
+        return "received";
+
+    case LaunchStage::LaunchStage_SCHEMA_CHECKED:
+        return "schemaChecked";
+
+    case LaunchStage::LaunchStage_PREPARED:
+        return "prepared";
+
+    case LaunchStage::LaunchStage_MEMORY_GRANTED:
+        return "memoryGranted";
+
+    case LaunchStage::LaunchStage_REQUESTED:
+        return "requested";
+
+    case LaunchStage::LaunchStage_ACKED:
+        return "acked";
+
+    case LaunchStage::LaunchStage_FOREGROUND:
+        return "foreground";
+
+    case LaunchStage::LaunchStage_REGISTERED:
+        return "registered";
+
+    default:
+        return "unknown";
+    }
+}
+
+LaunchTrace::LaunchTrace()
+    : m_receivedTime(-1)
+{
+    for (int i = 0; i < (int)LaunchStage::LaunchStage_MAX; ++i) {
+        m_elapsed[i] = -1;
+    }
+}
+
+LaunchTrace::~LaunchTrace()
+{
+}
+
+void LaunchTrace::start(long long receivedTime)
+{
+    m_receivedTime = receivedTime;
+    m_elapsed[(int)LaunchStage::LaunchStage_RECEIVED] = 0;
+}
+
+bool LaunchTrace::mark(LaunchStage stage, long long time)
+{
+    if (!isStarted() || stage >= LaunchStage::LaunchStage_MAX)
+        return false;
+    if (m_elapsed[(int)stage] >= 0)
+        return false;
+
+    m_elapsed[(int)stage] = time - m_receivedTime;
+    return true;
+}
+
+long long LaunchTrace::getElapsed(LaunchStage stage) const
+{
+    if (stage >= LaunchStage::LaunchStage_MAX)
+        return -1;
+    return m_elapsed[(int)stage];
+}
+
+string LaunchTrace::toString() const
+{
+    string trace = "";
+    for (int i = 0; i < (int)LaunchStage::LaunchStage_MAX; ++i) {
+        if (m_elapsed[i] < 0)
+            continue;
+        if (!trace.empty())
+            trace += " ";
+        trace += string(toString((LaunchStage)i)) + "(" + std::to_string(m_elapsed[i]) + ")";
+    }
+    return trace;
+}
+
+void LaunchTrace::toJson(JValue& json) const
+{
+    for (int i = 0; i < (int)LaunchStage::LaunchStage_MAX; ++i) {
+        if (m_elapsed[i] < 0)
+            continue;
+        json.put(toString((LaunchStage)i), (int64_t)m_elapsed[i]);
+    }
+}
@@ -0,0 +1,69 @@
+// Copyright (c) 2020 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#ifndef BASE_LAUNCHTRACE_H_
+#define BASE_LAUNCHTRACE_H_
+
+#include <iostream>
+#include <stdint.h>
+#include <pbnjson.hpp>
+
+using namespace std;
+using namespace pbnjson;
+
+enum class LaunchStage : int8_t {
+    LaunchStage_RECEIVED = 0,   // API is received
+    LaunchStage_SCHEMA_CHECKED,
+    LaunchStage_PREPARED,       // launch preparation is done
+    LaunchStage_MEMORY_GRANTED, // MemoryManager replied
+    LaunchStage_REQUESTED,      // native process is spawned or WAM is called
+    LaunchStage_ACKED,          // WAM replied (web app only)
+    LaunchStage_FOREGROUND,     // first foreground event from LSM
+    LaunchStage_REGISTERED,     // registerApp is called
+    LaunchStage_MAX
+};
+
+// LaunchTrace records when each stage of the first launch is reached.
+// All times are elapsed milliseconds from API receipt.
+class LaunchTrace {
+public:
+    static const char* toString(LaunchStage stage);
+
+    LaunchTrace();
+    virtual ~LaunchTrace();
+
+    // Only started traces record stages. Apps which are found after SAM restart are not traced
+    void start(long long receivedTime);
+    bool isStarted() const
+    {
+        return m_receivedTime >= 0;
+    }
+
+    // Returns false if the stage was already recorded
+    bool mark(LaunchStage stage, long long time);
+    long long getElapsed(LaunchStage stage) const;
+
+    string toString() const;
+    void toJson(JValue& json) const;
+
+private:
+    long long m_receivedTime;
+    long long m_elapsed[(int)LaunchStage::LaunchStage_MAX];
+
+};
+
+#endif /* BASE_LAUNCHTRACE_H_ */
@@ -16,6 +16,8 @@
 
 #include "LunaTask.h"
 
+#include <string.h>
+
 #include "AppDescriptionList.h"
 #include "RunningAppList.h"
 #include "util/JValueUtil.h"
@@ -42,3 +44,17 @@ void LunaTask::setDisplayId(const int displayId)
     }
     m_requestPayload["params"].put("displayAffinity", displayId);
 }
+
+size_t LunaTask::getMemoryUsage() const
+{
+    size_t usage = sizeof(LunaTask) +
+                   m_instanceId.capacity() + m_launchPointId.capacity() + m_appId.capacity() +
+                   m_errorText.capacity() + m_reason.capacity() + m_nextStep.capacity() +
+                   m_kind.capacity() + m_caller.capacity() +
+                   JValueUtil::getMemoryUsage(m_requestPayload) + JValueUtil::getMemoryUsage(m_responsePayload);
+
+    // The raw payload is kept by the message until the task is removed
+    if (m_request.get() != nullptr && LSMessageGetPayload(m_request.get()) != nullptr)
+        usage += strlen(LSMessageGetPayload(m_request.get())) + 1;
+    return usage;
+}
@@ -29,6 +29,7 @@
 #include "util/Logger.h"
 #include "util/JValueUtil.h"
 #include "util/Time.h"
+#include "util/Tracer.h"
 
 using namespace std;
 using namespace pbnjson;
@@ -52,7 +53,40 @@ public:
           m_responsePayload(pbnjson::Object()),
           m_errorCode(ErrCode_NOERROR),
           m_errorText(""),
-          m_reason("")
+          m_reason(""),
+          m_isOnBehalf(false),
+          m_isMemoryReserved(false),
+          m_receivedTime(Time::getCurrentTime()),
+          m_schemaCheckedTime(0),
+          m_metric(-1),
+          m_responseSize(0),
+          m_traceId(Tracer::newId())
+    {
+        JValueUtil::getValue(m_requestPayload, "instanceId", m_instanceId);
+        JValueUtil::getValue(m_requestPayload, "launchPointId", m_launchPointId);
+        JValueUtil::getValue(m_requestPayload, "id", m_appId);
+    }
+
+    // Internal request which is made by SAM itself. There is no message to reply.
+    LunaTask(const string& kind, const JValue& requestPayload)
+        : m_instanceId(""),
+          m_launchPointId(""),
+          m_appId(""),
+          m_token(0),
+          m_requestPayload(requestPayload.duplicate()),
+          m_responsePayload(pbnjson::Object()),
+          m_errorCode(ErrCode_NOERROR),
+          m_errorText(""),
+          m_reason(""),
+          m_kind(kind),
+          m_caller(""),
+          m_isOnBehalf(false),
+          m_isMemoryReserved(false),
+          m_receivedTime(Time::getCurrentTime()),
+          m_schemaCheckedTime(m_receivedTime),
+          m_metric(-1),
+          m_responseSize(0),
+          m_traceId(Tracer::getCurrentId() != 0 ? Tracer::getCurrentId() : Tracer::newId())
     {
         JValueUtil::getValue(m_requestPayload, "instanceId", m_instanceId);
         JValueUtil::getValue(m_requestPayload, "launchPointId", m_launchPointId);
@@ -110,6 +144,24 @@ public:
         return m_request.get();
     }
 
+    bool isInternal() const
+    {
+        return !m_request;
+    }
+
+    // Request from outside of SAM. Internal requests on behalf of an external caller are included
+    bool isExternal() const
+    {
+        return !isInternal() || m_isOnBehalf;
+    }
+
+    const char* getKind() const
+    {
+        if (isInternal())
+            return m_kind.c_str();
+        return m_request.getKind();
+    }
+
     LSMessageToken getToken() const
     {
         return m_token;
@@ -149,12 +201,23 @@ public:
         Logger::warning("LunaTask", __FUNCTION__, Logger::format("errorCode(%d) errorText(%s)", errorCode, errorText.c_str()));
     }
 
+    int getErrCode() const
+    {
+        return m_errorCode;
+    }
+    const string& getErrText() const
+    {
+        return m_errorText;
+    }
+
     int getDisplayId();
     void setDisplayId(const int displayId);
 
     const string getCaller() const
     {
-        if (m_request.getApplicationID() != nullptr) {
+        if (isInternal()) {
+            return m_caller.empty() ? "com.webos.applicationManager" : m_caller;
+        } else if (m_request.getApplicationID() != nullptr) {
             return m_request.getApplicationID();
         } else if (m_request.getSenderServiceName() != nullptr){
             return m_request.getSenderServiceName();
@@ -207,7 +270,7 @@ public:
     }
     bool hasErrorCallback()
     {
-        return !m_successCallback.empty();
+        return !m_errorCallback.empty();
     }
     void error(LunaTaskPtr lunaTask)
     {
@@ -216,6 +279,68 @@ public:
         }
     }
 
+    long long getReceivedTime() const
+    {
+        return m_receivedTime;
+    }
+    void setReceivedTime(long long receivedTime)
+    {
+        m_receivedTime = receivedTime;
+    }
+
+    long long getSchemaCheckedTime() const
+    {
+        return m_schemaCheckedTime;
+    }
+    void setSchemaCheckedTime(long long schemaCheckedTime)
+    {
+        m_schemaCheckedTime = schemaCheckedTime;
+    }
+
+    // Slot in ApiMetrics. Internal requests don't have it
+    int getMetric() const
+    {
+        return m_metric;
+    }
+    void setMetric(int metric)
+    {
+        m_metric = metric;
+    }
+
+    size_t getResponseSize() const
+    {
+        return m_responseSize;
+    }
+
+    // Internal requests follow the trace which makes them
+    unsigned long getTraceId() const
+    {
+        return m_traceId;
+    }
+
+    // Memory is already secured by the caller (e.g. batch launch). MemoryManager is not called again
+    bool isMemoryReserved() const
+    {
+        return m_isMemoryReserved;
+    }
+    void setMemoryReserved(bool isMemoryReserved)
+    {
+        m_isMemoryReserved = isMemoryReserved;
+    }
+
+    // Internal requests which are made on behalf of another request (e.g. batch items)
+    void setOrigin(const LunaTask& origin)
+    {
+        m_caller = origin.getCaller();
+        m_isOnBehalf = origin.isExternal();
+    }
+
+    // Called after the response is made. Internal requests use this instead of replying to the bus
+    void setReplyCallback(LunaTaskCallback callback)
+    {
+        m_replyCallback = callback;
+    }
+
     const string& getNextStep() const
     {
         return m_nextStep;
@@ -227,6 +352,8 @@ public:
 
     bool isDevmodeRequest()
     {
+        if (isInternal())
+            return false;
         return (strcmp(m_request.getCategory(), "/dev") == 0);
     }
 
@@ -236,7 +363,7 @@ public:
             json = pbnjson::Object();
 
         json.put("caller", getCaller());
-        json.put("kind", this->getRequest().getKind());
+        json.put("kind", getKind());
     }
 
     void fillIds(JValue& json)
@@ -248,6 +375,9 @@ public:
             json.put("displayId", getDisplayId());
     }
 
+    // Approximate heap bytes including payloads
+    size_t getMemoryUsage() const;
+
 private:
     LunaTask& operator=(const LunaTask& lunaTask) = delete;
     LunaTask(const LunaTask& lunaTask) = delete;
@@ -264,7 +394,13 @@ private:
             returnValue = false;
         }
         m_responsePayload.put("returnValue", returnValue);
-        m_request.respond(m_responsePayload.stringify().c_str());
+        if (isInternal()) {
+            LOG_INFO("LunaTask", __FUNCTION__, m_kind, m_responsePayload.stringify());
+            return;
+        }
+        string response = m_responsePayload.stringify();
+        m_responseSize = response.length();
+        m_request.respond(response.c_str());
     }
 
     string m_instanceId;
@@ -284,8 +420,19 @@ private:
 
     LunaTaskCallback m_successCallback;
     LunaTaskCallback m_errorCallback;
+    LunaTaskCallback m_replyCallback;
 
     string m_nextStep;
+
+    string m_kind;
+    string m_caller;
+    bool m_isOnBehalf;
+    bool m_isMemoryReserved;
+    long long m_receivedTime;
+    long long m_schemaCheckedTime;
+    int m_metric;
+    size_t m_responseSize;
+    unsigned long m_traceId;
 };
 
 #endif  // BASE_LUNATASK_H_
@@ -18,6 +18,8 @@
 
 #include <string.h>
 
+#include "manager/ApiMetrics.h"
+
 LunaTaskList::LunaTaskList()
 {
 }
@@ -30,7 +32,7 @@ LunaTaskList::~LunaTaskList()
 LunaTaskPtr LunaTaskList::getByKindAndId(const char* kind, const string& appId)
 {
     for (auto it = m_list.begin(); it != m_list.end(); ++it) {
-        if (strcmp((*it)->getRequest().getKind(), kind) == 0 && (*it)->getAppId() == appId)
+        if (strcmp((*it)->getKind(), kind) == 0 && (*it)->getAppId() == appId)
             return *it;
     }
     return nullptr;
@@ -71,6 +73,13 @@ void LunaTaskList::removeAfterReply(LunaTaskPtr lunaTask, bool fillIds)
             }
             (*it)->reply();
             m_list.erase(it);
+            int errorCode = lunaTask->getErrCode();
+            if (errorCode == 0 && !lunaTask->getErrText().empty())
+                errorCode = ErrCode_UNKNOWN;
+            ApiMetrics::getInstance().onResponse(lunaTask->getMetric(), lunaTask->getReceivedTime(), lunaTask->getResponseSize(), errorCode);
+            if (!lunaTask->m_replyCallback.empty()) {
+                lunaTask->m_replyCallback(lunaTask);
+            }
             return;
         }
     }
@@ -41,6 +41,11 @@ public:
 
     void toJson(JValue& array);
 
+    const list<LunaTaskPtr>& getAll() const
+    {
+        return m_list;
+    }
+
 private:
     LunaTaskList();
 
@@ -16,9 +16,14 @@
 
 #include "RunningApp.h"
 
-#include "bus/client/AbsLifeHandler.h"
 #include "bus/service/ApplicationManager.h"
 #include "conf/SAMConf.h"
+#include "manager/FlightRecorder.h"
+#include "manager/LaunchStatistics.h"
+#include "manager/RunningAppSnapshot.h"
+#include "manager/TransitionTimer.h"
+#include "util/JValueUtil.h"
+#include "util/Tracer.h"
 
 const string RunningApp::CLASS_NAME = "RunningApp";
 
@@ -129,12 +134,15 @@ RunningApp::RunningApp(LaunchPointPtr launchPoint)
       m_isFullWindow(true),
       m_lifeStatus(LifeStatus::LifeStatus_STOP),
       m_isFirstLaunch(true),
-      m_killingTimer(0),
+      m_isBulkClosing(false),
+      m_peakMemory(0),
+      m_isPrepared(false),
       m_keepAlive(false),
       m_noSplash(true),
       m_spinner(true),
       m_launchedHidden(false),
       m_token(0),
+      m_traceId(0),
       m_context(0),
       m_ls2name(""),
       m_isRegistered(false)
@@ -144,7 +152,6 @@ RunningApp::RunningApp(LaunchPointPtr launchPoint)
 
 RunningApp::~RunningApp()
 {
-    stopKillingTimer();
 }
 
 void RunningApp::registerApp(LunaTaskPtr lunaTask)
@@ -168,7 +175,22 @@ void RunningApp::registerApp(LunaTaskPtr lunaTask)
         m_isRegistered = false;
         return;
     }
-    Logger::info(CLASS_NAME, __FUNCTION__, m_instanceId, "Application is registered");
+    LOG_INFO(CLASS_NAME, __FUNCTION__, m_instanceId, "Application is registered");
+    markStage(LaunchStage::LaunchStage_REGISTERED);
+}
+
+bool RunningApp::markStage(LaunchStage stage, long long time)
+{
+    if (!m_launchTrace.isStarted())
+        return false;
+    if (time < 0)
+        time = Time::getCurrentTime();
+    if (!m_launchTrace.mark(stage, time))
+        return false;
+
+    LaunchStatistics::getInstance().add(getAppId(), stage, m_launchTrace.getElapsed(stage));
+    TRACE_INSTANT("launch", LaunchTrace::toString(stage), m_instanceId.c_str(), m_traceId);
+    return true;
 }
 
 bool RunningApp::sendEvent(JValue& responsePayload)
@@ -208,15 +230,16 @@ void RunningApp::setLifeStatus(LifeStatus lifeStatus)
     case LifeStatus::LifeStatus_STOP:
         // LifeStatus_STOP should not be set directly. Only RunningAppList can set this status.
         if (m_lifeStatus == LifeStatus::LifeStatus_CLOSING)
-            Logger::info(CLASS_NAME, __FUNCTION__, m_instanceId, "Closed by SAM");
+            LOG_INFO(CLASS_NAME, __FUNCTION__, m_instanceId, "Closed by SAM");
         else
-            Logger::info(CLASS_NAME, __FUNCTION__, m_instanceId, "Closed by Itself");
+            LOG_INFO(CLASS_NAME, __FUNCTION__, m_instanceId, "Closed by Itself");
         break;
 
     case LifeStatus::LifeStatus_LAUNCHING:
         if (m_lifeStatus == LifeStatus::LifeStatus_FOREGROUND) {
-            Logger::info(CLASS_NAME, __FUNCTION__, m_instanceId,
-                         Logger::format("Changed: %s (%s ==> %s)", getAppId().c_str(), toString(m_lifeStatus), toString(LifeStatus::LifeStatus_RELAUNCHING)));
+            LOG_INFO(CLASS_NAME, __FUNCTION__, m_instanceId,
+                     Logger::format("Changed: %s (%s ==> %s)", getAppId().c_str(), toString(m_lifeStatus), toString(LifeStatus::LifeStatus_RELAUNCHING)));
+            FlightRecorder::getInstance().recordLifeStatus(getAppId(), toString(m_lifeStatus), toString(LifeStatus::LifeStatus_RELAUNCHING), getProcessId());
             m_lifeStatus = LifeStatus::LifeStatus_RELAUNCHING;
             ApplicationManager::getInstance().postGetAppLifeStatus(*this);
             lifeStatus = LifeStatus::LifeStatus_FOREGROUND;
@@ -231,9 +254,11 @@ void RunningApp::setLifeStatus(LifeStatus lifeStatus)
         break;
     }
 
-    Logger::info(CLASS_NAME, __FUNCTION__, m_instanceId,
-                 Logger::format("Changed: %s (%s ==> %s)", getAppId().c_str(), toString(m_lifeStatus), toString(lifeStatus)));
+    LOG_INFO(CLASS_NAME, __FUNCTION__, m_instanceId,
+             Logger::format("Changed: %s (%s ==> %s)", getAppId().c_str(), toString(m_lifeStatus), toString(lifeStatus)));
+    FlightRecorder::getInstance().recordLifeStatus(getAppId(), toString(m_lifeStatus), toString(lifeStatus), getProcessId());
     m_lifeStatus = lifeStatus;
+    TRACE_INSTANT("launch", toString(m_lifeStatus), m_instanceId.c_str(), m_traceId);
 
     // Normally, transition should be completed within timeout sec
     // However, sometimes, it takes more than 10 seconds to launch the target app.
@@ -241,50 +266,32 @@ void RunningApp::setLifeStatus(LifeStatus lifeStatus)
     // See more info here PLAT-101882.
     if (isTransition(m_lifeStatus)) {
         if (m_lifeStatus == LifeStatus::LifeStatus_LAUNCHING || m_lifeStatus == LifeStatus::LifeStatus_RELAUNCHING) {
-            // Donot start killing timer in case of (re)launching
-        } else if (m_lifeStatus == LifeStatus::LifeStatus_CLOSING) {
-            // App should be closed within 1 second
-            // TODO: Change this to constant variable
-            startKillingTimer(1);
+            // Donot start transition timer in case of (re)launching
+            TransitionTimer::getInstance().stop(m_instanceId);
+        } else if (m_lifeStatus == LifeStatus::LifeStatus_CLOSING && m_isBulkClosing) {
+            // BulkTerminator kills all remaining apps with a single timer
+            TransitionTimer::getInstance().stop(m_instanceId);
         } else {
-            startKillingTimer(TIMEOUT_TRANSITION);
+            TransitionTimer::getInstance().start(*this);
         }
     } else {
-        stopKillingTimer();
+        TransitionTimer::getInstance().stop(m_instanceId);
     }
 
     ApplicationManager::getInstance().postGetAppLifeStatus(*this);
     ApplicationManager::getInstance().postGetAppLifeEvents(*this);
+    RunningAppSnapshot::getInstance().update();
 }
 
-gboolean RunningApp::onKillingTimer(gpointer context)
-{
-    RunningApp* self = static_cast<RunningApp*>(context);
-    if (self == nullptr) {
-        return G_SOURCE_REMOVE;
-    }
-    RunningAppPtr runningApp = RunningAppList::getInstance().getByInstanceId(self->getInstanceId());
-    if (runningApp == nullptr) {
-        return G_SOURCE_REMOVE;
-    }
-    Logger::warning(CLASS_NAME, __FUNCTION__, self->m_instanceId, "Transition is timeout");
-
-    AbsLifeHandler::getLifeHandler(runningApp).kill(runningApp);
-
-    // It tries to kill the app continually
-    return G_SOURCE_CONTINUE;
-}
-
-void RunningApp::startKillingTimer(guint timeout)
+size_t RunningApp::getMemoryUsage() const
 {
-    stopKillingTimer();
-    m_killingTimer = g_timeout_add(timeout, onKillingTimer, this);
-}
-
-void RunningApp::stopKillingTimer()
-{
-    if (m_killingTimer > 0) {
-        g_source_remove(m_killingTimer);
-        m_killingTimer = 0;
-    }
+    size_t usage = sizeof(RunningApp) +
+                   m_instanceId.capacity() + m_webprocessid.capacity() + m_windowId.capacity() +
+                   m_preload.capacity() + m_reason.capacity() +
+                   JValueUtil::getMemoryUsage(m_preparedPayload);
+
+    const vector<string>& arguments = m_nativePocess.getArguments();
+    for (auto it = arguments.begin(); it != arguments.end(); ++it)
+        usage += sizeof(string) + it->capacity();
+    return usage;
 }
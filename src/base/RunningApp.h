@@ -23,6 +23,7 @@
 #include <pbnjson.hpp>
 
 #include "base/LaunchPoint.h"
+#include "base/LaunchTrace.h"
 #include "base/LunaTask.h"
 #include "base/LunaTaskList.h"
 #include "conf/SAMConf.h"
@@ -231,12 +232,59 @@ public:
         return m_isFirstLaunch;
     }
 
+    // The app is closed by BulkTerminator. It kills the app instead of TransitionTimer
+    bool isBulkClosing() const
+    {
+        return m_isBulkClosing;
+    }
+    void setBulkClosing(bool isBulkClosing)
+    {
+        m_isBulkClosing = isBulkClosing;
+    }
+
     long long getTimeStamp() const
     {
         long long now = Time::getCurrentTime();
         return (now - m_startTime);
     }
 
+    LaunchTrace& getLaunchTrace()
+    {
+        return m_launchTrace;
+    }
+    // Returns true if the stage is recorded for the first time
+    bool markStage(LaunchStage stage, long long time = -1);
+    string getStages() const
+    {
+        return m_launchTrace.toString();
+    }
+
+    // Peak memory usage (KB) of the process tree. PSS is used if the kernel supports it
+    long getPeakMemory() const
+    {
+        return m_peakMemory;
+    }
+    void setPeakMemory(long peakMemory)
+    {
+        if (peakMemory > m_peakMemory)
+            m_peakMemory = peakMemory;
+    }
+
+    // Life handler can prepare launching while SAM waits for memory.
+    // Prepared data is consumed by the next launch and discarded with RunningApp
+    bool isPrepared() const
+    {
+        return m_isPrepared;
+    }
+    void setPrepared(bool isPrepared)
+    {
+        m_isPrepared = isPrepared;
+    }
+    JValue& getPreparedPayload()
+    {
+        return m_preparedPayload;
+    }
+
     const string& getReason() const
     {
         return m_reason;
@@ -255,6 +303,16 @@ public:
         m_token = token;
     }
 
+    // Trace of the latest launch request
+    unsigned long getTraceId() const
+    {
+        return m_traceId;
+    }
+    void setTraceId(unsigned long traceId)
+    {
+        m_traceId = traceId;
+    }
+
     int getContext() const
     {
         return m_context;
@@ -303,19 +361,17 @@ public:
         }
     }
 
+    // Approximate heap bytes. LaunchPoint is not included
+    size_t getMemoryUsage() const;
+
 
 
 private:
     static const string CLASS_NAME;
-    static const int TIMEOUT_TRANSITION = 10000; // 10 seconds
 
     RunningApp(const RunningApp&);
     RunningApp& operator=(const RunningApp&) const;
 
-    static gboolean onKillingTimer(gpointer context);
-    void startKillingTimer(guint timeout);
-    void stopKillingTimer();
-
     LaunchPointPtr m_launchPoint;
 
     string m_instanceId;
@@ -327,8 +383,14 @@ private:
 
     LifeStatus m_lifeStatus;
     bool m_isFirstLaunch;
+    bool m_isBulkClosing;
     long long m_startTime;
-    guint m_killingTimer;
+    LaunchTrace m_launchTrace;
+    long m_peakMemory;
+
+    // launch preparation
+    bool m_isPrepared;
+    JValue m_preparedPayload;
 
     // initial parameter
     string m_preload;
@@ -339,6 +401,7 @@ private:
 
     string m_reason;
     LSMessageToken m_token;
+    unsigned long m_traceId;
     int m_context;
 
     // for native app
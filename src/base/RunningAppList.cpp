@@ -18,6 +18,13 @@
 
 #include "bus/service/ApplicationManager.h"
 #include "conf/RuntimeInfo.h"
+#include "manager/BulkTerminator.h"
+#include "manager/MemoryEstimator.h"
+#include "manager/PolicyManager.h"
+#include "manager/PreloadManager.h"
+#include "manager/ResidentAppManager.h"
+#include "manager/ResourceSampler.h"
+#include "manager/RunningAppSnapshot.h"
 
 RunningAppList::RunningAppList()
 {
@@ -238,7 +245,7 @@ bool RunningAppList::add(RunningAppPtr runningApp)
         return false;
     }
     if (m_map.find(runningApp->getInstanceId()) != m_map.end()) {
-        Logger::info(getClassName(), __FUNCTION__, runningApp->getInstanceId(), "InstanceId is already exist");
+        LOG_INFO(getClassName(), __FUNCTION__, runningApp->getInstanceId(), "InstanceId is already exist");
         return false;
     }
     m_map[runningApp->getInstanceId()] = runningApp;
@@ -370,13 +377,22 @@ void RunningAppList::toJson(JValue& array, bool devmodeOnly)
 void RunningAppList::onAdd(RunningAppPtr runningApp)
 {
     // Status should be defined before calling this method
-    Logger::info(getClassName(), __FUNCTION__, runningApp->getInstanceId() + " is added");
+    LOG_INFO(getClassName(), __FUNCTION__, runningApp->getInstanceId() + " is added");
     ApplicationManager::getInstance().postRunning(runningApp);
+    ResidentAppManager::getInstance().onAdd(runningApp);
+    ResourceSampler::getInstance().onAdd(runningApp);
+    RunningAppSnapshot::getInstance().update();
 }
 
 void RunningAppList::onRemove(RunningAppPtr runningApp)
 {
-    Logger::info(getClassName(), __FUNCTION__, runningApp->getInstanceId() + " is removed");
+    LOG_INFO(getClassName(), __FUNCTION__, runningApp->getInstanceId() + " is removed");
     runningApp->setLifeStatus(LifeStatus::LifeStatus_STOP);
     ApplicationManager::getInstance().postRunning(runningApp);
+    MemoryEstimator::getInstance().onRemove(runningApp);
+    PreloadManager::getInstance().onRemove(runningApp);
+    BulkTerminator::getInstance().onRemove(runningApp);
+    PolicyManager::getInstance().onRemove(runningApp);
+    ResourceSampler::getInstance().onRemove(runningApp);
+    RunningAppSnapshot::getInstance().update();
 }
@@ -56,6 +56,11 @@ public:
     void removeAllByConext(AppType type, const int context);
     void removeAllByLaunchPoint(LaunchPointPtr launchPoint);
 
+    const map<string, RunningAppPtr>& getAll() const
+    {
+        return m_map;
+    }
+
     bool setConext(AppType type, const int context);
     bool isTransition(bool devmodeOnly);
     void toJson(JValue& array, bool devmodeOnly = false);
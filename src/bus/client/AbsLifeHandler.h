@@ -27,10 +27,15 @@ public:
     AbsLifeHandler() {};
     virtual ~AbsLifeHandler() {};
 
+    // prepare is called while SAM is waiting for memory. It should not have any side effect
+    // because the launch can be canceled. Prepared data should be stored in RunningApp.
+    virtual void prepare(RunningAppPtr runningApp, LunaTaskPtr lunaTask) {};
     virtual void launch(RunningAppPtr runningApp, LunaTaskPtr lunaTask) = 0;
     virtual void pause(RunningAppPtr runningApp, LunaTaskPtr lunaTask) = 0;
     virtual void close(RunningAppPtr runningApp, LunaTaskPtr lunaTask) = 0;
     virtual void kill(RunningAppPtr runningApp) = 0;
+    // Graceful termination which is used before kill. Handlers without it kill the app.
+    virtual void term(RunningAppPtr runningApp) { kill(runningApp); };
 
 protected:
 
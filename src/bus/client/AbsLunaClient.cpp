@@ -16,6 +16,8 @@
 
 #include "AbsLunaClient.h"
 
+#include "manager/Watchdog.h"
+
 JValue& AbsLunaClient::getEmptyPayload()
 {
     static JValue empty;
@@ -39,6 +41,7 @@ JValue& AbsLunaClient::getSubscriptionPayload()
 bool AbsLunaClient::_onServerStatus(LSHandle* sh, LSMessage* message, void* context)
 {
     AbsLunaClient* client = static_cast<AbsLunaClient*>(context);
+    Watchdog::getInstance().setActivity(client->getName().c_str());
 
     Message response(message);
     JValue subscriptionPayload = JDomParser::fromString(response.getPayload());
@@ -52,9 +55,9 @@ bool AbsLunaClient::_onServerStatus(LSHandle* sh, LSMessage* message, void* cont
     }
 
     if (connected)
-        Logger::info(client->getClassName(), __FUNCTION__, "Service is up");
+        LOG_INFO(client->getClassName(), __FUNCTION__, "Service is up");
     else
-        Logger::info(client->getClassName(), __FUNCTION__, "Service is down");
+        LOG_INFO(client->getClassName(), __FUNCTION__, "Service is down");
 
     client->m_serverStatusCount++;
     client->m_isConnected = connected;
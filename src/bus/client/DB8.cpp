@@ -16,29 +16,43 @@
 
 #include "DB8.h"
 
+#include <vector>
+
+#include "Environment.h"
+#include "base/AppDescriptionList.h"
 #include "base/LaunchPointList.h"
 #include "bus/service/ApplicationManager.h"
+#include "conf/Persistence.h"
 #include "conf/SAMConf.h"
+#include "manager/ApiMetrics.h"
 #include "util/JValueUtil.h"
 #include "util/Logger.h"
+#include "util/Tracer.h"
 
 const char* DB8::KIND_NAME = "com.webos.applicationManager.launchpoints:2";
 
-bool DB8::onResponse(LSHandle* sh, LSMessage* message, void* context)
-{
-    Message response(message);
-    JValue responsePayload = JDomParser::fromString(response.getPayload());
-    Logger::logCallResponse(getInstance().getClassName(), __FUNCTION__, response, responsePayload);
-
-    if (responsePayload.isNull())
-        return false;
-    return true;
-}
-
 DB8::DB8()
-    : AbsLunaClient("com.webos.service.db")
+    : AbsLunaClient("com.webos.service.db"),
+      m_inflightToken(0),
+      m_writeTimer(0),
+      m_retryDelay(0),
+      m_batchCount(0),
+      m_operationCount(0),
+      m_coalescedCount(0),
+      m_retryCount(0),
+      m_dropCount(0),
+      m_rev(0),
+      m_queryRev(0),
+      m_maxRev(0),
+      m_isFullSync(true),
+      m_isKindUpdated(false),
+      m_pageCount(0),
+      m_changedCount(0)
 {
     setClassName("DB8");
+
+    m_snapshot = pbnjson::Object();
+    m_snapshot.put("launchPoints", pbnjson::Object());
 }
 
 DB8::~DB8()
@@ -48,110 +62,312 @@ DB8::~DB8()
 
 bool DB8::insertLaunchPoint(JValue& json)
 {
-    static string method = string("luna://") + getName() + string("/put");
-
     if (json.isNull())
         return false;
 
     json.put("_kind", KIND_NAME);
 
-    JValue requestPayload = pbnjson::Object();
-    requestPayload.put("objects", pbnjson::Array());
-    requestPayload["objects"].append(json);
+    Write write;
+    write.isDeleted = false;
+    write.isInsert = true;
+    write.object = json;
+    enqueue(json["launchPointId"].asString(), write);
 
-    Logger::logCallRequest(getClassName(), __FUNCTION__, method, requestPayload);
-    if (!LSCallOneReply(
-        ApplicationManager::getInstance().get(),
-        method.c_str(),
-        requestPayload.stringify().c_str(),
-        onResponse,
-        nullptr,
-        nullptr,
-        nullptr
-    )) {
-        return false;
-    }
+    m_snapshot["launchPoints"].put(json["launchPointId"].asString(), json);
+    saveSnapshot();
     return true;
 }
 
 bool DB8::updateLaunchPoint(const JValue& props)
 {
-    static string method = string("luna://") + getName() + string("/merge");
-    JValue requestPayload = pbnjson::Object();
-    JValue where = pbnjson::Array();
-    JValue query = pbnjson::Object();
-
     if (props.isNull())
         return false;
 
-    where.put("prop", "launchPointId");
-    where.put("op", "=");
-    where.put("val", props["launchPointId"]);
+    Write write;
+    write.isDeleted = false;
+    write.isInsert = false;
+    write.object = props;
+    enqueue(props["launchPointId"].asString(), write);
 
-    query.put("where", where);
-    query.put("from", KIND_NAME);
+    m_snapshot["launchPoints"].put(props["launchPointId"].asString(), props);
+    saveSnapshot();
+    return true;
+}
 
-    requestPayload.put("props", props);
-    requestPayload.put("query", query);
+void DB8::deleteLaunchPoint(const string& launchPointId)
+{
+    Write write;
+    write.isDeleted = true;
+    write.isInsert = false;
+    write.object = JValue();
+    enqueue(launchPointId, write);
+
+    m_snapshot["launchPoints"].remove(launchPointId);
+    saveSnapshot();
+}
 
-    Logger::logCallRequest(getClassName(), __FUNCTION__, method, requestPayload);
-    if (!LSCallOneReply(
-        ApplicationManager::getInstance().get(),
-        method.c_str(),
-        requestPayload.stringify().c_str(),
-        onResponse,
-        nullptr,
-        nullptr,
-        nullptr
-    )) {
-        return false;
+void DB8::flush()
+{
+    if (m_writeTimer != 0) {
+        g_source_remove(m_writeTimer);
+        m_writeTimer = 0;
+    }
+    // Called in shutdown. Responses can't be waited, so the whole queue is sent in a single batch.
+    batch(true);
+}
+
+void DB8::toJson(JValue& json)
+{
+    json.put("queued", (int)m_queue.size());
+    json.put("inflight", (int)m_inflight.size());
+    json.put("batchCount", m_batchCount);
+    json.put("operationCount", m_operationCount);
+    json.put("coalescedCount", m_coalescedCount);
+    json.put("retryCount", m_retryCount);
+    json.put("dropCount", m_dropCount);
+    json.put("retryDelay", m_retryDelay);
+    json.put("rev", m_rev);
+    json.put("pageCount", m_pageCount);
+    json.put("changedCount", m_changedCount);
+}
+
+gboolean DB8::onWriteTimer(gpointer context)
+{
+    getInstance().m_writeTimer = 0;
+    if (getInstance().m_inflight.empty())
+        getInstance().batch();
+    return G_SOURCE_REMOVE;
+}
+
+bool DB8::onBatch(LSHandle* sh, LSMessage* message, void* context)
+{
+    Message response(message);
+    JValue responsePayload = JDomParser::fromString(response.getPayload());
+    Logger::logCallResponse(getInstance().getClassName(), __FUNCTION__, response, responsePayload);
+    unsigned long traceId = ApiMetrics::getInstance().onCallResponse(message, responsePayload);
+    TRACE_SCOPE("response", __FUNCTION__, nullptr, traceId);
+
+    DB8& self = getInstance();
+    bool returnValue = false;
+    JValueUtil::getValue(responsePayload, "returnValue", returnValue);
+
+    // The batch sent by flush() is not tracked
+    if (response.getResponseToken() != self.m_inflightToken)
+        return true;
+    self.m_inflightToken = 0;
+
+    if (!returnValue) {
+        self.retry();
+        return true;
     }
+
+    self.m_inflight.clear();
+    self.m_retryDelay = 0;
+    if (!self.m_queue.empty() && self.m_writeTimer == 0)
+        self.batch();
     return true;
 }
 
-void DB8::deleteLaunchPoint(const string& launchPointId)
+void DB8::merge(const Write& older, Write& newer)
 {
-    static string method = string("luna://") + getName() + string("/del");
-    JValue requestPayload = pbnjson::Object();
-    JValue where = pbnjson::Object();
+    if (!newer.isDeleted && newer.object.isNull()) {
+        newer.isInsert = older.isInsert;
+        newer.object = older.object;
+    } else if (!newer.object.isNull() && older.isInsert) {
+        // The object was never stored. The update should be stored as a new object.
+        newer.isInsert = true;
+    }
+    newer.isDeleted = newer.isDeleted || older.isDeleted;
+}
 
-    requestPayload.put("query", pbnjson::Object());
-    requestPayload["query"].put("from", KIND_NAME);
-    requestPayload["query"].put("where", pbnjson::Array());
+void DB8::enqueue(const string& launchPointId, const Write& write)
+{
+    // Written during full sync. DB8 may not return it yet, but it should not be regarded as removed.
+    m_found.insert(launchPointId);
+    auto it = m_queue.find(launchPointId);
+    if (it == m_queue.end()) {
+        m_queue[launchPointId] = write;
+    } else {
+        m_coalescedCount++;
+        // Deletion drops writes which are not sent yet
+        Write newer = write;
+        if (!newer.isDeleted)
+            merge(it->second, newer);
+        it->second = newer;
+    }
+    schedule(WRITE_DELAY);
+}
+
+void DB8::schedule(int delay)
+{
+    // The armed timer can be a retry. It is not shortened by new writes.
+    if (m_writeTimer != 0)
+        return;
+    m_writeTimer = g_timeout_add(delay, onWriteTimer, nullptr);
+}
 
-    where.put("prop", "launchPointId");
-    where.put("op", "=");
-    where.put("val", launchPointId);
-    requestPayload["query"]["where"].append(where);
+bool DB8::batch(bool isFlush)
+{
+    static string method = string("luna://") + getName() + string("/batch");
+    static int metric = ApiMetrics::getInstance().addCall(method);
 
+    if (m_queue.empty())
+        return false;
+
+    JValue deletes = pbnjson::Array();
+    JValue objects = pbnjson::Array();
+    JValue merges = pbnjson::Array();
+    int count = 0;
+    for (auto it = m_queue.begin(); it != m_queue.end() && (isFlush || count < MAX_BATCH_SIZE); ) {
+        const Write& write = it->second;
+        if (write.isDeleted) {
+            JValue where = pbnjson::Object();
+            where.put("prop", "launchPointId");
+            where.put("op", "=");
+            where.put("val", it->first);
+
+            JValue query = pbnjson::Object();
+            query.put("from", KIND_NAME);
+            query.put("where", pbnjson::Array());
+            query["where"].append(where);
+
+            JValue operation = pbnjson::Object();
+            operation.put("method", "del");
+            operation.put("params", pbnjson::Object());
+            operation["params"].put("query", query);
+            deletes.append(operation);
+            count++;
+        }
+
+        if (!write.object.isNull()) {
+            if (write.isInsert) {
+                objects.append(write.object);
+            } else {
+                JValue where = pbnjson::Object();
+                where.put("prop", "launchPointId");
+                where.put("op", "=");
+                where.put("val", it->first);
+
+                JValue query = pbnjson::Object();
+                query.put("from", KIND_NAME);
+                query.put("where", pbnjson::Array());
+                query["where"].append(where);
+
+                JValue operation = pbnjson::Object();
+                operation.put("method", "merge");
+                operation.put("params", pbnjson::Object());
+                operation["params"].put("props", write.object);
+                operation["params"].put("query", query);
+                merges.append(operation);
+            }
+            count++;
+        }
+
+        if (!isFlush)
+            m_inflight[it->first] = write;
+        it = m_queue.erase(it);
+    }
+
+    // Deletions go first. Otherwise, a re-added launch point would be deleted again.
+    JValue operations = pbnjson::Array();
+    for (int i = 0; i < deletes.arraySize(); ++i)
+        operations.append(deletes[i]);
+    if (objects.arraySize() > 0) {
+        JValue operation = pbnjson::Object();
+        operation.put("method", "put");
+        operation.put("params", pbnjson::Object());
+        operation["params"].put("objects", objects);
+        operations.append(operation);
+    }
+    for (int i = 0; i < merges.arraySize(); ++i)
+        operations.append(merges[i]);
+
+    JValue requestPayload = pbnjson::Object();
+    requestPayload.put("operations", operations);
+
+    m_batchCount++;
+    m_operationCount += count;
+    LSMessageToken token = 0;
+    string payload = requestPayload.stringify();
     Logger::logCallRequest(getClassName(), __FUNCTION__, method, requestPayload);
     if (!LSCallOneReply(
         ApplicationManager::getInstance().get(),
         method.c_str(),
-        requestPayload.stringify().c_str(),
-        onResponse,
-        nullptr,
+        payload.c_str(),
+        onBatch,
         nullptr,
+        &token,
         nullptr
     )) {
+        Logger::warning(getClassName(), __FUNCTION__, "Failed to call batch");
+        if (!isFlush)
+            retry();
+        return false;
+    }
+    if (!isFlush)
+        m_inflightToken = token;
+    ApiMetrics::getInstance().onCallRequest(metric, token, payload.length());
+    return true;
+}
+
+void DB8::retry()
+{
+    map<string, Write> inflight;
+    inflight.swap(m_inflight);
+
+    m_retryDelay = m_retryDelay > 0 ? m_retryDelay * 2 : WRITE_DELAY;
+    if (m_retryDelay > MAX_RETRY_DELAY) {
+        Logger::error(getClassName(), __FUNCTION__, Logger::format("Drop %d operations", (int)inflight.size()));
+        m_retryDelay = 0;
+        m_dropCount += inflight.size();
+        if (!m_queue.empty())
+            schedule(WRITE_DELAY);
         return;
     }
+
+    // The batch is a single transaction. Newer writes in the queue are kept on top of it.
+    for (auto it = inflight.begin(); it != inflight.end(); ++it) {
+        auto newer = m_queue.find(it->first);
+        if (newer == m_queue.end())
+            m_queue[it->first] = it->second;
+        else
+            merge(it->second, newer->second);
+    }
+    m_retryCount++;
+
+    Logger::warning(getClassName(), __FUNCTION__,
+                    Logger::format("Retry %d operations after %dms", (int)m_queue.size(), m_retryDelay));
+    // WRITE_DELAY timer can be armed by writes during the failed batch. The backoff replaces it.
+    if (m_writeTimer != 0)
+        g_source_remove(m_writeTimer);
+    m_writeTimer = g_timeout_add(m_retryDelay, onWriteTimer, nullptr);
 }
 
 void DB8::onInitialzed()
 {
-    // nothing
+    loadSnapshot();
 }
 
 void DB8::onFinalized()
 {
-
+    flush();
 }
 
 void DB8::onServerStatusChanged(bool isConnected)
 {
     if (isConnected) {
-        Logger::info(getClassName(), __FUNCTION__, "DB8 is connected. Start loading launchPoints");
+        LOG_INFO(getClassName(), __FUNCTION__,
+                 Logger::format("DB8 is connected. Start loading launchPoints after rev(%d)", m_rev));
+        m_queryRev = m_rev;
+        m_maxRev = m_rev;
+        m_isFullSync = (m_rev == 0);
+        m_isKindUpdated = false;
+        m_found.clear();
+        // Pending writes are not in DB8 yet
+        for (auto it = m_queue.begin(); it != m_queue.end(); ++it)
+            m_found.insert(it->first);
+        for (auto it = m_inflight.begin(); it != m_inflight.end(); ++it)
+            m_found.insert(it->first);
         find();
     }
 }
@@ -161,91 +377,237 @@ bool DB8::onFind(LSHandle* sh, LSMessage* message, void* context)
     Message response(message);
     JValue responsePayload = JDomParser::fromString(response.getPayload());
     Logger::logCallResponse(getInstance().getClassName(), __FUNCTION__, response, responsePayload);
+    unsigned long traceId = ApiMetrics::getInstance().onCallResponse(message, responsePayload);
+    TRACE_SCOPE("response", __FUNCTION__, nullptr, traceId);
 
     if (responsePayload.isNull())
         return true;
 
+    DB8& self = getInstance();
     bool returnValue = false;
     JValue results;
     string errorText;
+    string next;
 
     JValueUtil::getValue(responsePayload, "returnValue", returnValue);
     JValueUtil::getValue(responsePayload, "errorText", errorText);
     JValueUtil::getValue(responsePayload, "results", results);
+    JValueUtil::getValue(responsePayload, "next", next);
 
     if (!returnValue || !results.isArray()) {
         if (!errorText.empty())
-            Logger::warning(getInstance().getClassName(), __FUNCTION__, errorText);
+            Logger::warning(self.getClassName(), __FUNCTION__, errorText);
         else
-            Logger::warning(getInstance().getClassName(), __FUNCTION__, "results is not valid");
-        getInstance().putKind();
+            Logger::warning(self.getClassName(), __FUNCTION__, "results is not valid");
+        if (self.m_pageCount != 0)
+            return true;
+
+        // The kind may not exist or may be older than sam-conf (e.g. no 'incDel' in the revision index).
+        // It is put only once. If the incremental query still fails, all objects are loaded again.
+        if (!self.m_isKindUpdated) {
+            self.m_isKindUpdated = true;
+            self.putKind();
+        } else if (self.m_queryRev > 0) {
+            Logger::warning(self.getClassName(), __FUNCTION__, Logger::format("Fallback to full sync from rev(%d)", self.m_queryRev));
+            self.m_queryRev = 0;
+            self.m_isFullSync = true;
+            self.find();
+        } else {
+            Logger::error(self.getClassName(), __FUNCTION__, "Failed to load launchPoints");
+        }
         return true;
     }
-    Logger::info(getInstance().getClassName(), __FUNCTION__, "Start to sync DB8");
 
-    string appId;
-    string launchPointId;
-    string type;
-    AppDescriptionPtr appDesc = nullptr;
-    LaunchPointPtr launchPoint = nullptr;
+    self.m_pageCount++;
     int size = results.arraySize();
     for (int i = 0; i < size; ++i) {
-        if (!JValueUtil::getValue(results[i], "id", appId) ||
-            !JValueUtil::getValue(results[i], "launchPointId", launchPointId) ||
-            !JValueUtil::getValue(results[i], "type", type)) {
-            Logger::warning(getInstance().getClassName(), __FUNCTION__, "Invalid data in DB8");
-            continue;
-        }
+        int rev = 0;
+        string launchPointId;
+        if (JValueUtil::getValue(results[i], "_rev", rev) && rev > self.m_maxRev)
+            self.m_maxRev = rev;
+        if (JValueUtil::getValue(results[i], "launchPointId", launchPointId))
+            self.m_found.insert(launchPointId);
+        self.apply(results[i], false);
+    }
 
-        if (appId.empty() || type.empty()) {
-            DB8::getInstance().deleteLaunchPoint(launchPointId);
-            continue;
-        }
+    if (!next.empty() && size > 0) {
+        self.find(next);
+        return true;
+    }
 
-        appDesc = AppDescriptionList::getInstance().getByAppId(appId);
-        if (appDesc == nullptr) {
-            Logger::warning(getInstance().getClassName(), __FUNCTION__, "The app is already uninstalled");
-            DB8::getInstance().deleteLaunchPoint(launchPointId);
-            continue;
+    // Full sync means objects which are not found don't exist in DB8 anymore
+    if (self.m_isFullSync) {
+        vector<string> removed;
+        for (JValue::KeyValue launchPoint : self.m_snapshot["launchPoints"].children()) {
+            if (self.m_found.count(launchPoint.first.asString()) == 0)
+                removed.push_back(launchPoint.first.asString());
         }
-
-        launchPoint = LaunchPointList::getInstance().getByLaunchPointId(launchPointId);
-        if (type == "default") {
-            launchPoint->setDatabase(results[i]);
-        } else if (type == "bookmark") {
-            if (launchPoint == nullptr) {
-                launchPoint = LaunchPointList::getInstance().createBootmarkByDB(appDesc, results[i]);
-                LaunchPointList::getInstance().add(launchPoint);
-            }
+        for (auto it = removed.begin(); it != removed.end(); ++it) {
+            JValue object = pbnjson::Object();
+            object.put("launchPointId", *it);
+            object.put("_del", true);
+            self.apply(object, false);
         }
     }
-    Logger::info(getInstance().getClassName(), __FUNCTION__, "Complete to sync DB8");
-
-    // 여기서 LaunchPoints를 만들어 넣어야 함.
+    self.m_found.clear();
+    self.m_rev = self.m_maxRev;
+    self.saveSnapshot();
+    LOG_INFO(self.getClassName(), __FUNCTION__,
+             Logger::format("Complete to sync DB8. rev(%d) changed(%d)", self.m_rev, self.m_changedCount));
     return true;
 }
 
-void DB8::find()
+void DB8::find(const string& page)
 {
     static string method = string("luna://") + getName() + string("/find");
+    static int metric = ApiMetrics::getInstance().addCall(method);
+
+    JValue query = pbnjson::Object();
+    query.put("from", KIND_NAME);
+    query.put("orderBy", "_rev");
+    query.put("limit", PAGE_SIZE);
+    if (m_queryRev > 0) {
+        JValue where = pbnjson::Object();
+        where.put("prop", "_rev");
+        where.put("op", ">");
+        where.put("val", m_queryRev);
+        query.put("where", pbnjson::Array());
+        query["where"].append(where);
+        query.put("incDel", true);
+    }
+    if (!page.empty())
+        query.put("page", page);
+    else
+        m_pageCount = 0;
 
     JValue requestPayload = pbnjson::Object();
-    requestPayload.put("query", pbnjson::Object());
-    requestPayload["query"].put("from", KIND_NAME);
-    requestPayload["query"].put("orderBy", "_rev");
+    requestPayload.put("query", query);
 
+    LSMessageToken token = 0;
+    string payload = requestPayload.stringify();
     Logger::logCallRequest(getClassName(), __FUNCTION__, method, requestPayload);
     if (!LSCallOneReply(
         ApplicationManager::getInstance().get(),
         method.c_str(),
-        requestPayload.stringify().c_str(),
+        payload.c_str(),
         onFind,
         nullptr,
-        nullptr,
+        &token,
         nullptr
     )) {
         return;
     }
+    ApiMetrics::getInstance().onCallRequest(metric, token, payload.length());
+}
+
+void DB8::loadSnapshot()
+{
+    GError* error = nullptr;
+    GMappedFile* file = g_mapped_file_new(PATH_LAUNCH_POINT_SNAPSHOT, FALSE, &error);
+    if (file == nullptr) {
+        if (error != nullptr)
+            g_error_free(error);
+        LOG_INFO(getClassName(), __FUNCTION__, PATH_LAUNCH_POINT_SNAPSHOT, "No launch point snapshot");
+        return;
+    }
+
+    JValue snapshot;
+    if (g_mapped_file_get_length(file) > 0)
+        snapshot = JDomParser::fromString(string(g_mapped_file_get_contents(file), g_mapped_file_get_length(file)));
+    g_mapped_file_unref(file);
+
+    JValue launchPoints;
+    if (!JValueUtil::getValue(snapshot, "launchPoints", launchPoints) || !launchPoints.isObject()) {
+        Logger::warning(getClassName(), __FUNCTION__, PATH_LAUNCH_POINT_SNAPSHOT, "Invalid launch point snapshot");
+        return;
+    }
+    m_rev = 0;
+    JValueUtil::getValue(snapshot, "rev", m_rev);
+    m_snapshot = snapshot;
+
+    // Applying can change the snapshot
+    vector<JValue> objects;
+    for (JValue::KeyValue launchPoint : launchPoints.children())
+        objects.push_back(launchPoint.second);
+    for (auto it = objects.begin(); it != objects.end(); ++it)
+        apply(*it, true);
+
+    LOG_INFO(getClassName(), __FUNCTION__,
+             Logger::format("Snapshot is applied. rev(%d) launchPoints(%d)", m_rev, (int)objects.size()));
+}
+
+void DB8::saveSnapshot()
+{
+    m_snapshot.put("rev", m_rev);
+    Persistence::getInstance().write(PATH_LAUNCH_POINT_SNAPSHOT, m_snapshot);
+}
+
+void DB8::apply(const JValue& object, bool isSnapshot)
+{
+    string appId;
+    string launchPointId;
+    string type;
+    bool isDeleted = false;
+
+    if (!JValueUtil::getValue(object, "launchPointId", launchPointId)) {
+        Logger::warning(getClassName(), __FUNCTION__, "Invalid data in DB8");
+        return;
+    }
+    JValueUtil::getValue(object, "_del", isDeleted);
+    LaunchPointPtr launchPoint = LaunchPointList::getInstance().getByLaunchPointId(launchPointId);
+
+    if (isDeleted) {
+        m_snapshot["launchPoints"].remove(launchPointId);
+        if (launchPoint == nullptr)
+            return;
+        if (launchPoint->getType() == LaunchPointType::LaunchPoint_BOOKMARK)
+            LaunchPointList::getInstance().removeByLaunchPointId(launchPointId);
+        else
+            apply(launchPoint, pbnjson::Object());
+        return;
+    }
+
+    if (!JValueUtil::getValue(object, "id", appId) ||
+        !JValueUtil::getValue(object, "type", type) ||
+        appId.empty() || type.empty()) {
+        deleteLaunchPoint(launchPointId);
+        return;
+    }
+
+    AppDescriptionPtr appDesc = AppDescriptionList::getInstance().getByAppId(appId);
+    if (appDesc == nullptr) {
+        Logger::warning(getClassName(), __FUNCTION__, appId, "The app is already uninstalled");
+        if (isSnapshot)
+            m_snapshot["launchPoints"].remove(launchPointId);
+        else
+            deleteLaunchPoint(launchPointId);
+        return;
+    }
+    if (!isSnapshot)
+        m_snapshot["launchPoints"].put(launchPointId, object);
+
+    if (launchPoint != nullptr) {
+        apply(launchPoint, object);
+    } else if (type == "bookmark") {
+        launchPoint = LaunchPointList::getInstance().createBootmarkByDB(appDesc, object);
+        LaunchPointList::getInstance().add(launchPoint);
+        m_changedCount++;
+    }
+}
+
+void DB8::apply(LaunchPointPtr launchPoint, const JValue& database)
+{
+    JValue before = pbnjson::Object();
+    launchPoint->toJson(before);
+    launchPoint->setDatabase(database);
+    JValue after = pbnjson::Object();
+    launchPoint->toJson(after);
+
+    // '_rev' is always changed. It is not listed.
+    if (before != after) {
+        m_changedCount++;
+        ApplicationManager::getInstance().postListLaunchPoints(launchPoint, "updated");
+    }
 }
 
 bool DB8::onPutKind(LSHandle* sh, LSMessage* message, void* context)
@@ -253,6 +615,8 @@ bool DB8::onPutKind(LSHandle* sh, LSMessage* message, void* context)
     Message response(message);
     JValue responsePayload = pbnjson::JDomParser::fromString(response.getPayload());
     Logger::logCallResponse(getInstance().getClassName(), __FUNCTION__, response, responsePayload);
+    unsigned long traceId = ApiMetrics::getInstance().onCallResponse(message, responsePayload);
+    TRACE_SCOPE("response", __FUNCTION__, nullptr, traceId);
 
     if (responsePayload.isNull())
         return true;
@@ -275,20 +639,24 @@ bool DB8::onPutKind(LSHandle* sh, LSMessage* message, void* context)
 void DB8::putKind()
 {
     static string method = string("luna://") + getName() + string("/putKind");
+    static int metric = ApiMetrics::getInstance().addCall(method);
 
     JValue requestPayload = SAMConf::getInstance().getDBSchema();
+    LSMessageToken token = 0;
+    string payload = requestPayload.stringify();
     Logger::logCallRequest(getClassName(), __FUNCTION__, method, requestPayload);
     if (!LSCallOneReply(
         ApplicationManager::getInstance().get(),
         method.c_str(),
-        requestPayload.stringify().c_str(),
+        payload.c_str(),
         onPutKind,
         nullptr,
-        nullptr,
+        &token,
         nullptr
     )) {
         return;
     }
+    ApiMetrics::getInstance().onCallRequest(metric, token, payload.length());
 }
 
 bool DB8::onPutPermissions(LSHandle* sh, LSMessage* message, void* context)
@@ -296,6 +664,8 @@ bool DB8::onPutPermissions(LSHandle* sh, LSMessage* message, void* context)
     Message response(message);
     JValue responsePayload = JDomParser::fromString(response.getPayload());
     Logger::logCallResponse(getInstance().getClassName(), __FUNCTION__, response, responsePayload);
+    unsigned long traceId = ApiMetrics::getInstance().onCallResponse(message, responsePayload);
+    TRACE_SCOPE("response", __FUNCTION__, nullptr, traceId);
 
     bool returnValue = false;
     string errorText;
@@ -315,18 +685,22 @@ bool DB8::onPutPermissions(LSHandle* sh, LSMessage* message, void* context)
 void DB8::putPermissions()
 {
     static string method = string("luna://") + getName() + string("/putPermissions");
+    static int metric = ApiMetrics::getInstance().addCall(method);
 
     JValue requestPayload = SAMConf::getInstance().getDBPermission();
+    LSMessageToken token = 0;
+    string payload = requestPayload.stringify();
     Logger::logCallRequest(getClassName(), __FUNCTION__, method, requestPayload);
     if (!LSCallOneReply(
         ApplicationManager::getInstance().get(),
         method.c_str(),
-        requestPayload.stringify().c_str(),
+        payload.c_str(),
         onPutPermissions,
         nullptr,
-        nullptr,
+        &token,
         nullptr
     )) {
         return;
     }
+    ApiMetrics::getInstance().onCallRequest(metric, token, payload.length());
 }
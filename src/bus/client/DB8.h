@@ -17,26 +17,50 @@
 #ifndef BUS_CLIENT_DB8_H_
 #define BUS_CLIENT_DB8_H_
 
+#include <map>
+#include <set>
+#include <glib.h>
 #include <luna-service2/lunaservice.hpp>
 #include <boost/signals2.hpp>
 #include <pbnjson.hpp>
 
 #include "AbsLunaClient.h"
+#include "base/LaunchPoint.h"
 #include "interface/ISingleton.h"
 
 using namespace LS;
 using namespace pbnjson;
 
+// Launch point writes are not sent one by one.
+// They are queued per launchPointId for WRITE_DELAY and sent together in a single '/batch' call.
+//  - Later writes of the same launch point replace earlier ones in the queue.
+//  - Only one batch is in flight. A failed batch is merged back into the queue and retried with backoff.
+//    New writes don't shorten the backoff. It is dropped when the backoff exceeds MAX_RETRY_DELAY.
+//  - flush() sends the whole queue immediately as one more batch (shutdown). Its response is not tracked.
+//
+// DB8 state of launch points is also kept in a local snapshot file.
+// The snapshot is applied right after initialization, so bookmarks and overrides are listed before DB8 answers.
+// Then only objects changed after the last known '_rev' are found page by page (deleted objects included).
+// Launch points are posted only if their listed properties are really changed.
 class DB8 : public ISingleton<DB8>,
             public AbsLunaClient {
 friend class ISingleton<DB8>;
 public:
     virtual ~DB8();
 
+    static const int WRITE_DELAY = 300; // ms
+    static const int MAX_BATCH_SIZE = 100;
+    static const int MAX_RETRY_DELAY = 30000; // ms
+    static const int PAGE_SIZE = 100;
+
     bool insertLaunchPoint(JValue& json);
     bool updateLaunchPoint(const JValue& json);
     void deleteLaunchPoint(const string& launchPointId);
 
+    void flush();
+
+    void toJson(JValue& json);
+
 protected:
     // AbsLunaClient
     virtual void onInitialzed() override;
@@ -46,10 +70,28 @@ protected:
 private:
     static const char* KIND_NAME;
 
-    static bool onResponse(LSHandle* sh, LSMessage* message, void* context);
+    // Pending operations of a launch point. Deletion is sent before the write.
+    struct Write {
+        bool isDeleted;
+        bool isInsert;
+        JValue object;
+    };
+
+    static gboolean onWriteTimer(gpointer context);
+    static bool onBatch(LSHandle* sh, LSMessage* message, void* context);
+    static void merge(const Write& older, Write& newer);
+    void enqueue(const string& launchPointId, const Write& write);
+    void schedule(int delay);
+    bool batch(bool isFlush = false);
+    void retry();
 
     static bool onFind(LSHandle* sh, LSMessage* message, void* context);
-    void find();
+    void find(const string& page = "");
+
+    void loadSnapshot();
+    void saveSnapshot();
+    void apply(const JValue& object, bool isSnapshot);
+    void apply(LaunchPointPtr launchPoint, const JValue& database);
 
     static bool onPutKind(LSHandle* sh, LSMessage* message, void* context);
     void putKind();
@@ -59,6 +101,31 @@ private:
 
     DB8();
 
+    map<string, Write> m_queue;
+    map<string, Write> m_inflight;
+    LSMessageToken m_inflightToken;
+    guint m_writeTimer;
+    int m_retryDelay;
+
+    int m_batchCount;
+    int m_operationCount;
+    int m_coalescedCount;
+    int m_retryCount;
+    int m_dropCount;
+
+    // { "rev": last found _rev, "launchPoints": { launchPointId: DB8 object } }
+    JValue m_snapshot;
+    int m_rev;
+    int m_queryRev;
+    int m_maxRev;
+    bool m_isFullSync;
+    bool m_isKindUpdated;
+    // Found or written during sync
+    set<string> m_found;
+
+    int m_pageCount;
+    int m_changedCount;
+
 };
 
 #endif /* BUS_CLIENT_DB8_H_ */
@@ -22,7 +22,10 @@
 #include "base/RunningApp.h"
 #include "base/RunningAppList.h"
 #include "bus/service/ApplicationManager.h"
+#include "manager/ApiMetrics.h"
+#include "manager/RunningAppSnapshot.h"
 #include "util/JValueUtil.h"
+#include "util/Tracer.h"
 
 bool LSM::isFullscreenWindowType(const JValue& foregroundInfo)
 {
@@ -85,7 +88,10 @@ bool LSM::onGetForegroundAppInfo(LSHandle* sh, LSMessage* message, void* context
 {
     Message response(message);
     JValue subscriptionPayload = JDomParser::fromString(response.getPayload());
+    static int metric = ApiMetrics::getInstance().addCall(string("luna://") + getInstance().getName() + string("/getForegroundAppInfo"));
     Logger::logSubscriptionResponse(getInstance().getClassName(), __FUNCTION__, response, subscriptionPayload);
+    ApiMetrics::getInstance().onSubscriptionResponse(metric, message, subscriptionPayload);
+    TRACE_SCOPE("response", __FUNCTION__, nullptr, 0);
 
     if (subscriptionPayload.isNull())
         return true;
@@ -111,7 +117,7 @@ bool LSM::onGetForegroundAppInfo(LSHandle* sh, LSMessage* message, void* context
 
         RunningAppPtr runningApp = RunningAppList::getInstance().getByAppId(appId, displayId);
         if (runningApp == nullptr) {
-            Logger::info(getInstance().getClassName(), __FUNCTION__, "Cannot find RunningApp. Respawned or Skipped for other sessions");
+            LOG_INFO(getInstance().getClassName(), __FUNCTION__, "Cannot find RunningApp. Respawned or Skipped for other sessions");
             continue;
         }
 
@@ -131,13 +137,16 @@ bool LSM::onGetForegroundAppInfo(LSHandle* sh, LSMessage* message, void* context
         if (runningApp->getLaunchPoint()->getAppDesc()->getAppType() == AppType::AppType_Web) {
             runningApp->setProcessId(atoi(processId.c_str()));
         }
+        if (runningApp->markStage(LaunchStage::LaunchStage_FOREGROUND))
+            LOG_INFO(getInstance().getClassName(), __FUNCTION__, runningApp->getAppId(),
+                     Logger::format("Foreground Time: %lld ms (%s)", runningApp->getLaunchTrace().getElapsed(LaunchStage::LaunchStage_FOREGROUND), runningApp->getStages().c_str()));
         runningApp->setLifeStatus(LifeStatus::LifeStatus_FOREGROUND);
-        if (runningApp->isFirstLaunch())
-            Logger::info(getInstance().getClassName(), __FUNCTION__, runningApp->getAppId(), Logger::format("Foreground Time: %lld ms", runningApp->getTimeStamp()));
         newForegroundAppInfo.append(orgForegroundAppInfo[i].duplicate());
         newForegroundAppIds.push_back(appId);
     }
 
+    RunningAppSnapshot::getInstance().onForegroundReconciled(newForegroundAppIds);
+
     // set background
     for (auto& oldAppId : getInstance().m_foregroundAppIds) {
         bool found = false;
@@ -167,6 +176,8 @@ bool LSM::onGetForegroundAppInfo(LSHandle* sh, LSMessage* message, void* context
 
     ApplicationManager::getInstance().postRunning(nullptr);
     ApplicationManager::getInstance().postGetForegroundAppInfo(extraInfoOnly);
+    if (!extraInfoOnly)
+        getInstance().EventFullWindowAppChanged(newFullWindowAppId);
     return true;
 }
 
@@ -35,6 +35,7 @@ public:
     virtual ~LSM();
 
     boost::signals2::signal<void(const JValue&)> EventRecentsAppListChanged;
+    boost::signals2::signal<void(const string&)> EventFullWindowAppChanged;
 
     void getForegroundInfoById(const string& appId, JValue& info)
     {
@@ -16,6 +16,10 @@
 
 #include "MemoryManager.h"
 
+#include "manager/ApiMetrics.h"
+#include "manager/MemoryEstimator.h"
+#include "util/Tracer.h"
+
 MemoryManager::MemoryManager()
     : AbsLunaClient("com.webos.service.memorymanager")
 {
@@ -45,6 +49,8 @@ bool MemoryManager::onRequireMemory(LSHandle* sh, LSMessage* message, void* cont
     Message response(message);
     JValue responsePayload = pbnjson::JDomParser::fromString(response.getPayload());
     Logger::logCallResponse(getInstance().getClassName(), __FUNCTION__, response, responsePayload);
+    unsigned long traceId = ApiMetrics::getInstance().onCallResponse(message, responsePayload);
+    TRACE_SCOPE("response", __FUNCTION__, nullptr, traceId);
 
     LSMessageToken token = LSMessageGetResponseToken(message);
     LunaTaskPtr lunaTask = LunaTaskList::getInstance().getByToken(token);
@@ -77,9 +83,43 @@ bool MemoryManager::onRequireMemory(LSHandle* sh, LSMessage* message, void* cont
     return true;
 }
 
+bool MemoryManager::onRequireTotalMemory(LSHandle* sh, LSMessage* message, void* context)
+{
+    Message response(message);
+    JValue responsePayload = pbnjson::JDomParser::fromString(response.getPayload());
+    Logger::logCallResponse(getInstance().getClassName(), __FUNCTION__, response, responsePayload);
+    unsigned long traceId = ApiMetrics::getInstance().onCallResponse(message, responsePayload);
+    TRACE_SCOPE("response", __FUNCTION__, nullptr, traceId);
+
+    LSMessageToken token = LSMessageGetResponseToken(message);
+    LunaTaskPtr lunaTask = LunaTaskList::getInstance().getByToken(token);
+    if (lunaTask == nullptr) {
+        Logger::error(getInstance().getClassName(), __FUNCTION__, "Cannot find lunaTask");
+        return false;
+    }
+
+    int errorCode = 0;
+    string errorText = "";
+    bool returnValue = true;
+
+    JValueUtil::getValue(responsePayload, "errorCode", errorCode);
+    JValueUtil::getValue(responsePayload, "errorText", errorText);
+    JValueUtil::getValue(responsePayload, "returnValue", returnValue);
+
+    if (!returnValue) {
+        lunaTask->setErrCodeAndText(errorCode, errorText);
+        lunaTask->error(lunaTask);
+        return true;
+    }
+
+    lunaTask->success(lunaTask);
+    return true;
+}
+
 void MemoryManager::requireMemory(RunningAppPtr runningApp, LunaTaskPtr lunaTask)
 {
     static string method = string("luna://") + getName() + string("/requireMemory");
+    static int metric = ApiMetrics::getInstance().addCall(method);
     JValue requestPayload = pbnjson::Object();
 
     if (!isConnected()) {
@@ -88,16 +128,16 @@ void MemoryManager::requireMemory(RunningAppPtr runningApp, LunaTaskPtr lunaTask
         return;
     }
 
-    // TODO : 150MB should be extended based on appinfo.json
-    requestPayload.put("requiredMemory", 150);
+    requestPayload.put("requiredMemory", MemoryEstimator::getInstance().getRequiredMemory(runningApp->getLaunchPoint()->getAppDesc()));
 
     LSErrorSafe error;
     LSMessageToken token = 0;
+    string payload = requestPayload.stringify();
     Logger::logCallRequest(getClassName(), __FUNCTION__, method, requestPayload);
     if (!LSCallOneReply(
         ApplicationManager::getInstance().get(),
         method.c_str(),
-        requestPayload.stringify().c_str(),
+        payload.c_str(),
         onRequireMemory,
         nullptr,
         &token,
@@ -107,6 +147,42 @@ void MemoryManager::requireMemory(RunningAppPtr runningApp, LunaTaskPtr lunaTask
         lunaTask->success(lunaTask);
         return;
     }
+    ApiMetrics::getInstance().onCallRequest(metric, token, payload.length());
     lunaTask->setToken(token);
     runningApp->setToken(token);
 }
+
+void MemoryManager::requireMemory(int requiredMemory, LunaTaskPtr lunaTask)
+{
+    static string method = string("luna://") + getName() + string("/requireMemory");
+    static int metric = ApiMetrics::getInstance().addCall(method);
+    JValue requestPayload = pbnjson::Object();
+
+    if (!isConnected()) {
+        Logger::warning(getClassName(), __FUNCTION__, "MemoryManager is not running. Skip memory reclaiming");
+        lunaTask->success(lunaTask);
+        return;
+    }
+
+    requestPayload.put("requiredMemory", requiredMemory);
+
+    LSErrorSafe error;
+    LSMessageToken token = 0;
+    string payload = requestPayload.stringify();
+    Logger::logCallRequest(getClassName(), __FUNCTION__, method, requestPayload);
+    if (!LSCallOneReply(
+        ApplicationManager::getInstance().get(),
+        method.c_str(),
+        payload.c_str(),
+        onRequireTotalMemory,
+        nullptr,
+        &token,
+        &error
+    )) {
+        // If calling MM is failed, just skip it.
+        lunaTask->success(lunaTask);
+        return;
+    }
+    ApiMetrics::getInstance().onCallRequest(metric, token, payload.length());
+    lunaTask->setToken(token);
+}
@@ -36,6 +36,8 @@ public:
     virtual ~MemoryManager();
 
     void requireMemory(RunningAppPtr runningApp, LunaTaskPtr lunaTask);
+    // Secures memory (MB) for several launches at once. There is no RunningApp yet
+    void requireMemory(int requiredMemory, LunaTaskPtr lunaTask);
 
 protected:
     // AbsLunaClient
@@ -45,6 +47,7 @@ protected:
 
 private:
     static bool onRequireMemory(LSHandle* sh, LSMessage* message, void* context);
+    static bool onRequireTotalMemory(LSHandle* sh, LSMessage* message, void* context);
 
     MemoryManager();
 };
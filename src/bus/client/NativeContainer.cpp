@@ -16,12 +16,21 @@
 
 #include "NativeContainer.h"
 
+#include <unistd.h>
+
 #include "base/AppDescription.h"
 #include "base/LunaTaskList.h"
 #include "base/AppDescriptionList.h"
 #include "base/RunningAppList.h"
 #include "conf/SAMConf.h"
 #include "conf/RuntimeInfo.h"
+#include "manager/FlightRecorder.h"
+#include "manager/NativeLogManager.h"
+#include "manager/ProcessSupervisor.h"
+#include "manager/RunnerPool.h"
+#include "manager/RunningAppSnapshot.h"
+#include "util/Cgroup.h"
+#include "util/ProcFs.h"
 
 const string NativeContainer::KEY_NATIVE_RUNNING_APPS = "nativeRunningApps";
 int NativeContainer::s_instanceCounter = 1;
@@ -30,10 +39,21 @@ void NativeContainer::onKillChildProcess(GPid pid, gint status, gpointer data)
 {
     static string lastLogFile = "";
 
-    Logger::info(getInstance().getClassName(), __FUNCTION__, Logger::format("Process(%d) was killed with status(%d)", pid, status));
+    LOG_INFO(getInstance().getClassName(), __FUNCTION__, Logger::format("Process(%d) was killed with status(%d)", pid, status));
     g_spawn_close_pid(pid);
 
     RunningAppPtr runningApp = RunningAppList::getInstance().getByPid(pid);
+    FlightRecorder::getInstance().recordChildExit(runningApp ? runningApp->getAppId() : "", pid, status);
+    if (runningApp && NativeLogManager::getInstance().isEnabled()) {
+        NativeLogManager::getInstance().onExit(runningApp->getAppId(), pid, status);
+    }
+    if (runningApp && !runningApp->getLinuxProcess().getCgroup().empty()) {
+        // Untracked process is not dead yet. Its cgroup is removed later when it is empty
+        if (runningApp->getLinuxProcess().isTracked())
+            getInstance().removeCgroup(runningApp->getLinuxProcess().getCgroup());
+        else
+            getInstance().m_staleCgroups.insert(runningApp->getLinuxProcess().getCgroup());
+    }
     if (runningApp && !runningApp->getLinuxProcess().getStdFile().empty()) {
         if (!lastLogFile.empty()) {
             File::deleteFile(lastLogFile);
@@ -54,6 +74,7 @@ void NativeContainer::onKillChildProcess(GPid pid, gint status, gpointer data)
 }
 
 NativeContainer::NativeContainer()
+    : m_spawnTime(HistogramUnit::HistogramUnit_US)
 {
     setClassName("NativeContainer");
 }
@@ -75,10 +96,14 @@ void NativeContainer::initialize()
         }
     }
     g_strfreev(variables);
+    m_environmentBlock = NativeProcess::makeEnvironmentBlock(m_environments);
+    NativeProcess::setLightweightSpawn(SAMConf::getInstance().isLightweightSpawnEnabled());
+    initializeCgroup();
 
     // Load already running native apps
     if (!RuntimeInfo::getInstance().getValue(KEY_NATIVE_RUNNING_APPS, m_nativeRunninApps)) {
         m_nativeRunninApps = pbnjson::Array();
+        removeStaleCgroups();
         return;
     }
     size = m_nativeRunninApps.arraySize();
@@ -88,20 +113,32 @@ void NativeContainer::initialize()
             continue;
         }
 
-        if (runningApp->getLinuxProcess().isRunning() == false) {
+        // The pid can be reused by another process while SAM is not running
+        JValue startTime;
+        JValueUtil::getValue(m_nativeRunninApps[i], "startTime", startTime);
+        if (!ProcessSupervisor::getInstance().adopt(runningApp->getProcessId(),
+                                                    startTime.isNumber() ? (unsigned long long)startTime.asNumber<int64_t>() : 0,
+                                                    onKillChildProcess, nullptr)) {
             m_nativeRunninApps.remove(i);
             continue;
         }
+        runningApp->getLinuxProcess().track();
 
-        // SAM doesn't know the proper status of already running native applications.
-        // However, 'BACKGROUND' is reasonable status because 'FOREGROUND' event will be received from LSM
-        runningApp->setLifeStatus(LifeStatus::LifeStatus_BACKGROUND);
+        string cgroup;
+        if (JValueUtil::getValue(m_nativeRunninApps[i], "cgroup", cgroup)) {
+            runningApp->getLinuxProcess().setCgroup(cgroup);
+        }
+
+        // The status before restart is kept in the running snapshot.
+        // Otherwise, 'BACKGROUND' is reasonable status because 'FOREGROUND' event will be received from LSM
+        runningApp->setLifeStatus(RunningAppSnapshot::getInstance().getLifeStatus(runningApp->getInstanceId(), LifeStatus::LifeStatus_BACKGROUND));
         RunningAppList::getInstance().add(runningApp);
     }
     RuntimeInfo::getInstance().setValue(KEY_NATIVE_RUNNING_APPS, m_nativeRunninApps);
+    removeStaleCgroups();
 }
 
-void NativeContainer::launch(RunningAppPtr runningApp, LunaTaskPtr lunaTask)
+void NativeContainer::prepare(RunningAppPtr runningApp, LunaTaskPtr lunaTask)
 {
     AppType type = runningApp->getLaunchPoint()->getAppDesc()->getAppType();
 
@@ -124,40 +161,72 @@ void NativeContainer::launch(RunningAppPtr runningApp, LunaTaskPtr lunaTask)
         params.put("preload", runningApp->getPreload());
     }
 
-    bool isNojailApp = SAMConf::getInstance().isNoJailApp(runningApp->getAppId());
-    AppType appType = runningApp->getLaunchPoint()->getAppDesc()->getAppType();
-    string path = runningApp->getLaunchPoint()->getAppDesc()->getAbsMain();
-    if (path.find("file://", 0) != string::npos)
-        path = path.substr(7);
+    const LaunchPlan& plan = getLaunchPlan(runningApp->getLaunchPoint()->getAppDesc());
+    NativeProcess& process = runningApp->getLinuxProcess();
+    process.setWorkingDirectory(plan.workingDirectory);
+    process.setCommand(plan.command);
+    for (auto it = plan.arguments.begin(); it != plan.arguments.end(); ++it) {
+        process.addArgument(*it);
+    }
+    process.addArgument(params.stringify());
+    LOG_INFO(getClassName(), __FUNCTION__, runningApp->getAppId(), "launch with " + plan.mode);
+
+    process.setEnvironmentBlock(plan.environments);
+    process.addEnv("INSTANCE_ID", runningApp->getInstanceId());
+    process.addEnv("LAUNCHPOINT_ID", runningApp->getLaunchPointId());
+    process.addEnv("DISPLAY_ID", std::to_string(runningApp->getDisplayId()));
+
+    // Warm up page cache for the main file. This is only a hint to the kernel
+    File::prefetch(plan.mainPath);
+    runningApp->setPrepared(true);
+    runningApp->markStage(LaunchStage::LaunchStage_PREPARED);
+}
+
+const NativeContainer::LaunchPlan& NativeContainer::getLaunchPlan(AppDescriptionPtr appDesc)
+{
+    auto it = m_launchPlans.find(appDesc->getAppId());
+    if (it != m_launchPlans.end() && it->second.appDesc == appDesc)
+        return it->second;
+
+    LaunchPlan& plan = m_launchPlans[appDesc->getAppId()];
+    plan = LaunchPlan();
+    plan.appDesc = appDesc;
+    plan.workingDirectory = "/";
+    plan.mainPath = appDesc->getAbsMain();
+    if (plan.mainPath.find("file://", 0) != string::npos)
+        plan.mainPath = plan.mainPath.substr(7);
+
+    map<string, string> environments = m_environments;
+    environments["APP_ID"] = appDesc->getAppId();
+    // also force the use of webos waylandinputcontext plugin
+    environments["QT_IM_MODULE"] = "wayland";
 
-    switch (appType) {
+    switch (appDesc->getAppType()) {
     case AppType::AppType_Native_AppShell:
-        runningApp->getLinuxProcess().setCommand(SAMConf::getInstance().getAppShellRunnerPath());
-        runningApp->getLinuxProcess().addArgument("--appid", runningApp->getAppId());
-        runningApp->getLinuxProcess().addArgument("--folder", runningApp->getLaunchPoint()->getAppDesc()->getFolderPath());
-        runningApp->getLinuxProcess().addArgument("--params", params.stringify());
-        Logger::info(getClassName(), __FUNCTION__, runningApp->getAppId(), "launch with appshell_runner");
+        plan.mode = "appshell_runner";
+        plan.command = SAMConf::getInstance().getAppShellRunnerPath();
+        plan.arguments = { "--appid", appDesc->getAppId(), "--folder", appDesc->getFolderPath(), "--params" };
         break;
 
     case AppType::AppType_Native_Qml:
-        runningApp->getLinuxProcess().setCommand(SAMConf::getInstance().getQmlRunnerPath());
-        runningApp->getLinuxProcess().addArgument("--appid", runningApp->getAppId());
-        runningApp->getLinuxProcess().addArgument(params.stringify());
-        Logger::info(getClassName(), __FUNCTION__, runningApp->getAppId(), "launch with qml_runner");
+        plan.mode = "qml_runner";
+        plan.command = SAMConf::getInstance().getQmlRunnerPath();
+        plan.arguments = { "--appid", appDesc->getAppId() };
+        if (appDesc->useLuneOSStyle())
+            environments["QT_QUICK_CONTROLS_STYLE"] = "QtQuick.Controls.LuneOS";
         break;
 
     default: // Native Apps
-        if (SAMConf::getInstance().isJailerDisabled() || isNojailApp) {
-            runningApp->getLinuxProcess().setWorkingDirectory(runningApp->getLaunchPoint()->getAppDesc()->getFolderPath());
-            runningApp->getLinuxProcess().setCommand(path);
-            runningApp->getLinuxProcess().addArgument(params.stringify());
-            Logger::info(getClassName(), __FUNCTION__, runningApp->getAppId(), "launch with root");
+        if (SAMConf::getInstance().isJailerDisabled() || SAMConf::getInstance().isNoJailApp(appDesc->getAppId())) {
+            plan.mode = "root";
+            plan.workingDirectory = appDesc->getFolderPath();
+            plan.command = plan.mainPath;
         } else {
             const char* jailerType = "";
-            if (AppLocation::AppLocation_Devmode == runningApp->getLaunchPoint()->getAppDesc()->getAppLocation()) {
+            if (AppLocation::AppLocation_Devmode == appDesc->getAppLocation()) {
                 jailerType = "native_devmode";
             } else {
-                switch (appType) {
+                switch (appDesc->getAppType()) {
                 case AppType::AppType_Native: {
                     jailerType = "native";
                     break;
@@ -175,51 +244,79 @@ void NativeContainer::launch(RunningAppPtr runningApp, LunaTaskPtr lunaTask)
                     break;
                 }
             }
-
-            runningApp->getLinuxProcess().setCommand(SAMConf::getInstance().getJailerPath());
-            runningApp->getLinuxProcess().addArgument("-t", jailerType);
-            runningApp->getLinuxProcess().addArgument("-i", runningApp->getAppId());
-            runningApp->getLinuxProcess().addArgument("-p", runningApp->getLaunchPoint()->getAppDesc()->getFolderPath());
-            runningApp->getLinuxProcess().addArgument(path);
-            runningApp->getLinuxProcess().addArgument(params.stringify());
-            Logger::info(getClassName(), __FUNCTION__, runningApp->getAppId(), "launch with jail");
+            plan.mode = "jail";
+            plan.command = SAMConf::getInstance().getJailerPath();
+            plan.arguments = { "-t", jailerType, "-i", appDesc->getAppId(), "-p", appDesc->getFolderPath(), plan.mainPath };
         }
+        break;
     }
+    plan.environments = NativeProcess::makeEnvironmentBlock(environments);
+    LOG_INFO(getClassName(), __FUNCTION__, appDesc->getAppId(), "Launch plan is built");
+    return plan;
+}
 
-    runningApp->getLinuxProcess().addEnv(m_environments);
-    runningApp->getLinuxProcess().addEnv("INSTANCE_ID", runningApp->getInstanceId());
-    runningApp->getLinuxProcess().addEnv("LAUNCHPOINT_ID", runningApp->getLaunchPointId());
-    runningApp->getLinuxProcess().addEnv("APP_ID", runningApp->getAppId());
-    runningApp->getLinuxProcess().addEnv("DISPLAY_ID", std::to_string(runningApp->getDisplayId()));
-    runningApp->getLinuxProcess().addEnv("LS2_NAME", Logger::format("%s-%d", runningApp->getAppId().c_str(), s_instanceCounter));
-    // also force the use of webos waylandinputcontext plugin
-    runningApp->getLinuxProcess().addEnv("QT_IM_MODULE", "wayland");
+void NativeContainer::launch(RunningAppPtr runningApp, LunaTaskPtr lunaTask)
+{
+    AppType type = runningApp->getLaunchPoint()->getAppDesc()->getAppType();
 
-    if (AppType::AppType_Native_Qml == type) {
-        if(runningApp->getLaunchPoint()->getAppDesc()->useLuneOSStyle())
-            runningApp->getLinuxProcess().addEnv("QT_QUICK_CONTROLS_STYLE", "QtQuick.Controls.LuneOS");
+    if (!runningApp->isPrepared()) {
+        prepare(runningApp, lunaTask);
     }
+    runningApp->setPrepared(false);
 
+    runningApp->getLinuxProcess().addEnv("LS2_NAME", Logger::format("%s-%d", runningApp->getAppId().c_str(), s_instanceCounter));
     runningApp->setLS2Name(Logger::format("%s-%d", runningApp->getAppId().c_str(), s_instanceCounter));
-    if (RuntimeInfo::getInstance().getUser().empty())
+    runningApp->getLinuxProcess().setCgroup(createCgroup(runningApp));
+    // Captured output is kept in memory. Otherwise, it is written to a file per launch.
+    bool isCaptured = NativeLogManager::getInstance().isEnabled();
+    if (isCaptured)
+        s_instanceCounter++;
+    else if (RuntimeInfo::getInstance().getUser().empty())
         runningApp->getLinuxProcess().openStdFile(Logger::format("/var/log/%s-%d", runningApp->getAppId().c_str(), s_instanceCounter++));
     else
         runningApp->getLinuxProcess().openStdFile(Logger::format("/var/log/%s-%s-%d", runningApp->getAppId().c_str(), RuntimeInfo::getInstance().getUser().c_str(), s_instanceCounter++));
 
     runningApp->setLifeStatus(LifeStatus::LifeStatus_LAUNCHING);
 
-    if (!runningApp->getLinuxProcess().run()) {
+    // Idle runner is already watched by RunnerPool. It forwards the exit to 'onKillChildProcess'
+    bool isHandedOver = RunnerPool::getInstance().handOver(type, runningApp->getLinuxProcess());
+    int logFd = -1;
+    if (!isHandedOver && isCaptured)
+        logFd = runningApp->getLinuxProcess().openStdPipe();
+
+    if (isHandedOver) {
+        LOG_INFO(getClassName(), __FUNCTION__, runningApp->getAppId(), "launch with idle runner");
+        if (!runningApp->getLinuxProcess().getCgroup().empty())
+            Cgroup::attach(runningApp->getLinuxProcess().getCgroup(), runningApp->getLinuxProcess().getPid());
+        if (isCaptured)
+            NativeLogManager::getInstance().reassign(runningApp->getLinuxProcess().getPid(), runningApp->getAppId());
+    } else if (runningApp->getLinuxProcess().run()) {
+        // The child process has its own copy of stdout/stderr
+        runningApp->getLinuxProcess().closeStdFd();
+        if (logFd >= 0)
+            NativeLogManager::getInstance().attach(runningApp->getAppId(), runningApp->getLinuxProcess().getPid(), logFd);
+        ProcessSupervisor::getInstance().watch(runningApp->getLinuxProcess().getPid(), onKillChildProcess, nullptr);
+        m_spawnTime.add(runningApp->getLinuxProcess().getSpawnTime());
+        LOG_INFO(getClassName(), __FUNCTION__, runningApp->getAppId(),
+                 Logger::format("Spawn Time: %lld us (%s)", runningApp->getLinuxProcess().getSpawnTime(), NativeProcess::isLightweightSpawn() ? "posix_spawn" : "g_spawn"));
+    } else {
+        runningApp->getLinuxProcess().closeStdFd();
+        if (logFd >= 0)
+            ::close(logFd);
+        if (!runningApp->getLinuxProcess().getCgroup().empty())
+            removeCgroup(runningApp->getLinuxProcess().getCgroup());
         RunningAppList::getInstance().removeByObject(runningApp);
         lunaTask->setErrCodeAndText(ErrCode_LAUNCH, "Failed to launch process");
         lunaTask->error(lunaTask);
         return;
     }
 
-    g_child_watch_add(runningApp->getLinuxProcess().getPid(), onKillChildProcess, nullptr);
     runningApp->getLinuxProcess().track();
 
-    addItem(runningApp->getInstanceId(), runningApp->getLaunchPointId(), runningApp->getProcessId(), runningApp->getDisplayId());
-    Logger::info(getClassName(), __FUNCTION__, runningApp->getAppId(), Logger::format("Launch Time: %lld ms", runningApp->getTimeStamp()));
+    addItem(runningApp->getInstanceId(), runningApp->getLaunchPointId(), runningApp->getProcessId(), runningApp->getDisplayId(), runningApp->getLinuxProcess().getCgroup());
+    runningApp->markStage(LaunchStage::LaunchStage_REQUESTED);
+    LOG_INFO(getClassName(), __FUNCTION__, runningApp->getAppId(),
+             Logger::format("Launch Time: %lld ms (%s)", runningApp->getTimeStamp(), runningApp->getStages().c_str()));
     lunaTask->success(lunaTask);
 
     // This is just guessing of app status. We need to find better way
@@ -259,6 +356,125 @@ void NativeContainer::kill(RunningAppPtr runningApp)
     runningApp->setToken(runningApp->getProcessId());
 }
 
+void NativeContainer::term(RunningAppPtr runningApp)
+{
+    if (!runningApp->getLinuxProcess().term()) {
+        kill(runningApp);
+    }
+}
+
+void NativeContainer::removeLaunchPlan(const string& appId)
+{
+    m_launchPlans.erase(appId);
+}
+
+void NativeContainer::toJson(JValue& json)
+{
+    JValue spawnTime = pbnjson::Object();
+    m_spawnTime.toJson(spawnTime);
+    json.put("spawner", NativeProcess::isLightweightSpawn() ? "posix_spawn" : "g_spawn");
+    json.put("spawnTime", spawnTime);
+    json.put("launchPlans", (int)m_launchPlans.size());
+
+    if (m_cgroupRoot.empty())
+        return;
+
+    JValue cgroups = pbnjson::Array();
+    const map<string, RunningAppPtr>& runningApps = RunningAppList::getInstance().getAll();
+    for (auto it = runningApps.begin(); it != runningApps.end(); ++it) {
+        const string& cgroup = it->second->getLinuxProcess().getCgroup();
+        if (cgroup.empty())
+            continue;
+
+        long long memory = Cgroup::getMemoryCurrent(cgroup);
+        JValue item = pbnjson::Object();
+        item.put("instanceId", it->second->getInstanceId());
+        item.put("appId", it->second->getAppId());
+        item.put("cgroup", cgroup);
+        item.put("memory", (int64_t)(memory >= 0 ? memory / 1024 : -1));
+        item.put("cpuUsage", (int64_t)Cgroup::getCpuUsage(cgroup));
+        cgroups.append(item);
+    }
+    json.put("cgroupRoot", m_cgroupRoot);
+    json.put("cgroups", cgroups);
+    json.put("staleCgroups", (int)m_staleCgroups.size());
+}
+
+void NativeContainer::initializeCgroup()
+{
+    const string& root = SAMConf::getInstance().getCgroupRoot();
+    if (root.empty())
+        return;
+
+    if (!Cgroup::create(root) || !Cgroup::isAvailable(root)) {
+        Logger::warning(getClassName(), __FUNCTION__, root, "cgroup v2 is not available. Native apps run without cgroup");
+        return;
+    }
+    // Controllers should be enabled in ancestors by the system. Without them, only containment and kill work
+    if (!Cgroup::enableControllers(root, "+memory +cpu")) {
+        Logger::warning(getClassName(), __FUNCTION__, root, "Failed to enable memory and cpu controllers");
+    }
+    m_cgroupRoot = root;
+    LOG_INFO(getClassName(), __FUNCTION__, root, "Native apps run in their own cgroups");
+}
+
+void NativeContainer::removeStaleCgroups()
+{
+    if (m_cgroupRoot.empty())
+        return;
+
+    // Leaves which are not owned by adopted apps are leftovers of the previous SAM
+    set<string> owned;
+    const map<string, RunningAppPtr>& runningApps = RunningAppList::getInstance().getAll();
+    for (auto it = runningApps.begin(); it != runningApps.end(); ++it) {
+        if (!it->second->getLinuxProcess().getCgroup().empty())
+            owned.insert(it->second->getLinuxProcess().getCgroup());
+    }
+
+    vector<string> children = Cgroup::getChildren(m_cgroupRoot);
+    for (auto it = children.begin(); it != children.end(); ++it) {
+        if (owned.count(*it) == 0)
+            removeCgroup(*it);
+    }
+}
+
+string NativeContainer::createCgroup(RunningAppPtr runningApp)
+{
+    if (m_cgroupRoot.empty())
+        return "";
+
+    // Leftovers from previous launches are retried whenever a new cgroup is needed
+    for (auto it = m_staleCgroups.begin(); it != m_staleCgroups.end();) {
+        if (Cgroup::remove(*it))
+            it = m_staleCgroups.erase(it);
+        else
+            ++it;
+    }
+
+    // LS2 name restarts with SAM. A new launch should never join the cgroup of another process.
+    string cgroup = File::join(m_cgroupRoot, runningApp->getInstanceId());
+    if (!Cgroup::create(cgroup, true))
+        return "";
+
+    int memoryLimit = runningApp->getLaunchPoint()->getAppDesc()->getMemoryLimit();
+    if (memoryLimit > 0) {
+        Cgroup::setMemoryHigh(cgroup, memoryLimit * 1024LL * 1024LL);
+    }
+    return cgroup;
+}
+
+void NativeContainer::removeCgroup(const string& cgroup)
+{
+    if (Cgroup::remove(cgroup))
+        return;
+
+    // Descendants which escaped from the process group are still alive
+    Logger::warning(getClassName(), __FUNCTION__, cgroup, "Kill remaining processes in cgroup");
+    Cgroup::kill(cgroup);
+    if (!Cgroup::remove(cgroup))
+        m_staleCgroups.insert(cgroup);
+}
+
 void NativeContainer::removeItem(GPid pid)
 {
     gsize size = getInstance().m_nativeRunninApps.arraySize();
@@ -271,13 +487,16 @@ void NativeContainer::removeItem(GPid pid)
     }
 }
 
-void NativeContainer::addItem(const string& instanceId, const string& launchPointId, const int processId, const int displayId)
+void NativeContainer::addItem(const string& instanceId, const string& launchPointId, const int processId, const int displayId, const string& cgroup)
 {
     JValue item = pbnjson::Object();
     item.put("instanceId", instanceId);
     item.put("launchPointId", launchPointId);
     item.put("processId", processId);
     item.put("displayId", displayId);
+    if (!cgroup.empty())
+        item.put("cgroup", cgroup);
+    item.put("startTime", (int64_t)ProcFs::getProcessStartTime(processId));
     m_nativeRunninApps.append(item);
     RuntimeInfo::getInstance().setValue(KEY_NATIVE_RUNNING_APPS, m_nativeRunninApps);
 }
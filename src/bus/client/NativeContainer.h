@@ -18,6 +18,7 @@
 #define BUS_CLIENT_NATIVECONTAINER_H_
 
 #include <list>
+#include <set>
 #include <memory>
 #include <vector>
 
@@ -27,6 +28,7 @@
 #include "interface/ISingleton.h"
 #include "interface/IClassName.h"
 #include "AbsLifeHandler.h"
+#include "util/Histogram.h"
 #include "util/NativeProcess.h"
 
 class NativeContainer : public ISingleton<NativeContainer>,
@@ -40,23 +42,66 @@ public:
 
     virtual void initialize();
 
+    NativeProcess::EnvironmentBlock getEnvironmentBlock()
+    {
+        return m_environmentBlock;
+    }
+
+    // Empty if native apps don't run in their own cgroups
+    const string& getCgroupRoot() const
+    {
+        return m_cgroupRoot;
+    }
+
+    // Called when AppDescription of the app is updated, rescanned or removed
+    void removeLaunchPlan(const string& appId);
+
+    void toJson(JValue& json);
+
     // AbsLifeHandler
+    virtual void prepare(RunningAppPtr runningApp, LunaTaskPtr lunaTask) override;
     virtual void launch(RunningAppPtr runningApp, LunaTaskPtr lunaTask) override;
     virtual void pause(RunningAppPtr runningApp, LunaTaskPtr lunaTask) override;
     virtual void close(RunningAppPtr runningApp, LunaTaskPtr lunaTask) override;
     virtual void kill(RunningAppPtr runningApp) override;
+    virtual void term(RunningAppPtr runningApp) override;
 
 private:
     static const string KEY_NATIVE_RUNNING_APPS;
 
     static int s_instanceCounter;
 
+    // Launch plan has everything which doesn't depend on launch parameters.
+    // AppDescriptionList removes it when AppDescription is updated, rescanned or removed.
+    struct LaunchPlan {
+        AppDescriptionPtr appDesc;
+        string mode;
+        string command;
+        string workingDirectory;
+        string mainPath;
+        vector<string> arguments;
+        NativeProcess::EnvironmentBlock environments;
+    };
+
     NativeContainer();
 
+    const LaunchPlan& getLaunchPlan(AppDescriptionPtr appDesc);
+
+    void initializeCgroup();
+    void removeStaleCgroups();
+    string createCgroup(RunningAppPtr runningApp);
+    void removeCgroup(const string& cgroup);
+
     virtual void removeItem(GPid pid);
-    virtual void addItem(const string& instanceId, const string& launchPointId, const int processId, const int displayId);
+    virtual void addItem(const string& instanceId, const string& launchPointId, const int processId, const int displayId, const string& cgroup);
 
     map<string, string> m_environments;
+    NativeProcess::EnvironmentBlock m_environmentBlock;
+    map<string, LaunchPlan> m_launchPlans;
+    string m_cgroupRoot;
+    // cgroups which couldn't be removed because escaped processes were still alive
+    set<string> m_staleCgroups;
+    Histogram m_spawnTime;
     JValue m_nativeRunninApps;
 
 };
@@ -57,7 +57,7 @@ bool Notification::onCreatePincodePrompt(LSHandle* sh, LSMessage* message, void*
 
 
     if (matched == false) {
-        Logger::info(getInstance().getClassName(), __FUNCTION__, "uninstallation is canceled because of invalid pincode");
+        LOG_INFO(getInstance().getClassName(), __FUNCTION__, "uninstallation is canceled because of invalid pincode");
     } else {
         // TODO: appId should be passed
         // AppPackageManager::getInstance().removeApp(appId, false, AppStatusChangeEvent::AppStatusChangeEvent_Uninstalled);
@@ -22,6 +22,7 @@
 #include "base/AppDescriptionList.h"
 #include "bus/service/ApplicationManager.h"
 #include "conf/SAMConf.h"
+#include "manager/Watchdog.h"
 #include "util/JValueUtil.h"
 
 SettingService::SettingService()
@@ -88,7 +89,7 @@ bool SettingService::onCheckParentalLock(LSHandle* sh, LSMessage* message, void*
     JValueUtil::getValue(responsePayload, "errorText", errorText);
 
     if (!responsePayload.hasKey("results") || !responsePayload["results"].isArray()) {
-        Logger::debug(getInstance().getClassName(), __FUNCTION__, Logger::format("result fail: %s", responsePayload.stringify().c_str()));
+        LOG_DEBUG(getInstance().getClassName(), __FUNCTION__, Logger::format("result fail: %s", responsePayload.stringify().c_str()));
         goto Done;
     }
 
@@ -108,7 +109,7 @@ bool SettingService::onCheckParentalLock(LSHandle* sh, LSMessage* message, void*
     }
 
     if (!isParentalControlValid || !isApplockPerAppValid) {
-        Logger::debug("CheckAppLockStatus", __FUNCTION__, Logger::format("receiving valid result fail: %s", responsePayload.stringify().c_str()));
+        LOG_DEBUG("CheckAppLockStatus", __FUNCTION__, Logger::format("receiving valid result fail: %s", responsePayload.stringify().c_str()));
         goto Done;
     }
 
@@ -154,6 +155,7 @@ bool SettingService::onLocaleChanged(LSHandle* sh, LSMessage* message, void* con
 {
     Message response(message);
     JValue subscriptionPayload = JDomParser::fromString(response.getPayload());
+    Watchdog::getInstance().setActivity("SettingService/onLocaleChanged");
     Logger::logSubscriptionResponse(getInstance().getClassName(), __FUNCTION__, response, subscriptionPayload);
 
     if (subscriptionPayload.isNull())
@@ -208,15 +210,15 @@ void SettingService::updateLocaleInfo(const JValue& settings)
     if (language == SAMConf::getInstance().getLanguage() &&
         script == SAMConf::getInstance().getScript() &&
         region == SAMConf::getInstance().getRegion()) {
-        Logger::info(getClassName(), __FUNCTION__, "Same localization info");
+        LOG_INFO(getClassName(), __FUNCTION__, "Same localization info");
         return;
     }
 
-    Logger::info(getClassName(), __FUNCTION__, "Changed Locale",
-                 Logger::format("language(%s=>%s) script(%s=>%s) region(%s=>%s)",
-                 SAMConf::getInstance().getLanguage().c_str(), language.c_str(),
-                 SAMConf::getInstance().getScript().c_str(), script.c_str(),
-                 SAMConf::getInstance().getRegion().c_str(), region.c_str()));
+    LOG_INFO(getClassName(), __FUNCTION__, "Changed Locale",
+             Logger::format("language(%s=>%s) script(%s=>%s) region(%s=>%s)",
+             SAMConf::getInstance().getLanguage().c_str(), language.c_str(),
+             SAMConf::getInstance().getScript().c_str(), script.c_str(),
+             SAMConf::getInstance().getRegion().c_str(), region.c_str()));
 
     SAMConf::getInstance().setLocale(language, script, region);
     AppDescriptionList::getInstance().changeLocale();
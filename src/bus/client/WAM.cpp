@@ -19,12 +19,18 @@
 #include "base/LaunchPointList.h"
 #include "base/LunaTaskList.h"
 #include "base/RunningAppList.h"
+#include "manager/ApiMetrics.h"
+#include "manager/RunningAppSnapshot.h"
+#include "util/Tracer.h"
 
 bool WAM::onListRunningApps(LSHandle* sh, LSMessage* message, void* context)
 {
     Message response(message);
     JValue subscriptionPayload = JDomParser::fromString(response.getPayload());
+    static int metric = ApiMetrics::getInstance().addCall(string("luna://") + getInstance().getName() + string("/listRunningApps"));
     Logger::logSubscriptionResponse(getInstance().getClassName(), __FUNCTION__, response, subscriptionPayload);
+    ApiMetrics::getInstance().onSubscriptionResponse(metric, message, subscriptionPayload);
+    TRACE_SCOPE("response", __FUNCTION__, nullptr, 0);
 
     if (response.isHubError()) {
         return false;
@@ -73,6 +79,7 @@ bool WAM::onListRunningApps(LSHandle* sh, LSMessage* message, void* context)
         runningApp->setContext(CONTEXT_RUNNING);
     }
     RunningAppList::getInstance().removeAllByConext(AppType::AppType_Web, CONTEXT_STOP);
+    RunningAppSnapshot::getInstance().onWebAppsReconciled();
     return true;
 }
 
@@ -119,6 +126,10 @@ void WAM::onServerStatusChanged(bool isConnected)
         // Sometimes, app launching request is already in LS2 queue before WAM running
         if (m_serverStatusCount > 1) {
             RunningAppList::getInstance().removeAllByType(AppType::AppType_Web);
+        } else {
+            // Web apps restored from the snapshot are not running without WAM
+            RunningAppList::getInstance().removeAllByConext(AppType::AppType_Web, CONTEXT_STOP);
+            RunningAppSnapshot::getInstance().onWebAppsReconciled();
         }
     }
 }
@@ -128,6 +139,8 @@ bool WAM::onLaunchApp(LSHandle* sh, LSMessage* message, void* context)
     Message response(message);
     JValue responsePayload = pbnjson::JDomParser::fromString(response.getPayload());
     Logger::logCallResponse(getInstance().getClassName(), __FUNCTION__, response, responsePayload);
+    unsigned long traceId = ApiMetrics::getInstance().onCallResponse(message, responsePayload);
+    TRACE_SCOPE("response", __FUNCTION__, nullptr, traceId);
 
     if (response.isHubError()) {
         return false;
@@ -170,24 +183,16 @@ bool WAM::onLaunchApp(LSHandle* sh, LSMessage* message, void* context)
     }
 
     lunaTask->success(lunaTask);
-    Logger::info(getInstance().getClassName(), __FUNCTION__, runningApp->getAppId(), Logger::format("Launch Time: %lld ms", runningApp->getTimeStamp()));
+    runningApp->markStage(LaunchStage::LaunchStage_ACKED);
+    LOG_INFO(getInstance().getClassName(), __FUNCTION__, runningApp->getAppId(),
+             Logger::format("Launch Time: %lld ms (%s)", runningApp->getTimeStamp(), runningApp->getStages().c_str()));
     return true;
 }
 
-void WAM::launch(RunningAppPtr runningApp, LunaTaskPtr lunaTask)
+void WAM::prepare(RunningAppPtr runningApp, LunaTaskPtr lunaTask)
 {
-    static string method = string("luna://") + getName() + string("/launchApp");
-    JValue requestPayload = pbnjson::Object();
-
-    if (!isConnected()) {
-        Logger::info(getClassName(), __FUNCTION__, "WAM is not running. Waiting for WAM wakes up...");
-    }
-
-    // We don't need to launch again if it requires 'LaunchedHidden'
-    if (!runningApp->isFirstLaunch() && lunaTask->isLaunchedHidden()) {
-        lunaTask->success(lunaTask);
-        return;
-    }
+    JValue& requestPayload = runningApp->getPreparedPayload();
+    requestPayload = pbnjson::Object();
 
     JValue appDesc = pbnjson::Object();
     runningApp->getLaunchPoint()->toJson(appDesc);
@@ -209,19 +214,49 @@ void WAM::launch(RunningAppPtr runningApp, LunaTaskPtr lunaTask)
     }
 
     if (runningApp->isFirstLaunch() && !runningApp->getPreload().empty()) {
-        runningApp->setLifeStatus(LifeStatus::LifeStatus_PRELOADING);
         requestPayload.put("preload", runningApp->getPreload());
+    }
+    runningApp->setPrepared(true);
+    runningApp->markStage(LaunchStage::LaunchStage_PREPARED);
+}
+
+void WAM::launch(RunningAppPtr runningApp, LunaTaskPtr lunaTask)
+{
+    static string method = string("luna://") + getName() + string("/launchApp");
+    static int metric = ApiMetrics::getInstance().addCall(method);
+
+    if (!isConnected()) {
+        LOG_INFO(getClassName(), __FUNCTION__, "WAM is not running. Waiting for WAM wakes up...");
+    }
+
+    // We don't need to launch again if it requires 'LaunchedHidden'
+    if (!runningApp->isFirstLaunch() && lunaTask->isLaunchedHidden()) {
+        lunaTask->success(lunaTask);
+        return;
+    }
+
+    // Prepared payload is consumed here. Relaunch prepares again with its own request
+    if (!runningApp->isPrepared()) {
+        prepare(runningApp, lunaTask);
+    }
+    runningApp->setPrepared(false);
+    JValue requestPayload = runningApp->getPreparedPayload();
+    runningApp->getPreparedPayload() = JValue();
+
+    if (requestPayload.hasKey("preload")) {
+        runningApp->setLifeStatus(LifeStatus::LifeStatus_PRELOADING);
     } else {
         runningApp->setLifeStatus(LifeStatus::LifeStatus_LAUNCHING);
     }
 
     LSErrorSafe error;
     LSMessageToken token = 0;
+    string payload = requestPayload.stringify();
     Logger::logCallRequest(getClassName(), __FUNCTION__, method, requestPayload);
     if (!LSCallOneReply(
         ApplicationManager::getInstance().get(),
         method.c_str(),
-        requestPayload.stringify().c_str(),
+        payload.c_str(),
         onLaunchApp,
         nullptr,
         &token,
@@ -232,8 +267,10 @@ void WAM::launch(RunningAppPtr runningApp, LunaTaskPtr lunaTask)
         lunaTask->error(lunaTask);
         return;
     }
+    ApiMetrics::getInstance().onCallRequest(metric, token, payload.length());
     lunaTask->setToken(token);
     runningApp->setToken(token);
+    runningApp->markStage(LaunchStage::LaunchStage_REQUESTED);
 }
 
 void WAM::close(RunningAppPtr runningApp, LunaTaskPtr lunaTask)
@@ -244,6 +281,13 @@ void WAM::close(RunningAppPtr runningApp, LunaTaskPtr lunaTask)
         return;
     }
 
+    // SAM itself reclaims memory (e.g. resident app budget)
+    bool force = false;
+    if (!lunaTask->isExternal() && JValueUtil::getValue(lunaTask->getRequestPayload(), "force", force) && force) {
+        killApp(runningApp, lunaTask);
+        return;
+    }
+
     if (runningApp->isKeepAlive()) {
         pause(runningApp, lunaTask);
     } else {
@@ -261,6 +305,8 @@ bool WAM::onPauseApp(LSHandle* sh, LSMessage* message, void* context)
     Message response(message);
     JValue responsePayload = pbnjson::JDomParser::fromString(response.getPayload());
     Logger::logCallResponse(getInstance().getClassName(), __FUNCTION__, response, responsePayload);
+    unsigned long traceId = ApiMetrics::getInstance().onCallResponse(message, responsePayload);
+    TRACE_SCOPE("response", __FUNCTION__, nullptr, traceId);
 
     if (response.isHubError()) {
         return false;
@@ -304,6 +350,7 @@ bool WAM::onPauseApp(LSHandle* sh, LSMessage* message, void* context)
 void WAM::pause(RunningAppPtr runningApp, LunaTaskPtr lunaTask)
 {
     static string method = string("luna://") + getName() + string("/pauseApp");
+    static int metric = ApiMetrics::getInstance().addCall(method);
 
     if (!isConnected()) {
         lunaTask->setErrCodeAndText(ErrCode_GENERAL, "WAM is not running. The app is not exist");
@@ -320,11 +367,12 @@ void WAM::pause(RunningAppPtr runningApp, LunaTaskPtr lunaTask)
 
     LSErrorSafe error;
     LSMessageToken token = 0;
+    string payload = requestPayload.stringify();
     Logger::logCallRequest(getClassName(), __FUNCTION__, method, requestPayload);
     if (!LSCallOneReply(
         ApplicationManager::getInstance().get(),
         method.c_str(),
-        requestPayload.stringify().c_str(),
+        payload.c_str(),
         onPauseApp,
         nullptr,
         &token,
@@ -334,6 +382,7 @@ void WAM::pause(RunningAppPtr runningApp, LunaTaskPtr lunaTask)
         lunaTask->error(lunaTask);
         return;
     }
+    ApiMetrics::getInstance().onCallRequest(metric, token, payload.length());
     lunaTask->setToken(token);
     runningApp->setToken(token);
 }
@@ -343,6 +392,8 @@ bool WAM::onKillApp(LSHandle* sh, LSMessage* message, void* context)
     Message response(message);
     JValue responsePayload = pbnjson::JDomParser::fromString(response.getPayload());
     Logger::logCallResponse(getInstance().getClassName(), __FUNCTION__, response, responsePayload);
+    unsigned long traceId = ApiMetrics::getInstance().onCallResponse(message, responsePayload);
+    TRACE_SCOPE("response", __FUNCTION__, nullptr, traceId);
 
     if (response.isHubError()) {
         return false;
@@ -383,6 +434,7 @@ bool WAM::onKillApp(LSHandle* sh, LSMessage* message, void* context)
 void WAM::killApp(RunningAppPtr runningApp, LunaTaskPtr lunaTask)
 {
     static string method = string("luna://") + getName() + string("/killApp");
+    static int metric = ApiMetrics::getInstance().addCall(method);
     JValue requestPayload = pbnjson::Object();
 
     if (!isConnected()) {
@@ -403,17 +455,20 @@ void WAM::killApp(RunningAppPtr runningApp, LunaTaskPtr lunaTask)
     LSErrorSafe error;
     bool result = true;
     LSMessageToken token = 0;
+    string payload = requestPayload.stringify();
     Logger::logCallRequest(getClassName(), __FUNCTION__, method, requestPayload);
     result = LSCallOneReply(
         ApplicationManager::getInstance().get(),
         method.c_str(),
-        requestPayload.stringify().c_str(),
+        payload.c_str(),
         onKillApp,
         nullptr,
         &token,
         &error
     );
     runningApp->setToken(token);
+    if (result)
+        ApiMetrics::getInstance().onCallRequest(metric, token, payload.length());
 
     if (lunaTask) {
         if (!result) {
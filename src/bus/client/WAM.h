@@ -39,6 +39,7 @@ public:
     virtual ~WAM();
 
     // AbsLifeHandler
+    void prepare(RunningAppPtr runningApp, LunaTaskPtr lunaTask) override;
     void launch(RunningAppPtr runningApp, LunaTaskPtr lunaTask) override;
     void pause(RunningAppPtr runningApp, LunaTaskPtr lunaTask) override;
     void close(RunningAppPtr runningApp, LunaTaskPtr lunaTask) override;
@@ -26,19 +26,40 @@
 #include "bus/client/AppInstallService.h"
 #include "bus/client/DB8.h"
 #include "bus/client/LSM.h"
+#include "bus/client/NativeContainer.h"
+#include "conf/Persistence.h"
 #include "conf/SAMConf.h"
+#include "manager/ApiMetrics.h"
+#include "manager/BatchLauncher.h"
+#include "manager/BulkTerminator.h"
+#include "manager/FlightRecorder.h"
+#include "manager/LaunchStatistics.h"
+#include "manager/MemoryAccounting.h"
+#include "manager/MemoryEstimator.h"
+#include "manager/NativeLogManager.h"
 #include "manager/PolicyManager.h"
+#include "manager/PreloadManager.h"
+#include "manager/ProcessSupervisor.h"
+#include "manager/ResidentAppManager.h"
+#include "manager/ResourceSampler.h"
+#include "manager/RunnerPool.h"
+#include "manager/RunningAppSnapshot.h"
+#include "manager/TransitionTimer.h"
+#include "manager/Watchdog.h"
 #include "SchemaChecker.h"
 #include "util/JValueUtil.h"
 #include "util/Time.h"
+#include "util/Tracer.h"
 
 const char* ApplicationManager::CATEGORY_ROOT = "/";
 const char* ApplicationManager::CATEGORY_DEV = "/dev";
 
 const char* ApplicationManager::METHOD_LAUNCH = "launch";
+const char* ApplicationManager::METHOD_LAUNCH_BATCH = "launchBatch";
 const char* ApplicationManager::METHOD_PAUSE = "pause";
 const char* ApplicationManager::METHOD_CLOSE = "close";
 const char* ApplicationManager::METHOD_CLOSE_BY_APPID = "closeByAppId";
+const char* ApplicationManager::METHOD_CLOSE_BATCH = "closeBatch";
 const char* ApplicationManager::METHOD_RUNNING = "running";
 const char* ApplicationManager::METHOD_GET_APP_LIFE_EVENTS ="getAppLifeEvents";
 const char* ApplicationManager::METHOD_GET_APP_LIFE_STATUS = "getAppLifeStatus";
@@ -46,6 +67,7 @@ const char* ApplicationManager::METHOD_GET_FOREGROUND_APPINFO = "getForegroundAp
 const char* ApplicationManager::METHOD_LOCK_APP = "lockApp";
 const char* ApplicationManager::METHOD_REGISTER_APP = "registerApp";
 const char* ApplicationManager::METHOD_REGISTER_NATIVE_APP = "registerNativeApp";
+const char* ApplicationManager::METHOD_GET_RESOURCE_USAGE = "getResourceUsage";
 
 const char* ApplicationManager::METHOD_LIST_APPS = "listApps";
 const char* ApplicationManager::METHOD_GET_APP_STATUS = "getAppStatus";
@@ -58,12 +80,19 @@ const char* ApplicationManager::METHOD_REMOVE_LAUNCHPOINT = "removeLaunchPoint";
 const char* ApplicationManager::METHOD_LIST_LAUNCHPOINTS = "listLaunchPoints";
 
 const char* ApplicationManager::METHOD_MANAGER_INFO = "managerInfo";
+const char* ApplicationManager::METHOD_GET_LAUNCH_STATISTICS = "getLaunchStatistics";
+const char* ApplicationManager::METHOD_GET_APP_LOGS = "getAppLogs";
+const char* ApplicationManager::METHOD_MEMORY = "memory";
+const char* ApplicationManager::METHOD_METRICS = "metrics";
+const char* ApplicationManager::METHOD_TRACE = "trace";
 
 LSMethod ApplicationManager::METHODS_ROOT[] = {
     { METHOD_LAUNCH,                   ApplicationManager::onAPICalled, LUNA_METHOD_FLAGS_NONE },
+    { METHOD_LAUNCH_BATCH,             ApplicationManager::onAPICalled, LUNA_METHOD_FLAGS_NONE },
     { METHOD_PAUSE,                    ApplicationManager::onAPICalled, LUNA_METHOD_FLAGS_NONE },
     { METHOD_CLOSE,                    ApplicationManager::onAPICalled, LUNA_METHOD_FLAGS_NONE },
     { METHOD_CLOSE_BY_APPID,           ApplicationManager::onAPICalled, LUNA_METHOD_FLAGS_NONE },
+    { METHOD_CLOSE_BATCH,              ApplicationManager::onAPICalled, LUNA_METHOD_FLAGS_NONE },
     { METHOD_RUNNING,                  ApplicationManager::onAPICalled, LUNA_METHOD_FLAGS_NONE },
     { METHOD_GET_APP_LIFE_EVENTS,      ApplicationManager::onAPICalled, LUNA_METHOD_FLAGS_NONE },
     { METHOD_GET_APP_LIFE_STATUS,      ApplicationManager::onAPICalled, LUNA_METHOD_FLAGS_NONE },
@@ -71,6 +100,7 @@ LSMethod ApplicationManager::METHODS_ROOT[] = {
     { METHOD_LOCK_APP,                 ApplicationManager::onAPICalled, LUNA_METHOD_FLAGS_NONE },
     { METHOD_REGISTER_APP,             ApplicationManager::onAPICalled, LUNA_METHOD_FLAGS_NONE },
     { METHOD_REGISTER_NATIVE_APP,      ApplicationManager::onAPICalled, LUNA_METHOD_FLAGS_NONE },
+    { METHOD_GET_RESOURCE_USAGE,       ApplicationManager::onAPICalled, LUNA_METHOD_FLAGS_NONE },
 
     // core: package
     { METHOD_LIST_APPS,                ApplicationManager::onAPICalled, LUNA_METHOD_FLAGS_NONE },
@@ -92,18 +122,29 @@ LSMethod ApplicationManager::METHODS_DEV[] = {
     { METHOD_LIST_APPS,                ApplicationManager::onAPICalled, LUNA_METHOD_FLAGS_NONE },
     { METHOD_RUNNING,                  ApplicationManager::onAPICalled, LUNA_METHOD_FLAGS_NONE },
     { METHOD_MANAGER_INFO,             ApplicationManager::onAPICalled, LUNA_METHOD_FLAGS_NONE },
+    { METHOD_GET_LAUNCH_STATISTICS,    ApplicationManager::onAPICalled, LUNA_METHOD_FLAGS_NONE },
+    { METHOD_GET_APP_LOGS,             ApplicationManager::onAPICalled, LUNA_METHOD_FLAGS_NONE },
+    { METHOD_MEMORY,                   ApplicationManager::onAPICalled, LUNA_METHOD_FLAGS_NONE },
+    { METHOD_METRICS,                  ApplicationManager::onAPICalled, LUNA_METHOD_FLAGS_NONE },
+    { METHOD_TRACE,                    ApplicationManager::onAPICalled, LUNA_METHOD_FLAGS_NONE },
     { 0,                               0,                               LUNA_METHOD_FLAGS_NONE }
 };
 
 bool ApplicationManager::onAPICalled(LSHandle* sh, LSMessage* message, void* ctx)
 {
+    long long receivedTime = Time::getCurrentTime();
     Message request(message);
     JValue requestPayload = SchemaChecker::getInstance().getRequestPayloadWithSchema(request);
+    long long schemaCheckedTime = Time::getCurrentTime();
     LunaApiHandler handler;
     LunaTaskPtr lunaTask = nullptr;
     string errorText = "";
     int errorCode = 0;
 
+    Watchdog::getInstance().setActivity(request.getKind());
+    int metric = ApiMetrics::getInstance().getSlot(ctx, request.getMethod());
+    ApiMetrics::getInstance().onRequest(metric, strlen(request.getPayload()));
+
     Logger::logAPIRequest(getInstance().getClassName(), __FUNCTION__, request, requestPayload);
     if (requestPayload.isNull()) {
         errorCode = ErrCode_INVALID_PAYLOAD;
@@ -117,6 +158,9 @@ bool ApplicationManager::onAPICalled(LSHandle* sh, LSMessage* message, void* ctx
         errorText = "memory alloc fail";
         goto Done;
     }
+    lunaTask->setReceivedTime(receivedTime);
+    lunaTask->setSchemaCheckedTime(schemaCheckedTime);
+    lunaTask->setMetric(metric);
 
     if (getInstance().m_APIHandlers.find(request.getKind()) != getInstance().m_APIHandlers.end())
         handler = getInstance().m_APIHandlers[request.getKind()];
@@ -133,7 +177,10 @@ bool ApplicationManager::onAPICalled(LSHandle* sh, LSMessage* message, void* ctx
     }
 
     LunaTaskList::getInstance().add(lunaTask);
-    handler(lunaTask);
+    {
+        TRACE_SCOPE("api", request.getKind(), lunaTask->getCaller().c_str(), lunaTask->getTraceId());
+        handler(lunaTask);
+    }
 
 Done:
     if (!errorText.empty()) {
@@ -141,7 +188,9 @@ Done:
         responsePayload.put("returnValue", false);
         responsePayload.put("errorText", errorText);
         responsePayload.put("errorCode", errorCode);
-        request.respond(responsePayload.stringify().c_str());
+        string response = responsePayload.stringify();
+        request.respond(response.c_str());
+        ApiMetrics::getInstance().onResponse(metric, receivedTime, response.length(), errorCode);
     }
     return true;
 }
@@ -149,15 +198,19 @@ Done:
 ApplicationManager::ApplicationManager()
     : LS::Handle(LS::registerService("com.webos.applicationManager")),
       m_enableSubscription(false),
+      m_runningPostDeferral(0),
+      m_isRunningPostPending(false),
       m_compat1("com.webos.service.applicationmanager"),
       m_compat2("com.webos.service.applicationManager")
 {
     setClassName("ApplicationManager");
 
     registerApiHandler(CATEGORY_ROOT, METHOD_LAUNCH, boost::bind(&ApplicationManager::launch, this, boost::placeholders::_1));
+    registerApiHandler(CATEGORY_ROOT, METHOD_LAUNCH_BATCH, boost::bind(&ApplicationManager::launchBatch, this, boost::placeholders::_1));
     registerApiHandler(CATEGORY_ROOT, METHOD_PAUSE, boost::bind(&ApplicationManager::pause, this, boost::placeholders::_1));
     registerApiHandler(CATEGORY_ROOT, METHOD_CLOSE, boost::bind(&ApplicationManager::close, this, boost::placeholders::_1));
     registerApiHandler(CATEGORY_ROOT, METHOD_CLOSE_BY_APPID, boost::bind(&ApplicationManager::close, this, boost::placeholders::_1));
+    registerApiHandler(CATEGORY_ROOT, METHOD_CLOSE_BATCH, boost::bind(&ApplicationManager::closeBatch, this, boost::placeholders::_1));
     registerApiHandler(CATEGORY_ROOT, METHOD_RUNNING, boost::bind(&ApplicationManager::running, this, boost::placeholders::_1));
     registerApiHandler(CATEGORY_ROOT, METHOD_GET_APP_LIFE_EVENTS, boost::bind(&ApplicationManager::getAppLifeEvents, this, boost::placeholders::_1));
     registerApiHandler(CATEGORY_ROOT, METHOD_GET_APP_LIFE_STATUS, boost::bind(&ApplicationManager::getAppLifeStatus, this, boost::placeholders::_1));
@@ -166,6 +219,7 @@ ApplicationManager::ApplicationManager()
     registerApiHandler(CATEGORY_ROOT, METHOD_LOCK_APP, boost::bind(&ApplicationManager::lockApp, this, boost::placeholders::_1));
     registerApiHandler(CATEGORY_ROOT, METHOD_REGISTER_APP, boost::bind(&ApplicationManager::registerApp, this, boost::placeholders::_1));
     registerApiHandler(CATEGORY_ROOT, METHOD_REGISTER_NATIVE_APP, boost::bind(&ApplicationManager::registerApp, this, boost::placeholders::_1));
+    registerApiHandler(CATEGORY_ROOT, METHOD_GET_RESOURCE_USAGE, boost::bind(&ApplicationManager::getResourceUsage, this, boost::placeholders::_1));
 
     registerApiHandler(CATEGORY_ROOT, METHOD_LIST_APPS, boost::bind(&ApplicationManager::listApps, this, boost::placeholders::_1));
     registerApiHandler(CATEGORY_ROOT, METHOD_GET_APP_STATUS, boost::bind(&ApplicationManager::getAppStatus, this, boost::placeholders::_1));
@@ -182,6 +236,11 @@ ApplicationManager::ApplicationManager()
     registerApiHandler(CATEGORY_DEV, METHOD_LIST_APPS, boost::bind(&ApplicationManager::listApps, this, boost::placeholders::_1));
     registerApiHandler(CATEGORY_DEV, METHOD_RUNNING, boost::bind(&ApplicationManager::running, this, boost::placeholders::_1));
     registerApiHandler(CATEGORY_DEV, METHOD_MANAGER_INFO, boost::bind(&ApplicationManager::managerInfo, this, boost::placeholders::_1));
+    registerApiHandler(CATEGORY_DEV, METHOD_GET_LAUNCH_STATISTICS, boost::bind(&ApplicationManager::getLaunchStatistics, this, boost::placeholders::_1));
+    registerApiHandler(CATEGORY_DEV, METHOD_GET_APP_LOGS, boost::bind(&ApplicationManager::getAppLogs, this, boost::placeholders::_1));
+    registerApiHandler(CATEGORY_DEV, METHOD_MEMORY, boost::bind(&ApplicationManager::memory, this, boost::placeholders::_1));
+    registerApiHandler(CATEGORY_DEV, METHOD_METRICS, boost::bind(&ApplicationManager::metrics, this, boost::placeholders::_1));
+    registerApiHandler(CATEGORY_DEV, METHOD_TRACE, boost::bind(&ApplicationManager::trace, this, boost::placeholders::_1));
 }
 
 ApplicationManager::~ApplicationManager()
@@ -194,11 +253,13 @@ bool ApplicationManager::attach(GMainLoop* gml)
         this->registerCategory(CATEGORY_ROOT, METHODS_ROOT, nullptr, nullptr);
         m_compat1.registerCategory(CATEGORY_ROOT, METHODS_ROOT, nullptr, nullptr);
         m_compat2.registerCategory(CATEGORY_ROOT, METHODS_ROOT, nullptr, nullptr);
+        registerMetrics(CATEGORY_ROOT, METHODS_ROOT);
 
         if (SAMConf::getInstance().isDevmodeEnabled()) {
             this->registerCategory(CATEGORY_DEV, METHODS_DEV, nullptr, nullptr);
             m_compat1.registerCategory(CATEGORY_DEV, METHODS_DEV, nullptr, nullptr);
             m_compat2.registerCategory(CATEGORY_DEV, METHODS_DEV, nullptr, nullptr);
+            registerMetrics(CATEGORY_DEV, METHODS_DEV);
         }
 
         m_getAppLifeEvents = new LS::SubscriptionPoint();               m_getAppLifeEvents->setServiceHandle(this);
@@ -212,6 +273,8 @@ bool ApplicationManager::attach(GMainLoop* gml)
         m_listDevAppsCompactPoint = new LS::SubscriptionPoint();        m_listDevAppsCompactPoint->setServiceHandle(this);
         m_running = new LS::SubscriptionPoint();                        m_running->setServiceHandle(this);
         m_runningDev = new LS::SubscriptionPoint();                     m_runningDev->setServiceHandle(this);
+        m_getAppLifeStatusUsage = new LS::SubscriptionPoint();          m_getAppLifeStatusUsage->setServiceHandle(this);
+        m_runningUsage = new LS::SubscriptionPoint();                   m_runningUsage->setServiceHandle(this);
 
         this->attachToLoop(gml);
         m_compat1.attachToLoop(gml);
@@ -221,6 +284,13 @@ bool ApplicationManager::attach(GMainLoop* gml)
     return true;
 }
 
+void ApplicationManager::registerMetrics(const char* category, LSMethod* methods)
+{
+    this->setCategoryData(category, ApiMetrics::getInstance().addCategory(this->getName(), category, methods));
+    m_compat1.setCategoryData(category, ApiMetrics::getInstance().addCategory(m_compat1.getName(), category, methods));
+    m_compat2.setCategoryData(category, ApiMetrics::getInstance().addCategory(m_compat2.getName(), category, methods));
+}
+
 void ApplicationManager::detach()
 {
     m_APIHandlers.clear();
@@ -236,6 +306,8 @@ void ApplicationManager::detach()
     delete m_listDevAppsCompactPoint;
     delete m_running;
     delete m_runningDev;
+    delete m_getAppLifeStatusUsage;
+    delete m_runningUsage;
 
     Handle::detach();
     m_compat1.detach();
@@ -279,6 +351,11 @@ void ApplicationManager::launch(LunaTaskPtr lunaTask)
     PolicyManager::getInstance().launch(lunaTask);
 }
 
+void ApplicationManager::launchBatch(LunaTaskPtr lunaTask)
+{
+    BatchLauncher::getInstance().launch(lunaTask);
+}
+
 void ApplicationManager::pause(LunaTaskPtr lunaTask)
 {
     RunningAppPtr runningApp = RunningAppList::getInstance().getByLunaTask(lunaTask);
@@ -308,16 +385,25 @@ void ApplicationManager::close(LunaTaskPtr lunaTask)
     return;
 }
 
+void ApplicationManager::closeBatch(LunaTaskPtr lunaTask)
+{
+    BulkTerminator::getInstance().close(lunaTask);
+}
+
 void ApplicationManager::running(LunaTaskPtr lunaTask)
 {
     bool subscribed = false;
+    bool resourceUsage = false;
 
-    makeRunning(lunaTask->getResponsePayload(), lunaTask->isDevmodeRequest());
+    JValueUtil::getValue(lunaTask->getRequestPayload(), "resourceUsage", resourceUsage);
+    makeRunning(lunaTask->getResponsePayload(), lunaTask->isDevmodeRequest(), resourceUsage);
     lunaTask->getResponsePayload().put("returnValue", true);
 
     if (lunaTask->getRequest().isSubscription()) {
         if (lunaTask->isDevmodeRequest()) {
             subscribed = m_runningDev->subscribe(lunaTask->getRequest());
+        } else if (resourceUsage) {
+            subscribed = m_runningUsage->subscribe(lunaTask->getRequest());
         } else {
             subscribed = m_running->subscribe(lunaTask->getRequest());
         }
@@ -346,6 +432,8 @@ void ApplicationManager::getAppLifeEvents(LunaTaskPtr lunaTask)
 
 void ApplicationManager::getAppLifeStatus(LunaTaskPtr lunaTask)
 {
+    bool resourceUsage = false;
+
     if (!lunaTask->getRequest().isSubscription()) {
         lunaTask->getResponsePayload().put("subscribed", false);
         lunaTask->setErrCodeAndText(ErrCode_GENERAL, "subscription is required");
@@ -353,7 +441,9 @@ void ApplicationManager::getAppLifeStatus(LunaTaskPtr lunaTask)
         return;
     }
 
-    if (!m_getAppLifeStatus->subscribe(lunaTask->getRequest())) {
+    JValueUtil::getValue(lunaTask->getRequestPayload(), "resourceUsage", resourceUsage);
+    LS::SubscriptionPoint* point = resourceUsage ? m_getAppLifeStatusUsage : m_getAppLifeStatus;
+    if (!point->subscribe(lunaTask->getRequest())) {
         lunaTask->setErrCodeAndText(ErrCode_GENERAL, "Subscription failed");
         lunaTask->getResponsePayload().put("subscribed", false);
     } else {
@@ -400,7 +490,7 @@ void ApplicationManager::lockApp(LunaTaskPtr lunaTask)
         return;
     }
 
-    Logger::info(getClassName(), __FUNCTION__, appId, Logger::format("lock(%s)", Logger::toString(lock)));
+    LOG_INFO(getClassName(), __FUNCTION__, appId, Logger::format("lock(%s)", Logger::toString(lock)));
     if (lock)
         appDesc->lock();
     else
@@ -431,6 +521,51 @@ void ApplicationManager::registerApp(LunaTaskPtr lunaTask)
     // You don't need to reply here
 }
 
+void ApplicationManager::getResourceUsage(LunaTaskPtr lunaTask)
+{
+    const JValue& requestPayload = lunaTask->getRequestPayload();
+    string instanceId = "";
+    string appId = "";
+
+    JValueUtil::getValue(requestPayload, "instanceId", instanceId);
+    JValueUtil::getValue(requestPayload, "appId", appId);
+
+    if (!ResourceSampler::getInstance().isEnabled()) {
+        lunaTask->setErrCodeAndText(ErrCode_GENERAL, "ResourceSampler is disabled");
+        LunaTaskList::getInstance().removeAfterReply(lunaTask);
+        return;
+    }
+
+    JValue apps = pbnjson::Array();
+    const map<string, RunningAppPtr>& runningApps = RunningAppList::getInstance().getAll();
+    for (auto it = runningApps.begin(); it != runningApps.end(); ++it) {
+        if (!instanceId.empty() && it->second->getInstanceId() != instanceId)
+            continue;
+        if (!appId.empty() && it->second->getAppId() != appId)
+            continue;
+
+        JValue app = pbnjson::Object();
+        JValue resourceUsage = pbnjson::Object();
+        app.put("instanceId", it->second->getInstanceId());
+        app.put("appId", it->second->getAppId());
+        app.put("processid", std::to_string(it->second->getProcessId()));
+        if (ResourceSampler::getInstance().toJson(it->second->getInstanceId(), resourceUsage))
+            app.put("resourceUsage", resourceUsage);
+        apps.append(app);
+    }
+
+    if ((!instanceId.empty() || !appId.empty()) && apps.arraySize() == 0) {
+        lunaTask->setErrCodeAndText(ErrCode_GENERAL, "Cannot find running app");
+        LunaTaskList::getInstance().removeAfterReply(lunaTask);
+        return;
+    }
+
+    lunaTask->getResponsePayload().put("apps", apps);
+    lunaTask->getResponsePayload().put("interval", SAMConf::getInstance().getResourceSamplingInterval());
+    lunaTask->getResponsePayload().put("returnValue", true);
+    LunaTaskList::getInstance().removeAfterReply(lunaTask);
+}
+
 void ApplicationManager::listApps(LunaTaskPtr lunaTask)
 {
     pbnjson::JValue apps = pbnjson::Array();
@@ -663,12 +798,195 @@ void ApplicationManager::managerInfo(LunaTaskPtr lunaTask)
     LunaTaskList::getInstance().toJson(lunaTasks);
     lunaTask->getResponsePayload().put("lunaTasks", lunaTasks);
 
+    pbnjson::JValue nativeContainer = pbnjson::Object();
+    NativeContainer::getInstance().toJson(nativeContainer);
+    lunaTask->getResponsePayload().put("nativeContainer", nativeContainer);
+
+    pbnjson::JValue runnerPool = pbnjson::Object();
+    RunnerPool::getInstance().toJson(runnerPool);
+    lunaTask->getResponsePayload().put("runnerPool", runnerPool);
+
+    pbnjson::JValue memoryEstimator = pbnjson::Object();
+    MemoryEstimator::getInstance().toJson(memoryEstimator);
+    lunaTask->getResponsePayload().put("memoryEstimator", memoryEstimator);
+
+    pbnjson::JValue preloadManager = pbnjson::Object();
+    PreloadManager::getInstance().toJson(preloadManager);
+    lunaTask->getResponsePayload().put("preloadManager", preloadManager);
+
+    pbnjson::JValue processSupervisor = pbnjson::Object();
+    ProcessSupervisor::getInstance().toJson(processSupervisor);
+    lunaTask->getResponsePayload().put("processSupervisor", processSupervisor);
+
+    pbnjson::JValue bulkTerminator = pbnjson::Object();
+    BulkTerminator::getInstance().toJson(bulkTerminator);
+    lunaTask->getResponsePayload().put("bulkTerminator", bulkTerminator);
+
+    pbnjson::JValue transitionTimer = pbnjson::Object();
+    TransitionTimer::getInstance().toJson(transitionTimer);
+    lunaTask->getResponsePayload().put("transitionTimer", transitionTimer);
+
+    pbnjson::JValue residentAppManager = pbnjson::Object();
+    ResidentAppManager::getInstance().toJson(residentAppManager);
+    lunaTask->getResponsePayload().put("residentAppManager", residentAppManager);
+
+    pbnjson::JValue runningAppSnapshot = pbnjson::Object();
+    RunningAppSnapshot::getInstance().toJson(runningAppSnapshot);
+    lunaTask->getResponsePayload().put("runningAppSnapshot", runningAppSnapshot);
+
+    pbnjson::JValue db8 = pbnjson::Object();
+    DB8::getInstance().toJson(db8);
+    lunaTask->getResponsePayload().put("db8", db8);
+
+    pbnjson::JValue persistence = pbnjson::Object();
+    Persistence::getInstance().toJson(persistence);
+    lunaTask->getResponsePayload().put("persistence", persistence);
+
+    pbnjson::JValue logger = pbnjson::Object();
+    Logger::getInstance().toJson(logger);
+    lunaTask->getResponsePayload().put("logger", logger);
+
+    pbnjson::JValue nativeLogManager = pbnjson::Object();
+    NativeLogManager::getInstance().toJson(nativeLogManager);
+    lunaTask->getResponsePayload().put("nativeLogManager", nativeLogManager);
+
+    pbnjson::JValue watchdog = pbnjson::Object();
+    Watchdog::getInstance().toJson(watchdog);
+    lunaTask->getResponsePayload().put("watchdog", watchdog);
+
+    pbnjson::JValue flightRecorder = pbnjson::Object();
+    FlightRecorder::getInstance().toJson(flightRecorder);
+    lunaTask->getResponsePayload().put("flightRecorder", flightRecorder);
+
+    pbnjson::JValue resourceSampler = pbnjson::Object();
+    ResourceSampler::getInstance().toJson(resourceSampler);
+    lunaTask->getResponsePayload().put("resourceSampler", resourceSampler);
+
+    LunaTaskList::getInstance().removeAfterReply(lunaTask);
+}
+
+void ApplicationManager::getLaunchStatistics(LunaTaskPtr lunaTask)
+{
+    const JValue& requestPayload = lunaTask->getRequestPayload();
+    string appId = "";
+    bool reset = false;
+
+    JValueUtil::getValue(requestPayload, "appId", appId);
+    JValueUtil::getValue(requestPayload, "reset", reset);
+
+    JValue statistics = pbnjson::Object();
+    LaunchStatistics::getInstance().toJson(statistics, appId);
+    lunaTask->getResponsePayload().put("statistics", statistics);
+    lunaTask->getResponsePayload().put("returnValue", true);
+
+    if (reset) {
+        LaunchStatistics::getInstance().reset();
+    }
+    LunaTaskList::getInstance().removeAfterReply(lunaTask);
+}
+
+void ApplicationManager::metrics(LunaTaskPtr lunaTask)
+{
+    bool reset = false;
+    JValueUtil::getValue(lunaTask->getRequestPayload(), "reset", reset);
+
+    JValue metrics = pbnjson::Object();
+    ApiMetrics::getInstance().toJson(metrics);
+    lunaTask->getResponsePayload().put("metrics", metrics);
+    lunaTask->getResponsePayload().put("returnValue", true);
+
+    if (reset) {
+        ApiMetrics::getInstance().reset();
+    }
+    LunaTaskList::getInstance().removeAfterReply(lunaTask);
+}
+
+void ApplicationManager::memory(LunaTaskPtr lunaTask)
+{
+    const JValue& requestPayload = lunaTask->getRequestPayload();
+    int top = MemoryAccounting::DEFAULT_TOP;
+
+    JValueUtil::getValue(requestPayload, "top", top);
+    MemoryAccounting::getInstance().toJson(lunaTask->getResponsePayload(), top);
+    lunaTask->getResponsePayload().put("returnValue", true);
+    LunaTaskList::getInstance().removeAfterReply(lunaTask);
+}
+
+void ApplicationManager::trace(LunaTaskPtr lunaTask)
+{
+    const JValue& requestPayload = lunaTask->getRequestPayload();
+    string action = "";
+    int capacity = 0;
+
+    JValueUtil::getValue(requestPayload, "action", action);
+    JValueUtil::getValue(requestPayload, "capacity", capacity);
+
+    if (action == "start") {
+        if (!Tracer::getInstance().start(capacity)) {
+            lunaTask->setErrCodeAndText(ErrCode_GENERAL, "Tracepoints are not compiled");
+            LunaTaskList::getInstance().removeAfterReply(lunaTask);
+            return;
+        }
+    } else if (action == "stop") {
+        Tracer::getInstance().stop();
+    } else if (action == "dump") {
+        // The dump is too big for a luna message. It is written as a file which can be opened in Perfetto.
+        // It is written in background. 'dumping' in 'tracer' is false when the file is ready.
+        if (!Tracer::getInstance().dump(PATH_TRACE)) {
+            lunaTask->setErrCodeAndText(ErrCode_GENERAL, "The previous dump is in progress");
+            LunaTaskList::getInstance().removeAfterReply(lunaTask);
+            return;
+        }
+        lunaTask->getResponsePayload().put("path", PATH_TRACE);
+    } else if (!action.empty()) {
+        lunaTask->setErrCodeAndText(ErrCode_INVALID_PAYLOAD, "Invalid action: " + action);
+        LunaTaskList::getInstance().removeAfterReply(lunaTask);
+        return;
+    }
+
+    JValue tracer = pbnjson::Object();
+    Tracer::getInstance().toJson(tracer);
+    lunaTask->getResponsePayload().put("tracer", tracer);
+    lunaTask->getResponsePayload().put("returnValue", true);
+    LunaTaskList::getInstance().removeAfterReply(lunaTask);
+}
+
+void ApplicationManager::getAppLogs(LunaTaskPtr lunaTask)
+{
+    const JValue& requestPayload = lunaTask->getRequestPayload();
+    string appId = "";
+    bool flush = false;
+
+    JValueUtil::getValue(requestPayload, "id", appId);
+    JValueUtil::getValue(requestPayload, "flush", flush);
+
+    if (appId.empty()) {
+        JValue logs = pbnjson::Object();
+        NativeLogManager::getInstance().toJson(logs);
+        lunaTask->getResponsePayload().put("logs", logs);
+        lunaTask->getResponsePayload().put("returnValue", true);
+        LunaTaskList::getInstance().removeAfterReply(lunaTask);
+        return;
+    }
+
+    JValue log = pbnjson::Object();
+    if (!NativeLogManager::getInstance().toJson(appId, log)) {
+        lunaTask->setErrCodeAndText(ErrCode_GENERAL, "No captured log for " + appId);
+        LunaTaskList::getInstance().removeAfterReply(lunaTask);
+        return;
+    }
+    if (flush) {
+        lunaTask->getResponsePayload().put("path", NativeLogManager::getInstance().flush(appId));
+    }
+    lunaTask->getResponsePayload().put("log", log);
+    lunaTask->getResponsePayload().put("returnValue", true);
     LunaTaskList::getInstance().removeAfterReply(lunaTask);
 }
 
 void ApplicationManager::postGetAppLifeEvents(RunningApp& runningApp)
 {
     if (!m_enableSubscription) return;
+    TRACE_SCOPE("post", __FUNCTION__, runningApp.getInstanceId().c_str(), runningApp.getTraceId());
 
     pbnjson::JValue info = pbnjson::JValue();
     pbnjson::JValue subscriptionPayload = pbnjson::Object();
@@ -752,6 +1070,7 @@ void ApplicationManager::postGetAppLifeStatus(RunningApp& runningApp)
 {
     if (!m_enableSubscription)
         return;
+    TRACE_SCOPE("post", __FUNCTION__, runningApp.getInstanceId().c_str(), runningApp.getTraceId());
 
     pbnjson::JValue subscriptionPayload = pbnjson::Object();
     subscriptionPayload.put("returnValue", true);
@@ -798,11 +1117,20 @@ void ApplicationManager::postGetAppLifeStatus(RunningApp& runningApp)
 
     Logger::logSubscriptionPost(getClassName(), __FUNCTION__, *m_getAppLifeStatus, subscriptionPayload);
     m_getAppLifeStatus->post(subscriptionPayload.stringify().c_str());
+
+    if (m_getAppLifeStatusUsage->getSubscribersCount() == 0)
+        return;
+    pbnjson::JValue resourceUsage = pbnjson::Object();
+    if (ResourceSampler::getInstance().toJson(runningApp.getInstanceId(), resourceUsage))
+        subscriptionPayload.put("resourceUsage", resourceUsage);
+    Logger::logSubscriptionPost(getClassName(), __FUNCTION__, *m_getAppLifeStatusUsage, subscriptionPayload);
+    m_getAppLifeStatusUsage->post(subscriptionPayload.stringify().c_str());
 }
 
 void ApplicationManager::postGetAppStatus(AppDescriptionPtr appDesc, AppStatusEvent event)
 {
     if (!m_enableSubscription) return;
+    TRACE_SCOPE("post", __FUNCTION__, nullptr, 0);
     if (!appDesc) return;
 
     pbnjson::JValue subscriptionPayload = pbnjson::Object();
@@ -855,6 +1183,7 @@ void ApplicationManager::postGetAppStatus(AppDescriptionPtr appDesc, AppStatusEv
 void ApplicationManager::postGetForegroundAppInfo(bool isOverlayEvent)
 {
     if (!m_enableSubscription) return;
+    TRACE_SCOPE("post", __FUNCTION__, nullptr, 0);
 
     pbnjson::JValue subscriptionPayload;
     subscriptionPayload = pbnjson::Object();
@@ -874,6 +1203,7 @@ void ApplicationManager::postGetForegroundAppInfo(bool isOverlayEvent)
 void ApplicationManager::postListApps(AppDescriptionPtr appDesc, const string& change, const string& changeReason)
 {
     if (!m_enableSubscription) return;
+    TRACE_SCOPE("post", __FUNCTION__, nullptr, 0);
 
     JValue subscriptionPayload = pbnjson::Object();
     subscriptionPayload.put("returnValue", true);
@@ -884,7 +1214,7 @@ void ApplicationManager::postListApps(AppDescriptionPtr appDesc, const string& c
     if (!changeReason.empty())
         subscriptionPayload.put("changeReason", changeReason);
 
-    Logger::info(getClassName(), __FUNCTION__, "SubscriptionPost", change);
+    LOG_INFO(getClassName(), __FUNCTION__, "SubscriptionPost", change);
     LSSubscriptionIter *iter = NULL;
     if (!LSSubscriptionAcquire(ApplicationManager::getInstance().get(), METHOD_LIST_APPS, &iter, NULL))
         return;
@@ -894,7 +1224,7 @@ void ApplicationManager::postListApps(AppDescriptionPtr appDesc, const string& c
         bool isDevmode = (strcmp(request.getKind(), "/dev/listApps") == 0);
 
         if (isDevmode && !SAMConf::getInstance().isDevmodeEnabled()) {
-            Logger::debug(getClassName(), __FUNCTION__, "Devmode is disabled");
+            LOG_DEBUG(getClassName(), __FUNCTION__, "Devmode is disabled");
             continue;
         }
 
@@ -915,13 +1245,13 @@ void ApplicationManager::postListApps(AppDescriptionPtr appDesc, const string& c
             subscriptionPayload.put("apps", apps);
         } else {
             if (appDesc->isDevmodeApp() != isDevmode) {
-                Logger::debug(getClassName(), __FUNCTION__, "Devmode != DevmodeApp");
+                LOG_DEBUG(getClassName(), __FUNCTION__, "Devmode != DevmodeApp");
                 continue;
             }
             pbnjson::JValue app = appDesc->getJson(properties);
             subscriptionPayload.put("app", app);
         }
-        Logger::debug(getClassName(), __FUNCTION__, request.getSenderServiceName());
+        LOG_DEBUG(getClassName(), __FUNCTION__, request.getSenderServiceName());
         request.respond(subscriptionPayload.stringify().c_str());
     }
     LSSubscriptionRelease(iter);
@@ -931,6 +1261,7 @@ void ApplicationManager::postListApps(AppDescriptionPtr appDesc, const string& c
 void ApplicationManager::postListLaunchPoints(LaunchPointPtr launchPoint, string change)
 {
     if (!m_enableSubscription) return;
+    TRACE_SCOPE("post", __FUNCTION__, nullptr, 0);
 
     if (launchPoint != nullptr && !launchPoint->isVisible())
         return;
@@ -957,11 +1288,20 @@ void ApplicationManager::postListLaunchPoints(LaunchPointPtr launchPoint, string
 
 void ApplicationManager::postRunning(RunningAppPtr runningApp)
 {
+    TRACE_SCOPE("post", __FUNCTION__, nullptr, 0);
     static JValue prevSubscriptionPayloadAll;
     static JValue prevSubscriptionPayloadDev;
 
     if (!m_enableSubscription) return;
 
+    if (m_runningPostDeferral > 0) {
+        m_isRunningPostPending = true;
+        // Remember a devmode app to post 'running' for /dev subscribers as well
+        if (runningApp != nullptr && runningApp->getLaunchPoint()->getAppDesc()->isDevmodeApp())
+            m_pendingRunningApp = runningApp;
+        return;
+    }
+
     pbnjson::JValue subscriptionPayload;
     if (runningApp != nullptr && runningApp->getLaunchPoint()->getAppDesc()->isDevmodeApp()) {
         if (RunningAppList::getInstance().isTransition(true))
@@ -990,6 +1330,33 @@ void ApplicationManager::postRunning(RunningAppPtr runningApp)
     prevSubscriptionPayloadAll = subscriptionPayload.duplicate();
     Logger::logSubscriptionPost(getClassName(), __FUNCTION__, *m_running, subscriptionPayload);
     m_running->post(subscriptionPayload.stringify().c_str());
+    postRunningResourceUsage();
+}
+
+void ApplicationManager::postRunningResourceUsage()
+{
+    if (!m_enableSubscription || m_runningUsage->getSubscribersCount() == 0)
+        return;
+
+    pbnjson::JValue subscriptionPayload = pbnjson::Object();
+    makeRunning(subscriptionPayload, false, true);
+    subscriptionPayload.put("subscribed", true);
+    subscriptionPayload.put("returnValue", true);
+    Logger::logSubscriptionPost(getClassName(), __FUNCTION__, *m_runningUsage, subscriptionPayload);
+    m_runningUsage->post(subscriptionPayload.stringify().c_str());
+}
+
+void ApplicationManager::resumeRunningPost()
+{
+    if (m_runningPostDeferral <= 0)
+        return;
+    if (--m_runningPostDeferral > 0 || !m_isRunningPostPending)
+        return;
+
+    RunningAppPtr runningApp = m_pendingRunningApp;
+    m_isRunningPostPending = false;
+    m_pendingRunningApp = nullptr;
+    postRunning(runningApp);
 }
 
 void ApplicationManager::makeGetForegroundAppInfo(JValue& payload)
@@ -1010,9 +1377,40 @@ void ApplicationManager::makeGetForegroundAppInfo(JValue& payload)
     }
 }
 
-void ApplicationManager::makeRunning(JValue& payload, bool isDevmode)
+void ApplicationManager::makeRunning(JValue& payload, bool isDevmode, bool withResourceUsage)
 {
     pbnjson::JValue running = pbnjson::Array();
     RunningAppList::getInstance().toJson(running, isDevmode);
+    if (withResourceUsage) {
+        for (int i = 0; i < running.arraySize(); ++i) {
+            string instanceId = "";
+            pbnjson::JValue resourceUsage = pbnjson::Object();
+            JValueUtil::getValue(running[i], "instanceId", instanceId);
+            if (ResourceSampler::getInstance().toJson(instanceId, resourceUsage))
+                running[i].put("resourceUsage", resourceUsage);
+        }
+    }
     payload.put("running", running);
 }
+
+int ApplicationManager::getSubscriberCount()
+{
+    LS::SubscriptionPoint* points[] = {
+        m_getAppLifeEvents, m_getAppLifeStatus, m_getForgroundAppInfo, m_getForgroundAppInfoExtraInfo,
+        m_listLaunchPointsPoint, m_listAppsPoint, m_listAppsCompactPoint, m_listDevAppsPoint,
+        m_listDevAppsCompactPoint, m_running, m_runningDev, m_getAppLifeStatusUsage, m_runningUsage
+    };
+
+    int count = 0;
+    for (size_t i = 0; i < sizeof(points) / sizeof(points[0]); ++i)
+        count += points[i]->getSubscribersCount();
+
+    // Subscriptions which are added by keys
+    count += LSSubscriptionGetHandleSubscribersCount(this->get(), METHOD_LIST_APPS);
+    const map<string, AppDescriptionPtr>& appDescs = AppDescriptionList::getInstance().getAll();
+    for (auto it = appDescs.begin(); it != appDescs.end(); ++it) {
+        count += LSSubscriptionGetHandleSubscribersCount(this->get(), ("getappstatus#" + it->first + "#Y").c_str());
+        count += LSSubscriptionGetHandleSubscribersCount(this->get(), ("getappstatus#" + it->first + "#N").c_str());
+    }
+    return count;
+}
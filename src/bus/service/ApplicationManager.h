@@ -51,9 +51,11 @@ public:
     static const char* CATEGORY_DEV;
 
     static const char* METHOD_LAUNCH;
+    static const char* METHOD_LAUNCH_BATCH;
     static const char* METHOD_PAUSE;
     static const char* METHOD_CLOSE;
     static const char* METHOD_CLOSE_BY_APPID;
+    static const char* METHOD_CLOSE_BATCH;
     static const char* METHOD_RUNNING;
     static const char* METHOD_GET_APP_LIFE_EVENTS;
     static const char* METHOD_GET_APP_LIFE_STATUS;
@@ -61,6 +63,7 @@ public:
     static const char* METHOD_LOCK_APP;
     static const char* METHOD_REGISTER_APP;
     static const char* METHOD_REGISTER_NATIVE_APP;
+    static const char* METHOD_GET_RESOURCE_USAGE;
 
     static const char* METHOD_LIST_APPS;
     static const char* METHOD_GET_APP_STATUS;
@@ -73,6 +76,11 @@ public:
     static const char* METHOD_LIST_LAUNCHPOINTS;
 
     static const char* METHOD_MANAGER_INFO;
+    static const char* METHOD_GET_LAUNCH_STATISTICS;
+    static const char* METHOD_GET_APP_LOGS;
+    static const char* METHOD_MEMORY;
+    static const char* METHOD_METRICS;
+    static const char* METHOD_TRACE;
 
     virtual ~ApplicationManager();
 
@@ -81,14 +89,17 @@ public:
 
     // APIs
     void launch(LunaTaskPtr lunaTask);
+    void launchBatch(LunaTaskPtr lunaTask);
     void pause(LunaTaskPtr lunaTask);
     void close(LunaTaskPtr lunaTask);
+    void closeBatch(LunaTaskPtr lunaTask);
     void running(LunaTaskPtr lunaTask);
     void getAppLifeEvents(LunaTaskPtr lunaTask);
     void getAppLifeStatus(LunaTaskPtr lunaTask);
     void getForegroundAppInfo(LunaTaskPtr lunaTask);
     void lockApp(LunaTaskPtr lunaTask);
     void registerApp(LunaTaskPtr lunaTask);
+    void getResourceUsage(LunaTaskPtr lunaTask);
 
     void listApps(LunaTaskPtr lunaTask);
     void getAppStatus(LunaTaskPtr lunaTask);
@@ -101,6 +112,11 @@ public:
     void listLaunchPoints(LunaTaskPtr lunaTask);
 
     void managerInfo(LunaTaskPtr lunaTask);
+    void getLaunchStatistics(LunaTaskPtr lunaTask);
+    void getAppLogs(LunaTaskPtr lunaTask);
+    void memory(LunaTaskPtr lunaTask);
+    void metrics(LunaTaskPtr lunaTask);
+    void trace(LunaTaskPtr lunaTask);
 
     // Post
     void postGetAppLifeEvents(RunningApp& runningApp);
@@ -110,10 +126,15 @@ public:
     void postListApps(AppDescriptionPtr appDesc, const string& change, const string& changeReason);
     void postListLaunchPoints(LaunchPointPtr launchPoint, string change);
     void postRunning(RunningAppPtr runningApp);
+    // 'running' subscribers with 'resourceUsage' get new samples
+    void postRunningResourceUsage();
 
     // make
     void makeGetForegroundAppInfo(JValue& payload);
-    void makeRunning(JValue& payload, bool isDevmode);
+    void makeRunning(JValue& payload, bool isDevmode, bool withResourceUsage = false);
+
+    // Subscribers of all subscription points and keys
+    int getSubscriberCount();
 
     void enablePosting()
     {
@@ -132,6 +153,13 @@ public:
         m_enableSubscription = false;
     }
 
+    // 'running' is posted once when the last deferral is resumed
+    void deferRunningPost()
+    {
+        m_runningPostDeferral++;
+    }
+    void resumeRunningPost();
+
 private:
     static bool onAPICalled(LSHandle* sh, LSMessage* message, void* context);
 
@@ -143,6 +171,9 @@ private:
         m_APIHandlers[api] = handler;
     }
 
+    // Category data of each service name is the metrics table of the category
+    void registerMetrics(const char* category, LSMethod* methods);
+
     static LSMethod METHODS_ROOT[];
     static LSMethod METHODS_DEV[];
 
@@ -159,9 +190,16 @@ private:
     LS::SubscriptionPoint* m_listDevAppsCompactPoint;
     LS::SubscriptionPoint* m_running;
     LS::SubscriptionPoint* m_runningDev;
+    // Subscribers which want 'resourceUsage'
+    LS::SubscriptionPoint* m_getAppLifeStatusUsage;
+    LS::SubscriptionPoint* m_runningUsage;
 
     bool m_enableSubscription;
 
+    int m_runningPostDeferral;
+    bool m_isRunningPostPending;
+    RunningAppPtr m_pendingRunningApp;
+
     // TODO: Following should be deleted
     ApplicationManagerCompat m_compat1;
     ApplicationManagerCompat m_compat2;
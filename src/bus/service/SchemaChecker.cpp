@@ -22,9 +22,11 @@
 SchemaChecker::SchemaChecker()
 {
     m_APISchemaFiles[ApplicationManager::METHOD_LAUNCH] = "applicationManager.launch";
+    m_APISchemaFiles[ApplicationManager::METHOD_LAUNCH_BATCH] = "applicationManager.launchBatch";
     m_APISchemaFiles[ApplicationManager::METHOD_PAUSE] = "";
     m_APISchemaFiles[ApplicationManager::METHOD_CLOSE] = "";
     m_APISchemaFiles[ApplicationManager::METHOD_CLOSE_BY_APPID] = "applicationManager.closeByAppId";
+    m_APISchemaFiles[ApplicationManager::METHOD_CLOSE_BATCH] = "applicationManager.closeBatch";
     m_APISchemaFiles[ApplicationManager::METHOD_RUNNING] = "applicationManager.running";
     m_APISchemaFiles[ApplicationManager::METHOD_GET_APP_LIFE_EVENTS] = "";
     m_APISchemaFiles[ApplicationManager::METHOD_GET_APP_LIFE_STATUS] = "";
@@ -0,0 +1,197 @@
+// Copyright (c) 2020 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Persistence.h"
+
+#include "util/File.h"
+#include "util/Logger.h"
+#include "util/Time.h"
+
+gboolean Persistence::onCoalesced(gpointer data)
+{
+    getInstance().m_timer = 0;
+    getInstance().submit();
+    return G_SOURCE_REMOVE;
+}
+
+gpointer Persistence::onWriterThread(gpointer data)
+{
+    getInstance().run();
+    return nullptr;
+}
+
+Persistence::Persistence()
+    : m_timer(0),
+      m_thread(nullptr),
+      m_isWriting(false),
+      m_isStopping(false),
+      m_requestCount(0),
+      m_writeCount(0),
+      m_failCount(0),
+      m_byteCount(0)
+{
+    setClassName("Persistence");
+    g_mutex_init(&m_mutex);
+    g_cond_init(&m_cond);
+}
+
+Persistence::~Persistence()
+{
+    g_cond_clear(&m_cond);
+    g_mutex_clear(&m_mutex);
+}
+
+void Persistence::initialize()
+{
+    if (m_thread != nullptr)
+        return;
+
+    m_isStopping = false;
+    m_thread = g_thread_new("persistence", onWriterThread, nullptr);
+}
+
+void Persistence::finalize()
+{
+    flush();
+    if (m_thread == nullptr)
+        return;
+
+    g_mutex_lock(&m_mutex);
+    m_isStopping = true;
+    g_cond_broadcast(&m_cond);
+    g_mutex_unlock(&m_mutex);
+
+    g_thread_join(m_thread);
+    m_thread = nullptr;
+}
+
+void Persistence::write(const string& path, const JValue& json)
+{
+    m_requestCount++;
+    if (m_thread == nullptr) {
+        writeFile(path, json.stringify());
+        return;
+    }
+
+    m_pending[path] = json;
+    if (m_timer == 0)
+        m_timer = g_timeout_add(COALESCE_DELAY, onCoalesced, nullptr);
+}
+
+void Persistence::flush()
+{
+    if (m_timer != 0) {
+        g_source_remove(m_timer);
+        m_timer = 0;
+    }
+    submit();
+
+    if (m_thread == nullptr)
+        return;
+
+    g_mutex_lock(&m_mutex);
+    while (!m_queue.empty() || m_isWriting)
+        g_cond_wait(&m_cond, &m_mutex);
+    g_mutex_unlock(&m_mutex);
+}
+
+void Persistence::toJson(JValue& json)
+{
+    json.put("coalesceDelay", COALESCE_DELAY);
+    json.put("pending", (int)m_pending.size());
+
+    g_mutex_lock(&m_mutex);
+    json.put("requestCount", m_requestCount);
+    json.put("writeCount", m_writeCount);
+    json.put("failCount", m_failCount);
+    json.put("byteCount", (int64_t)m_byteCount);
+    json.put("queued", (int)m_queue.size());
+
+    JValue latency = pbnjson::Object();
+    m_latency.toJson(latency);
+    g_mutex_unlock(&m_mutex);
+
+    json.put("latency", latency);
+}
+
+void Persistence::submit()
+{
+    if (m_pending.empty())
+        return;
+
+    // Serialization is done in main loop because JValue is not thread-safe
+    map<string, string> buffers;
+    for (auto it = m_pending.begin(); it != m_pending.end(); ++it)
+        buffers[it->first] = it->second.stringify();
+    m_pending.clear();
+
+    if (m_thread == nullptr) {
+        for (auto it = buffers.begin(); it != buffers.end(); ++it)
+            writeFile(it->first, it->second);
+        return;
+    }
+
+    g_mutex_lock(&m_mutex);
+    for (auto it = buffers.begin(); it != buffers.end(); ++it)
+        m_queue[it->first].swap(it->second);
+    g_cond_broadcast(&m_cond);
+    g_mutex_unlock(&m_mutex);
+}
+
+void Persistence::run()
+{
+    g_mutex_lock(&m_mutex);
+    while (true) {
+        while (m_queue.empty() && !m_isStopping)
+            g_cond_wait(&m_cond, &m_mutex);
+        if (m_queue.empty())
+            break;
+
+        map<string, string> jobs;
+        jobs.swap(m_queue);
+        m_isWriting = true;
+        g_mutex_unlock(&m_mutex);
+
+        for (auto it = jobs.begin(); it != jobs.end(); ++it)
+            writeFile(it->first, it->second);
+
+        g_mutex_lock(&m_mutex);
+        m_isWriting = false;
+        g_cond_broadcast(&m_cond);
+    }
+    g_mutex_unlock(&m_mutex);
+}
+
+bool Persistence::writeFile(const string& path, const string& buffer)
+{
+    long long startTime = Time::getCurrentTimeUs();
+    bool result = File::writeFileAtomic(path, buffer);
+    long long elapsed = (Time::getCurrentTimeUs() - startTime + 500) / 1000;
+
+    g_mutex_lock(&m_mutex);
+    if (result) {
+        m_writeCount++;
+        m_byteCount += buffer.length();
+        m_latency.add(elapsed);
+    } else {
+        m_failCount++;
+    }
+    g_mutex_unlock(&m_mutex);
+
+    if (!result)
+        Logger::warning(getClassName(), __FUNCTION__, path, "Failed to write file");
+    return result;
+}
@@ -0,0 +1,86 @@
+// Copyright (c) 2020 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef CONF_PERSISTENCE_H_
+#define CONF_PERSISTENCE_H_
+
+#include <iostream>
+#include <map>
+#include <glib.h>
+#include <pbnjson.hpp>
+
+#include "interface/ISingleton.h"
+#include "interface/IClassName.h"
+#include "util/Histogram.h"
+
+using namespace std;
+using namespace pbnjson;
+
+// Persistence writes JSON files behind the main loop.
+//  - Writes to the same file within COALESCE_DELAY are merged. Only the latest content is written.
+//  - Files are serialized without indentation and written by a writer thread.
+//  - Each file is replaced atomically (temp file + fsync + rename).
+// Before initialize() and after finalize(), files are written synchronously.
+class Persistence : public ISingleton<Persistence>,
+                    public IClassName {
+friend class ISingleton<Persistence>;
+public:
+    static const int COALESCE_DELAY = 200; // ms
+
+    virtual ~Persistence();
+
+    void initialize();
+    void finalize();
+
+    // 'json' is serialized when the window is closed. Later changes in the window are included.
+    void write(const string& path, const JValue& json);
+
+    // Writes all pending files and waits until they are on the disk
+    void flush();
+
+    void toJson(JValue& json);
+
+private:
+    static gboolean onCoalesced(gpointer data);
+    static gpointer onWriterThread(gpointer data);
+
+    Persistence();
+
+    void submit();
+    void run();
+    bool writeFile(const string& path, const string& buffer);
+
+    // main loop only
+    map<string, JValue> m_pending;
+    guint m_timer;
+    GThread* m_thread;
+
+    // shared with the writer thread (m_mutex)
+    GMutex m_mutex;
+    GCond m_cond;
+    map<string, string> m_queue;
+    bool m_isWriting;
+    bool m_isStopping;
+
+    int m_requestCount;
+    int m_writeCount;
+    int m_failCount;
+    long long m_byteCount;
+    Histogram m_latency;
+
+};
+
+#endif /* CONF_PERSISTENCE_H_ */
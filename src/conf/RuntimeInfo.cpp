@@ -18,6 +18,8 @@
 
 #include <stdlib.h>
 
+#include "conf/Persistence.h"
+
 RuntimeInfo::RuntimeInfo()
     : m_displayId(-1),
       m_isInContainer(false)
@@ -52,9 +54,9 @@ void RuntimeInfo::initialize()
     if (container != nullptr) {
         m_isInContainer = true;
     }
-    Logger::info(getClassName(), __FUNCTION__,
-                 Logger::format("DisplayId(%d) DeviceType(%s) IsInContainer(%s)",
-                                 m_displayId, m_deviceType.c_str(), Logger::toString(m_isInContainer)));
+    LOG_INFO(getClassName(), __FUNCTION__,
+             Logger::format("DisplayId(%d) DeviceType(%s) IsInContainer(%s)",
+                             m_displayId, m_deviceType.c_str(), Logger::toString(m_isInContainer)));
     load();
 }
 
@@ -70,16 +72,13 @@ bool RuntimeInfo::setValue(const string& key, JValue& value)
 {
     if (!m_database.put(key, value.duplicate()))
         return false;
-    return save();
+    save();
+    return true;
 }
 
-bool RuntimeInfo::save()
+void RuntimeInfo::save()
 {
-    if (!File::writeFile(PATH_RUNTIME_INFO, m_database.stringify("    "))) {
-        Logger::warning(getClassName(), __FUNCTION__, PATH_RUNTIME_INFO, "Failed to save RuntimeInfo");
-        return false;
-    }
-    return true;
+    Persistence::getInstance().write(PATH_RUNTIME_INFO, m_database);
 }
 
 bool RuntimeInfo::load()
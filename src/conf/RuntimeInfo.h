@@ -40,6 +40,7 @@ public:
     void initialize();
 
     bool getValue(const string& key, JValue& value);
+    // Returns false if the value can't be set. It is saved asynchronously
     bool setValue(const string& key, JValue& value);
 
     int getDisplayId()
@@ -70,7 +71,8 @@ public:
 private:
     RuntimeInfo();
 
-    bool save();
+    // Written by Persistence in background. Write failures are logged and counted by Persistence.
+    void save();
     bool load();
 
     JValue m_database;
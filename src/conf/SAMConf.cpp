@@ -16,6 +16,7 @@
 
 #include "SAMConf.h"
 
+#include "Persistence.h"
 #include "RuntimeInfo.h"
 
 SAMConf::SAMConf()
@@ -47,13 +48,13 @@ void SAMConf::initialize()
 
     if (!m_isRespawned) {
         if (!File::createFile(this->getRespawnedPath())) {
-            Logger::info(getClassName(), __FUNCTION__, "Failed to create respawned file");
+            LOG_INFO(getClassName(), __FUNCTION__, "Failed to create respawned file");
         }
     }
 
-    Logger::info(getClassName(), __FUNCTION__,
-                 Logger::format("isDevmodeEnabled(%s) isRespawned(%s) isJailerDisabled(%s)",
-                 Logger::toString(m_isDevmodeEnabled), Logger::toString(m_isRespawned), Logger::toString(m_isJailerDisabled)));
+    LOG_INFO(getClassName(), __FUNCTION__,
+             Logger::format("isDevmodeEnabled(%s) isRespawned(%s) isJailerDisabled(%s)",
+             Logger::toString(m_isDevmodeEnabled), Logger::toString(m_isRespawned), Logger::toString(m_isJailerDisabled)));
 }
 
 void SAMConf::loadReadOnlyConf()
@@ -92,9 +93,7 @@ void SAMConf::saveReadWriteConf()
         path = PATH_RW_SAM_CONF;
     }
 
-    if (!File::writeFile(path, m_readWriteDatabase.stringify("    ").c_str())) {
-        Logger::warning(getClassName(), __FUNCTION__, PATH_RO_SAM_CONF, "Failed to save read-write sam-conf");
-    }
+    Persistence::getInstance().write(path, m_readWriteDatabase);
 }
 
 void SAMConf::loadBlockedList()
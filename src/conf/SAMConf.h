@@ -100,6 +100,140 @@ public:
         return RespawnedPath;
     }
 
+    int getRunnerPoolSize(const string& runner) const
+    {
+        int size = 0;
+        JValueUtil::getValue(m_readOnlyDatabase, "RunnerPool", runner, size);
+        return size;
+    }
+
+    int getRunnerPoolMemoryThreshold() const
+    {
+        int threshold = 256;
+        JValueUtil::getValue(m_readOnlyDatabase, "RunnerPool", "MemoryThreshold", threshold);
+        return threshold;
+    }
+
+    bool isLightweightSpawnEnabled() const
+    {
+        bool enabled = true;
+        JValueUtil::getValue(m_readOnlyDatabase, "LightweightSpawn", enabled);
+        return enabled;
+    }
+
+    const string& getCgroupRoot() const
+    {
+        static string CgroupRoot = "";
+        JValueUtil::getValue(m_readOnlyDatabase, "CgroupRoot", CgroupRoot);
+        return CgroupRoot;
+    }
+
+    bool isNativeLogCaptureEnabled() const
+    {
+        bool enabled = false;
+        JValueUtil::getValue(m_readOnlyDatabase, "NativeLogCapture", "Enabled", enabled);
+        return enabled;
+    }
+
+    int getNativeLogBufferSize() const
+    {
+        int size = 64;
+        JValueUtil::getValue(m_readOnlyDatabase, "NativeLogCapture", "BufferSize", size);
+        return size;
+    }
+
+    int getPreloadMaxCount() const
+    {
+        int count = 0;
+        JValueUtil::getValue(m_readOnlyDatabase, "PredictivePreload", "MaxCount", count);
+        return count;
+    }
+
+    int getPreloadMemoryHeadroom() const
+    {
+        int headroom = 512;
+        JValueUtil::getValue(m_readOnlyDatabase, "PredictivePreload", "MemoryHeadroom", headroom);
+        return headroom;
+    }
+
+    int getPreloadIdleDelay() const
+    {
+        int delay = 10;
+        JValueUtil::getValue(m_readOnlyDatabase, "PredictivePreload", "IdleDelay", delay);
+        return delay;
+    }
+
+    int getResidentMemoryBudget() const
+    {
+        int budget = 0;
+        JValueUtil::getValue(m_readOnlyDatabase, "ResidentApps", "MemoryBudget", budget);
+        return budget;
+    }
+
+    int getApiMetricsLogInterval() const
+    {
+        int interval = 0;
+        JValueUtil::getValue(m_readOnlyDatabase, "ApiMetrics", "LogInterval", interval);
+        return interval;
+    }
+
+    int getStallThreshold() const
+    {
+        int threshold = 500;
+        JValueUtil::getValue(m_readOnlyDatabase, "Watchdog", "StallThreshold", threshold);
+        return threshold;
+    }
+
+    int getResourceSamplingInterval() const
+    {
+        int interval = 0;
+        JValueUtil::getValue(m_readOnlyDatabase, "ResourceSampler", "Interval", interval);
+        return interval;
+    }
+
+    int getFlightRecorderCapacity() const
+    {
+        int capacity = 8192;
+        JValueUtil::getValue(m_readOnlyDatabase, "FlightRecorder", "Capacity", capacity);
+        return capacity;
+    }
+
+    JValue getBootLaunchList() const
+    {
+        JValue BootLaunchList = pbnjson::Object();
+        JValueUtil::getValue(m_readOnlyDatabase, "BootLaunchList", BootLaunchList);
+        return BootLaunchList;
+    }
+
+    int getTransitionTimeout() const
+    {
+        int timeout = 10000;
+        JValueUtil::getValue(m_readOnlyDatabase, "TransitionTimeout", "Transition", timeout);
+        return timeout;
+    }
+
+    int getKillMaxBackoff() const
+    {
+        int backoff = 8000;
+        JValueUtil::getValue(m_readOnlyDatabase, "TransitionTimeout", "MaxBackoff", backoff);
+        return backoff;
+    }
+
+    JValue getKillEscalation(const string& appType) const
+    {
+        JValue Escalation;
+        if (!JValueUtil::getValue(m_readOnlyDatabase, "TransitionTimeout", "Escalation", Escalation) || !Escalation.isObject()) {
+            return pbnjson::Array();
+        }
+        if (Escalation.hasKey(appType) && Escalation[appType].isArray()) {
+            return Escalation[appType];
+        }
+        if (Escalation.hasKey("default") && Escalation["default"].isArray()) {
+            return Escalation["default"];
+        }
+        return pbnjson::Array();
+    }
+
     bool isFullscreenWindowTypes(string type)
     {
         JValue FullscreenWindowType;
@@ -221,6 +355,22 @@ public:
         saveReadWriteConf();
     }
 
+    JValue getMemoryFootprints() const
+    {
+        JValue memoryFootprints = pbnjson::Object();
+        JValueUtil::getValue(m_readWriteDatabase, "memoryFootprints", memoryFootprints);
+        return memoryFootprints;
+    }
+
+    void setMemoryFootprints(const JValue& object)
+    {
+        if (!object.isObject())
+            return;
+
+        m_readWriteDatabase.put("memoryFootprints", object);
+        saveReadWriteConf();
+    }
+
     const string& getLanguage() const
     {
         static string language = "";
@@ -28,18 +28,18 @@ public:
 
     virtual bool initialize(GMainLoop* mainloop) final
     {
-        Logger::info(getClassName(), "Start initialization");
+        LOG_INFO(getClassName(), "Start initialization");
         m_mainloop = mainloop;
         m_isInitalized = onInitialization();
-        Logger::info(getClassName(), "End initialization");
+        LOG_INFO(getClassName(), "End initialization");
         return m_isInitalized;
     }
 
     virtual bool finalize() final
     {
-        Logger::info(getClassName(), "Start finalization");
+        LOG_INFO(getClassName(), "Start finalization");
         m_isFinalized = onFinalization();
-        Logger::info(getClassName(), "End finalization");
+        LOG_INFO(getClassName(), "End finalization");
         return m_isFinalized;
     }
 
@@ -72,7 +72,7 @@ protected:
 
     void ready()
     {
-        Logger::info(getClassName(), "Ready");
+        LOG_INFO(getClassName(), "Ready");
         m_isReady = true;
     }
 
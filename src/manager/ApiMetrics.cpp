@@ -0,0 +1,362 @@
+// Copyright (c) 2020 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ApiMetrics.h"
+
+#include <string.h>
+
+#include "conf/SAMConf.h"
+#include "manager/FlightRecorder.h"
+#include "manager/Watchdog.h"
+#include "util/JValueUtil.h"
+#include "util/Logger.h"
+#include "util/Time.h"
+#include "util/Tracer.h"
+
+gboolean ApiMetrics::onLogTimer(gpointer data)
+{
+    getInstance().log();
+    return G_SOURCE_CONTINUE;
+}
+
+int ApiMetrics::getErrorCode(LSMessage* message, const JValue& responsePayload)
+{
+    bool returnValue = true;
+    int errorCode = 0;
+    if (!JValueUtil::getValue(responsePayload, "returnValue", returnValue))
+        returnValue = !LSMessageIsHubErrorMessage(message);
+    if (returnValue)
+        return 0;
+    if (!JValueUtil::getValue(responsePayload, "errorCode", errorCode) || errorCode == 0)
+        errorCode = ErrCode_UNKNOWN;
+    return errorCode;
+}
+
+ApiMetrics::ApiMetrics()
+    : m_slotCount(0),
+      m_tableCount(0),
+      m_pendingIndex(0),
+      m_lostCount(0),
+      m_logTimer(0),
+      m_startTime(Time::getCurrentTime())
+{
+    setClassName("ApiMetrics");
+    memset(m_pendings, 0, sizeof(m_pendings));
+    reset();
+}
+
+ApiMetrics::~ApiMetrics()
+{
+    finalize();
+}
+
+void ApiMetrics::initialize()
+{
+    int interval = SAMConf::getInstance().getApiMetricsLogInterval();
+    if (interval > 0 && m_logTimer == 0)
+        m_logTimer = g_timeout_add_seconds(interval, onLogTimer, nullptr);
+}
+
+void ApiMetrics::finalize()
+{
+    if (m_logTimer != 0) {
+        g_source_remove(m_logTimer);
+        m_logTimer = 0;
+    }
+}
+
+void* ApiMetrics::addCategory(const string& service, const char* category, const LSMethod* methods)
+{
+    if (m_tableCount >= MAX_TABLES) {
+        Logger::warning(getClassName(), __FUNCTION__, Logger::format("Too many categories: %s%s", service.c_str(), category));
+        return nullptr;
+    }
+
+    Table& table = m_tables[m_tableCount];
+    table.base = m_slotCount;
+    table.methods = methods;
+    for (const LSMethod* method = methods; method->name != nullptr; ++method) {
+        string name = service + category;
+        if (name[name.length() - 1] != '/')
+            name += "/";
+        if (allocate(name + method->name, false) < 0) {
+            Logger::warning(getClassName(), __FUNCTION__, Logger::format("Too many methods: %s%s", service.c_str(), category));
+            m_slotCount = table.base;
+            return nullptr;
+        }
+    }
+    m_tableCount++;
+    return &table;
+}
+
+int ApiMetrics::getSlot(void* category, const char* method)
+{
+    Table* table = static_cast<Table*>(category);
+    if (table == nullptr || method == nullptr)
+        return -1;
+
+    for (int i = 0; table->methods[i].name != nullptr; ++i) {
+        if (strcmp(table->methods[i].name, method) == 0)
+            return table->base + i;
+    }
+    return -1;
+}
+
+void ApiMetrics::onRequest(int slot, size_t requestSize)
+{
+    if (slot < 0 || slot >= m_slotCount)
+        return;
+
+    Slot& s = m_slots[slot];
+    s.count++;
+    s.inflight++;
+    if (s.inflight > s.maxInflight)
+        s.maxInflight = s.inflight;
+    s.requestSize.add(requestSize);
+    FlightRecorder::getInstance().record(s.isOutbound ? FlightRecordType_CallRequest : FlightRecordType_ApiRequest,
+                                         s.flightId, 0, (int)requestSize, 0);
+}
+
+void ApiMetrics::onResponse(int slot, long long requestTime, size_t responseSize, int errorCode)
+{
+    if (slot < 0 || slot >= m_slotCount)
+        return;
+
+    Slot& s = m_slots[slot];
+    if (s.inflight > 0)
+        s.inflight--;
+    long long latency = Time::getCurrentTime() - requestTime;
+    s.latency.add(latency);
+    s.responseSize.add(responseSize);
+    if (errorCode != 0)
+        addError(s, errorCode);
+    FlightRecorder::getInstance().record(s.isOutbound ? FlightRecordType_CallResponse : FlightRecordType_ApiResponse,
+                                         s.flightId, 0, errorCode, (int)latency);
+}
+
+int ApiMetrics::addCall(const string& method)
+{
+    for (int i = 0; i < m_slotCount; ++i) {
+        if (m_slots[i].isOutbound && m_slots[i].name == method)
+            return i;
+    }
+
+    int slot = allocate(method, true);
+    if (slot < 0)
+        Logger::warning(getClassName(), __FUNCTION__, Logger::format("Too many methods: %s", method.c_str()));
+    return slot;
+}
+
+void ApiMetrics::onCallRequest(int slot, LSMessageToken token, size_t requestSize)
+{
+    if (slot < 0 || slot >= m_slotCount)
+        return;
+
+    onRequest(slot, requestSize);
+
+    // A free entry is used first. The oldest pending call is overwritten only if all of them are waiting.
+    // Its response can't be matched anymore, so it is not in flight from now on.
+    int index = -1;
+    int oldest = 0;
+    for (int i = 0; i < MAX_PENDING; ++i) {
+        int candidate = (m_pendingIndex + i) % MAX_PENDING;
+        if (m_pendings[candidate].token == 0) {
+            index = candidate;
+            break;
+        }
+        if (m_pendings[candidate].requestTime < m_pendings[oldest].requestTime)
+            oldest = candidate;
+    }
+    if (index < 0) {
+        index = oldest;
+        m_lostCount++;
+        Pending& lost = m_pendings[index];
+        if (m_slots[lost.slot].inflight > 0)
+            m_slots[lost.slot].inflight--;
+        TRACE_ASYNC_END("call", m_slots[lost.slot].name.c_str(), "lost", lost.token, lost.traceId);
+    }
+
+    Pending& pending = m_pendings[index];
+    pending.token = token;
+    pending.slot = slot;
+    pending.requestTime = Time::getCurrentTime();
+    pending.traceId = Tracer::getCurrentId();
+    m_pendingIndex = (index + 1) % MAX_PENDING;
+    TRACE_ASYNC_BEGIN("call", m_slots[slot].name.c_str(), nullptr, token, pending.traceId);
+}
+
+unsigned long ApiMetrics::onCallResponse(LSMessage* message, const JValue& responsePayload)
+{
+    LSMessageToken token = LSMessageGetResponseToken(message);
+    if (token == 0)
+        return 0;
+
+    for (int i = 0; i < MAX_PENDING; ++i) {
+        Pending& pending = m_pendings[i];
+        if (pending.token != token)
+            continue;
+
+        Watchdog::getInstance().setActivity(m_slots[pending.slot].name.c_str());
+        const char* payload = LSMessageGetPayload(message);
+        int errorCode = getErrorCode(message, responsePayload);
+        onResponse(pending.slot, pending.requestTime, payload ? strlen(payload) : 0, errorCode);
+        TRACE_ASYNC_END("call", m_slots[pending.slot].name.c_str(), errorCode != 0 ? "error" : nullptr, token, pending.traceId);
+        pending.token = 0;
+        return pending.traceId;
+    }
+    return 0;
+}
+
+void ApiMetrics::onSubscriptionResponse(int slot, LSMessage* message, const JValue& subscriptionPayload)
+{
+    if (slot < 0 || slot >= m_slotCount)
+        return;
+
+    // Subscription posts have no request. Only count, size and errors are meaningful.
+    Slot& s = m_slots[slot];
+    Watchdog::getInstance().setActivity(s.name.c_str());
+    const char* payload = LSMessageGetPayload(message);
+    s.count++;
+    s.responseSize.add(payload ? strlen(payload) : 0);
+    int errorCode = getErrorCode(message, subscriptionPayload);
+    if (errorCode != 0)
+        addError(s, errorCode);
+}
+
+void ApiMetrics::reset()
+{
+    for (int i = 0; i < MAX_SLOTS; ++i) {
+        Slot& s = m_slots[i];
+        s.count = 0;
+        s.maxInflight = s.inflight;
+        s.latency.reset();
+        s.requestSize.reset();
+        s.responseSize.reset();
+        s.errorCount = 0;
+        memset(s.errorCodes, 0, sizeof(s.errorCodes));
+        memset(s.errorCounts, 0, sizeof(s.errorCounts));
+        s.otherErrorCount = 0;
+        s.lastCount = 0;
+    }
+    m_lostCount = 0;
+    m_startTime = Time::getCurrentTime();
+}
+
+void ApiMetrics::toJson(JValue& json)
+{
+    long long elapsed = Time::getCurrentTime() - m_startTime;
+    JValue inbound = pbnjson::Object();
+    JValue outbound = pbnjson::Object();
+    for (int i = 0; i < m_slotCount; ++i) {
+        if (m_slots[i].count == 0 && m_slots[i].inflight == 0)
+            continue;
+
+        JValue slot = pbnjson::Object();
+        toJson(slot, m_slots[i]);
+        if (elapsed > 0)
+            slot.put("ratePerMin", (int64_t)(m_slots[i].count * 60000 / elapsed));
+        if (m_slots[i].isOutbound)
+            outbound.put(m_slots[i].name, slot);
+        else
+            inbound.put(m_slots[i].name, slot);
+    }
+
+    json.put("elapsed", (int64_t)elapsed);
+    json.put("slots", m_slotCount);
+    json.put("lostCount", (int64_t)m_lostCount);
+    json.put("inbound", inbound);
+    json.put("outbound", outbound);
+}
+
+int ApiMetrics::allocate(const string& name, bool isOutbound)
+{
+    if (m_slotCount >= MAX_SLOTS)
+        return -1;
+
+    Slot& s = m_slots[m_slotCount];
+    s.name = name;
+    s.flightId = FlightRecorder::getInstance().intern(name);
+    s.isOutbound = isOutbound;
+    s.inflight = 0;
+    s.maxInflight = 0;
+    return m_slotCount++;
+}
+
+void ApiMetrics::addError(Slot& slot, int errorCode)
+{
+    slot.errorCount++;
+    for (int i = 0; i < MAX_ERROR_CODES; ++i) {
+        if (slot.errorCounts[i] == 0) {
+            slot.errorCodes[i] = errorCode;
+            slot.errorCounts[i] = 1;
+            return;
+        }
+        if (slot.errorCodes[i] == errorCode) {
+            slot.errorCounts[i]++;
+            return;
+        }
+    }
+    slot.otherErrorCount++;
+}
+
+void ApiMetrics::log()
+{
+    if (!Logger::isEnabled(LogLevel_INFO))
+        return;
+
+    // name:count(delta)/inflight/p50/p99/errors
+    string snapshot = "";
+    for (int i = 0; i < m_slotCount; ++i) {
+        Slot& s = m_slots[i];
+        if (s.count == s.lastCount)
+            continue;
+
+        snapshot += Logger::format("%s%s:%lld(+%lld)/%d/%lld/%lld/%lld",
+                                   snapshot.empty() ? "" : " ",
+                                   s.name.c_str(), s.count, s.count - s.lastCount, s.inflight,
+                                   s.latency.getPercentile(50), s.latency.getPercentile(99), s.errorCount);
+        s.lastCount = s.count;
+    }
+    if (!snapshot.empty())
+        Logger::info(getClassName(), __FUNCTION__, snapshot);
+}
+
+void ApiMetrics::toJson(JValue& json, const Slot& slot)
+{
+    json.put("count", (int64_t)slot.count);
+    json.put("inflight", slot.inflight);
+    json.put("maxInflight", slot.maxInflight);
+
+    JValue latency = pbnjson::Object();
+    slot.latency.toJson(latency);
+    json.put("latency", latency);
+
+    JValue requestSize = pbnjson::Object();
+    slot.requestSize.toJson(requestSize);
+    json.put("requestSize", requestSize);
+
+    JValue responseSize = pbnjson::Object();
+    slot.responseSize.toJson(responseSize);
+    json.put("responseSize", responseSize);
+
+    JValue errors = pbnjson::Object();
+    for (int i = 0; i < MAX_ERROR_CODES && slot.errorCounts[i] > 0; ++i)
+        errors.put(std::to_string(slot.errorCodes[i]), (int64_t)slot.errorCounts[i]);
+    if (slot.otherErrorCount > 0)
+        errors.put("other", (int64_t)slot.otherErrorCount);
+    json.put("errorCount", (int64_t)slot.errorCount);
+    json.put("errors", errors);
+}
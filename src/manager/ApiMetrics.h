@@ -0,0 +1,130 @@
+// Copyright (c) 2020 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef MANAGER_APIMETRICS_H_
+#define MANAGER_APIMETRICS_H_
+
+#include <iostream>
+#include <glib.h>
+#include <luna-service2/lunaservice.h>
+#include <pbnjson.hpp>
+
+#include "interface/ISingleton.h"
+#include "interface/IClassName.h"
+#include "util/Histogram.h"
+
+using namespace std;
+using namespace pbnjson;
+
+// ApiMetrics counts luna calls per method.
+//  - Inbound  : each method of each category and service name (com.webos.applicationManager and compat names)
+//  - Outbound : each method SAM calls (WAM, LSM, DB8, MemoryManager)
+// Each slot has request count, in-flight gauge, latency (ms), payload sizes (bytes) and error codes.
+//
+// Slots are allocated when methods are registered. Recording only updates preallocated slots.
+// Everything runs in the main loop, so there is no lock.
+// If 'ApiMetrics.LogInterval' (sec) is set in sam-conf, a compact snapshot is logged periodically.
+class ApiMetrics : public ISingleton<ApiMetrics>,
+                   public IClassName {
+friend class ISingleton<ApiMetrics>;
+public:
+    static const int MAX_SLOTS = 192;
+    static const int MAX_TABLES = 8;
+    static const int MAX_PENDING = 64;
+    static const int MAX_ERROR_CODES = 8;
+
+    virtual ~ApiMetrics();
+
+    void initialize();
+    void finalize();
+
+    // Inbound: returns category data which should be set on the handle
+    void* addCategory(const string& service, const char* category, const LSMethod* methods);
+    int getSlot(void* category, const char* method);
+    void onRequest(int slot, size_t requestSize);
+    void onResponse(int slot, long long requestTime, size_t responseSize, int errorCode);
+
+    // Outbound: the same method shares a slot
+    int addCall(const string& method);
+    // The current trace ID is carried to the response. It is returned by onCallResponse()
+    void onCallRequest(int slot, LSMessageToken token, size_t requestSize);
+    unsigned long onCallResponse(LSMessage* message, const JValue& responsePayload);
+    void onSubscriptionResponse(int slot, LSMessage* message, const JValue& subscriptionPayload);
+
+    void reset();
+    void toJson(JValue& json);
+
+private:
+    struct Slot {
+        Slot()
+            : requestSize(HistogramUnit::HistogramUnit_BYTES),
+              responseSize(HistogramUnit::HistogramUnit_BYTES)
+        {
+        }
+
+        string name;
+        unsigned int flightId;
+        bool isOutbound;
+        long long count;
+        int inflight;
+        int maxInflight;
+        Histogram latency;
+        Histogram requestSize;
+        Histogram responseSize;
+        long long errorCount;
+        int errorCodes[MAX_ERROR_CODES];
+        long long errorCounts[MAX_ERROR_CODES];
+        long long otherErrorCount;
+        long long lastCount;
+    };
+
+    struct Table {
+        int base;
+        const LSMethod* methods;
+    };
+
+    struct Pending {
+        LSMessageToken token;
+        int slot;
+        long long requestTime;
+        unsigned long traceId;
+    };
+
+    static gboolean onLogTimer(gpointer data);
+    static int getErrorCode(LSMessage* message, const JValue& responsePayload);
+
+    ApiMetrics();
+
+    int allocate(const string& name, bool isOutbound);
+    void addError(Slot& slot, int errorCode);
+    void log();
+    void toJson(JValue& json, const Slot& slot);
+
+    Slot m_slots[MAX_SLOTS];
+    int m_slotCount;
+    Table m_tables[MAX_TABLES];
+    int m_tableCount;
+
+    Pending m_pendings[MAX_PENDING];
+    int m_pendingIndex;
+    long long m_lostCount;
+
+    guint m_logTimer;
+    long long m_startTime;
+
+};
+
+#endif /* MANAGER_APIMETRICS_H_ */
@@ -0,0 +1,234 @@
+// Copyright (c) 2020 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#include "BatchLauncher.h"
+
+#include <algorithm>
+#include <boost/bind.hpp>
+
+#include "base/AppDescription.h"
+#include "base/LaunchPointList.h"
+#include "base/LunaTaskList.h"
+#include "base/RunningAppList.h"
+#include "bus/client/MemoryManager.h"
+#include "bus/service/ApplicationManager.h"
+#include "conf/SAMConf.h"
+#include "manager/MemoryEstimator.h"
+#include "util/File.h"
+#include "util/JValueUtil.h"
+#include "util/Logger.h"
+#include "util/Time.h"
+
+BatchLauncher::BatchLauncher()
+    : m_batchCounter(0)
+{
+    setClassName("BatchLauncher");
+}
+
+BatchLauncher::~BatchLauncher()
+{
+}
+
+void BatchLauncher::launch(LunaTaskPtr lunaTask)
+{
+    JValue items;
+    int concurrency = DEFAULT_CONCURRENCY;
+
+    if (!JValueUtil::getValue(lunaTask->getRequestPayload(), "items", items) || !items.isArray() || items.arraySize() == 0) {
+        lunaTask->setErrCodeAndText(ErrCode_INVALID_PAYLOAD, "items should not be empty");
+        LunaTaskList::getInstance().removeAfterReply(lunaTask);
+        return;
+    }
+    JValueUtil::getValue(lunaTask->getRequestPayload(), "concurrency", concurrency);
+    if (concurrency < 1)
+        concurrency = 1;
+
+    BatchPtr batch = make_shared<Batch>();
+    batch->id = ++m_batchCounter;
+    batch->lunaTask = lunaTask;
+    batch->next = 0;
+    batch->running = 0;
+    batch->completed = 0;
+    batch->concurrency = concurrency;
+    batch->requiredMemory = 0;
+    batch->isMemoryReserved = false;
+    batch->isFinished = false;
+    batch->startTime = Time::getCurrentTime();
+
+    string launchMethod = File::join(ApplicationManager::CATEGORY_ROOT, ApplicationManager::METHOD_LAUNCH);
+    for (int i = 0; i < items.arraySize(); ++i) {
+        Item item;
+        item.index = i;
+        item.priority = 0;
+        item.startTime = 0;
+        JValueUtil::getValue(items[i], "priority", item.priority);
+
+        JValue requestPayload = items[i].duplicate();
+        requestPayload.remove("priority");
+        item.lunaTask = make_shared<LunaTask>(launchMethod, requestPayload);
+        item.lunaTask->setOrigin(*lunaTask);
+        if (lunaTask->getDisplayId() != -1)
+            item.lunaTask->setDisplayId(lunaTask->getDisplayId());
+
+        // Only apps which will be started newly need memory
+        LaunchPointPtr launchPoint = LaunchPointList::getInstance().getByLunaTask(item.lunaTask);
+        if (launchPoint && RunningAppList::getInstance().getByLunaTask(item.lunaTask, false) == nullptr) {
+            batch->requiredMemory += MemoryEstimator::getInstance().getRequiredMemory(launchPoint->getAppDesc());
+        }
+
+        batch->items.push_back(item);
+        batch->order.push_back(make_pair(item.priority, i));
+    }
+
+    // stable_sort keeps request order between items with the same priority
+    stable_sort(batch->order.begin(), batch->order.end(), compareByPriority);
+
+    m_batches[batch->id] = batch;
+    LOG_INFO(getClassName(), __FUNCTION__,
+             Logger::format("batch(%d) items(%d) concurrency(%d) requiredMemory(%d)",
+             batch->id, (int)batch->items.size(), concurrency, batch->requiredMemory));
+
+    if (batch->requiredMemory <= 0) {
+        dispatch(batch);
+        return;
+    }
+    lunaTask->setSuccessCallback(boost::bind(&BatchLauncher::onRequireMemory, this, batch->id, boost::placeholders::_1));
+    lunaTask->setErrorCallback(boost::bind(&BatchLauncher::onRequireMemoryError, this, batch->id, boost::placeholders::_1));
+    MemoryManager::getInstance().requireMemory(batch->requiredMemory, lunaTask);
+}
+
+void BatchLauncher::launchBootList()
+{
+    JValue bootLaunchList = SAMConf::getInstance().getBootLaunchList();
+    JValue items;
+    if (!JValueUtil::getValue(bootLaunchList, "items", items) || !items.isArray() || items.arraySize() == 0) {
+        return;
+    }
+
+    LunaTaskPtr lunaTask = make_shared<LunaTask>(File::join(ApplicationManager::CATEGORY_ROOT, ApplicationManager::METHOD_LAUNCH_BATCH), bootLaunchList);
+    LunaTaskList::getInstance().add(lunaTask);
+    launch(lunaTask);
+}
+
+void BatchLauncher::onRequireMemory(int batchId, LunaTaskPtr lunaTask)
+{
+    BatchPtr batch = getBatch(batchId);
+    if (batch == nullptr)
+        return;
+
+    batch->isMemoryReserved = true;
+    dispatch(batch);
+}
+
+void BatchLauncher::onRequireMemoryError(int batchId, LunaTaskPtr lunaTask)
+{
+    BatchPtr batch = getBatch(batchId);
+    if (batch == nullptr)
+        return;
+
+    // Each launch negotiates memory for itself. Some of them could be still launched.
+    Logger::warning(getClassName(), __FUNCTION__,
+                    Logger::format("batch(%d) Fallback to per-app memory negotiation: %s", batchId, lunaTask->getErrText().c_str()));
+    lunaTask->setErrCodeAndText(ErrCode_NOERROR, "");
+    batch->isMemoryReserved = false;
+    dispatch(batch);
+}
+
+void BatchLauncher::onItemReplied(int batchId, int index, LunaTaskPtr lunaTask)
+{
+    BatchPtr batch = getBatch(batchId);
+    if (batch == nullptr)
+        return;
+
+    Item& item = batch->items[index];
+    JValue result = pbnjson::Object();
+    bool returnValue = true;
+    JValueUtil::getValue(lunaTask->getResponsePayload(), "returnValue", returnValue);
+
+    result.put("id", lunaTask->getAppId());
+    if (!lunaTask->getInstanceId().empty())
+        result.put("instanceId", lunaTask->getInstanceId());
+    result.put("returnValue", returnValue);
+    if (!returnValue) {
+        result.put("errorCode", lunaTask->getErrCode());
+        result.put("errorText", lunaTask->getErrText());
+    }
+    result.put("launchTime", (int)(Time::getCurrentTime() - item.startTime));
+    result.put("completedTime", (int)(Time::getCurrentTime() - batch->startTime));
+    item.result = result;
+
+    batch->running--;
+    batch->completed++;
+    dispatch(batch);
+}
+
+bool BatchLauncher::compareByPriority(const pair<int, int>& a, const pair<int, int>& b)
+{
+    return a.first > b.first;
+}
+
+BatchLauncher::BatchPtr BatchLauncher::getBatch(int batchId)
+{
+    auto it = m_batches.find(batchId);
+    if (it == m_batches.end())
+        return nullptr;
+    return it->second;
+}
+
+void BatchLauncher::dispatch(BatchPtr batch)
+{
+    // launch can be replied synchronously. In that case, dispatch is called again in onItemReplied
+    while (batch->running < batch->concurrency && batch->next < batch->order.size()) {
+        Item& item = batch->items[batch->order[batch->next++].second];
+        item.startTime = Time::getCurrentTime();
+        item.lunaTask->setMemoryReserved(batch->isMemoryReserved);
+        item.lunaTask->setReplyCallback(boost::bind(&BatchLauncher::onItemReplied, this, batch->id, item.index, boost::placeholders::_1));
+
+        batch->running++;
+        LunaTaskList::getInstance().add(item.lunaTask);
+        ApplicationManager::getInstance().launch(item.lunaTask);
+    }
+
+    if (batch->completed == batch->items.size())
+        finish(batch);
+}
+
+void BatchLauncher::finish(BatchPtr batch)
+{
+    if (batch->isFinished)
+        return;
+    batch->isFinished = true;
+
+    JValue results = pbnjson::Array();
+    int failedCount = 0;
+    for (auto it = batch->items.begin(); it != batch->items.end(); ++it) {
+        if (!it->result.isObject() || !it->result["returnValue"].asBool())
+            failedCount++;
+        results.append(it->result);
+    }
+
+    int totalTime = (int)(Time::getCurrentTime() - batch->startTime);
+    LOG_INFO(getClassName(), __FUNCTION__,
+             Logger::format("batch(%d) completed: totalTime(%d) failed(%d/%d)",
+             batch->id, totalTime, failedCount, (int)batch->items.size()));
+
+    batch->lunaTask->getResponsePayload().put("results", results);
+    batch->lunaTask->getResponsePayload().put("memoryReserved", batch->isMemoryReserved);
+    batch->lunaTask->getResponsePayload().put("totalTime", totalTime);
+    m_batches.erase(batch->id);
+    LunaTaskList::getInstance().removeAfterReply(batch->lunaTask);
+}
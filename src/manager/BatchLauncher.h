@@ -0,0 +1,93 @@
+// Copyright (c) 2020 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#ifndef MANAGER_BATCHLAUNCHER_H_
+#define MANAGER_BATCHLAUNCHER_H_
+
+#include <iostream>
+#include <map>
+#include <memory>
+#include <vector>
+#include <pbnjson.hpp>
+
+#include "base/LunaTask.h"
+#include "interface/ISingleton.h"
+#include "interface/IClassName.h"
+
+using namespace std;
+using namespace pbnjson;
+
+// BatchLauncher runs several launch specs through the normal launch pipeline.
+//  - Memory for all apps which are not running yet is required from MemoryManager at once.
+//    If MemoryManager refuses it, each launch negotiates memory for itself as usual.
+//  - Items are started in priority order (higher first) and at most 'concurrency' launches are in progress.
+//  - The response has per-item results in request order and the total completion time.
+class BatchLauncher : public ISingleton<BatchLauncher>,
+                      public IClassName {
+friend class ISingleton<BatchLauncher>;
+public:
+    static const int DEFAULT_CONCURRENCY = 2;
+
+    virtual ~BatchLauncher();
+
+    void launch(LunaTaskPtr lunaTask);
+    void launchBootList();
+
+private:
+    struct Item {
+        int index;
+        int priority;
+        LunaTaskPtr lunaTask;
+        long long startTime;
+        JValue result;
+    };
+
+    struct Batch {
+        int id;
+        LunaTaskPtr lunaTask;
+        vector<Item> items;
+        // (priority, index of 'items') sorted by priority
+        vector<pair<int, int>> order;
+        size_t next;
+        int running;
+        size_t completed;
+        int concurrency;
+        int requiredMemory;
+        bool isMemoryReserved;
+        bool isFinished;
+        long long startTime;
+    };
+    typedef shared_ptr<Batch> BatchPtr;
+
+    static bool compareByPriority(const pair<int, int>& a, const pair<int, int>& b);
+
+    BatchLauncher();
+
+    void onRequireMemory(int batchId, LunaTaskPtr lunaTask);
+    void onRequireMemoryError(int batchId, LunaTaskPtr lunaTask);
+    void onItemReplied(int batchId, int index, LunaTaskPtr lunaTask);
+
+    BatchPtr getBatch(int batchId);
+    void dispatch(BatchPtr batch);
+    void finish(BatchPtr batch);
+
+    map<int, BatchPtr> m_batches;
+    int m_batchCounter;
+
+};
+
+#endif /* MANAGER_BATCHLAUNCHER_H_ */
@@ -0,0 +1,343 @@
+// Copyright (c) 2020 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#include "BulkTerminator.h"
+
+#include <set>
+#include <boost/bind.hpp>
+
+#include "base/LunaTaskList.h"
+#include "base/RunningAppList.h"
+#include "bus/client/AbsLifeHandler.h"
+#include "bus/service/ApplicationManager.h"
+#include "manager/TransitionTimer.h"
+#include "util/File.h"
+#include "util/JValueUtil.h"
+#include "util/Logger.h"
+#include "util/Time.h"
+
+BulkTerminator::BulkTerminator()
+    : m_batchCounter(0),
+      m_closedCount(0),
+      m_killedCount(0),
+      m_failedCount(0),
+      m_lastTotalTime(0)
+{
+    setClassName("BulkTerminator");
+}
+
+BulkTerminator::~BulkTerminator()
+{
+}
+
+void BulkTerminator::close(LunaTaskPtr lunaTask)
+{
+    const JValue& requestPayload = lunaTask->getRequestPayload();
+    JValue apps;
+    JValue excludes;
+    bool all = false;
+    bool force = false;
+    int timeout = DEFAULT_TIMEOUT;
+
+    JValueUtil::getValue(requestPayload, "all", all);
+    // Only SAM itself can close protected (keepAlive, resident) apps
+    if (lunaTask->isInternal())
+        JValueUtil::getValue(requestPayload, "force", force);
+    JValueUtil::getValue(requestPayload, "apps", apps);
+    JValueUtil::getValue(requestPayload, "excludes", excludes);
+    JValueUtil::getValue(requestPayload, "timeout", timeout);
+    if (!all && (!apps.isArray() || apps.arraySize() == 0)) {
+        lunaTask->setErrCodeAndText(ErrCode_INVALID_PAYLOAD, "apps should not be empty");
+        LunaTaskList::getInstance().removeAfterReply(lunaTask);
+        return;
+    }
+    if (timeout < 1)
+        timeout = DEFAULT_TIMEOUT;
+
+    BatchPtr batch = make_shared<Batch>();
+    batch->id = ++m_batchCounter;
+    batch->lunaTask = lunaTask;
+    batch->remaining = 0;
+    batch->timeout = timeout;
+    batch->escalation = 0;
+    batch->timer = 0;
+    batch->isIssuing = true;
+    batch->isFinished = false;
+    batch->startTime = Time::getCurrentTime();
+
+    // Collect targets first. Closing can remove apps from RunningAppList synchronously.
+    set<string> instanceIds;
+    vector<RunningAppPtr> runningApps;
+    if (all) {
+        set<string> excludedAppIds;
+        if (excludes.isArray()) {
+            for (int i = 0; i < excludes.arraySize(); ++i)
+                excludedAppIds.insert(excludes[i].asString());
+        }
+
+        const map<string, RunningAppPtr>& runningAppMap = RunningAppList::getInstance().getAll();
+        for (auto it = runningAppMap.begin(); it != runningAppMap.end(); ++it) {
+            if (excludedAppIds.find(it->second->getAppId()) != excludedAppIds.end())
+                continue;
+
+            Item item;
+            item.index = (int)batch->items.size();
+            item.instanceId = it->second->getInstanceId();
+            item.appId = it->second->getAppId();
+            item.isDone = false;
+            item.isKilled = false;
+            batch->items.push_back(item);
+            runningApps.push_back(it->second);
+        }
+    } else {
+        for (int i = 0; i < apps.arraySize(); ++i) {
+            string instanceId = "";
+            string appId = "";
+            JValueUtil::getValue(apps[i], "instanceId", instanceId);
+            JValueUtil::getValue(apps[i], "id", appId);
+
+            RunningAppPtr runningApp = nullptr;
+            if (!instanceId.empty())
+                runningApp = RunningAppList::getInstance().getByInstanceId(instanceId);
+            else if (!appId.empty())
+                runningApp = RunningAppList::getInstance().getByAppId(appId);
+
+            if (runningApp != nullptr && instanceIds.find(runningApp->getInstanceId()) != instanceIds.end())
+                continue;
+            if (runningApp != nullptr)
+                instanceIds.insert(runningApp->getInstanceId());
+
+            Item item;
+            item.index = (int)batch->items.size();
+            item.instanceId = runningApp ? runningApp->getInstanceId() : instanceId;
+            item.appId = runningApp ? runningApp->getAppId() : appId;
+            item.isDone = false;
+            item.isKilled = false;
+            batch->items.push_back(item);
+            runningApps.push_back(runningApp);
+        }
+    }
+
+    batch->remaining = batch->items.size();
+    m_batches[batch->id] = batch;
+
+    LOG_INFO(getClassName(), __FUNCTION__,
+             Logger::format("batch(%d) apps(%d) timeout(%d) reason(%s)",
+             batch->id, (int)batch->items.size(), timeout, lunaTask->getReason().c_str()));
+
+    // Every app update is folded into a single 'running' post
+    ApplicationManager::getInstance().deferRunningPost();
+
+    string closeMethod = File::join(ApplicationManager::CATEGORY_ROOT, ApplicationManager::METHOD_CLOSE);
+    for (size_t i = 0; i < batch->items.size(); ++i) {
+        Item& item = batch->items[i];
+        if (runningApps[i] == nullptr) {
+            complete(batch, item, "notRunning", (item.instanceId.empty() ? item.appId : item.instanceId) + " is not running");
+            continue;
+        }
+
+        JValue itemPayload = pbnjson::Object();
+        itemPayload.put("instanceId", item.instanceId);
+        itemPayload.put("reason", lunaTask->getReason());
+        if (force)
+            itemPayload.put("force", true);
+
+        // Memory pressure and user requests are handled differently in WAM
+        item.lunaTask = make_shared<LunaTask>(closeMethod, itemPayload);
+        item.lunaTask->setOrigin(*lunaTask);
+        item.lunaTask->setReplyCallback(boost::bind(&BulkTerminator::onItemReplied, this, batch->id, item.index, boost::placeholders::_1));
+
+        runningApps[i]->setBulkClosing(true);
+        LunaTaskList::getInstance().add(item.lunaTask);
+        ApplicationManager::getInstance().close(item.lunaTask);
+    }
+    batch->isIssuing = false;
+
+    if (batch->remaining == 0) {
+        finish(batch);
+        return;
+    }
+    batch->timer = TransitionTimer::getInstance().add(batch->timeout, boost::bind(&BulkTerminator::onEscalationTimer, this, batch->id));
+}
+
+void BulkTerminator::onRemove(RunningAppPtr runningApp)
+{
+    if (!runningApp->isBulkClosing())
+        return;
+
+    // complete() can finish and erase the batch
+    vector<BatchPtr> batches;
+    for (auto it = m_batches.begin(); it != m_batches.end(); ++it)
+        batches.push_back(it->second);
+
+    for (auto batch = batches.begin(); batch != batches.end(); ++batch) {
+        for (auto item = (*batch)->items.begin(); item != (*batch)->items.end(); ++item) {
+            if (item->isDone || item->instanceId != runningApp->getInstanceId())
+                continue;
+            complete(*batch, *item, item->isKilled ? "killed" : "closed");
+        }
+    }
+}
+
+void BulkTerminator::toJson(JValue& json)
+{
+    json.put("batches", (int)m_batches.size());
+    json.put("closed", m_closedCount);
+    json.put("killed", m_killedCount);
+    json.put("failed", m_failedCount);
+    json.put("lastTotalTime", m_lastTotalTime);
+}
+
+void BulkTerminator::onEscalationTimer(int batchId)
+{
+    BatchPtr batch = getBatch(batchId);
+    if (batch == nullptr)
+        return;
+
+    // kill() can remove the app synchronously and finish the batch
+    batch->timer = 0;
+    escalate(batch);
+    if (batch->isFinished)
+        return;
+
+    batch->timer = TransitionTimer::getInstance().add(batch->timeout, boost::bind(&BulkTerminator::onEscalationTimer, this, batch->id));
+}
+
+void BulkTerminator::onItemReplied(int batchId, int index, LunaTaskPtr lunaTask)
+{
+    BatchPtr batch = getBatch(batchId);
+    if (batch == nullptr)
+        return;
+
+    Item& item = batch->items[index];
+    if (item.isDone)
+        return;
+
+    RunningAppPtr runningApp = RunningAppList::getInstance().getByInstanceId(item.instanceId);
+    if (runningApp == nullptr) {
+        complete(batch, item, "closed");
+        return;
+    }
+
+    if (lunaTask->getErrCode() != ErrCode_NOERROR) {
+        // The app is killed by the escalation timer
+        Logger::warning(getClassName(), __FUNCTION__, item.instanceId,
+                        Logger::format("batch(%d) Failed to close: %s", batchId, lunaTask->getErrText().c_str()));
+        return;
+    }
+
+    // keepAlive apps can be paused instead of being closed
+    if (runningApp->getLifeStatus() != LifeStatus::LifeStatus_CLOSING) {
+        runningApp->setBulkClosing(false);
+        complete(batch, item, "paused");
+    }
+}
+
+BulkTerminator::BatchPtr BulkTerminator::getBatch(int batchId)
+{
+    auto it = m_batches.find(batchId);
+    if (it == m_batches.end())
+        return nullptr;
+    return it->second;
+}
+
+void BulkTerminator::complete(BatchPtr batch, Item& item, const string& status, const string& errorText)
+{
+    if (item.isDone)
+        return;
+    item.isDone = true;
+
+    JValue result = pbnjson::Object();
+    result.put("id", item.appId);
+    if (!item.instanceId.empty())
+        result.put("instanceId", item.instanceId);
+    result.put("status", status);
+    result.put("returnValue", errorText.empty());
+    if (!errorText.empty()) {
+        result.put("errorCode", ErrCode_CLOSE);
+        result.put("errorText", errorText);
+    }
+    result.put("closeTime", (int)(Time::getCurrentTime() - batch->startTime));
+    item.result = result;
+
+    if (status == "killed")
+        m_killedCount++;
+    else if (!errorText.empty())
+        m_failedCount++;
+    else
+        m_closedCount++;
+
+    batch->remaining--;
+    if (!batch->isIssuing && batch->remaining == 0)
+        finish(batch);
+}
+
+void BulkTerminator::escalate(BatchPtr batch)
+{
+    batch->escalation++;
+    for (auto item = batch->items.begin(); item != batch->items.end() && !batch->isFinished; ++item) {
+        if (item->isDone)
+            continue;
+
+        RunningAppPtr runningApp = RunningAppList::getInstance().getByInstanceId(item->instanceId);
+        if (runningApp == nullptr) {
+            complete(batch, *item, item->isKilled ? "killed" : "closed");
+            continue;
+        }
+        if (batch->escalation > MAX_ESCALATION) {
+            runningApp->setBulkClosing(false);
+            complete(batch, *item, "timeout", item->instanceId + " is not closed within timeout");
+            continue;
+        }
+
+        Logger::warning(getClassName(), __FUNCTION__, item->instanceId,
+                        Logger::format("batch(%d) Transition is timeout (%d)", batch->id, batch->escalation));
+        item->isKilled = true;
+        AbsLifeHandler::getLifeHandler(runningApp).kill(runningApp);
+    }
+}
+
+void BulkTerminator::finish(BatchPtr batch)
+{
+    if (batch->isFinished)
+        return;
+    batch->isFinished = true;
+
+    if (batch->timer > 0) {
+        TransitionTimer::getInstance().remove(batch->timer);
+        batch->timer = 0;
+    }
+
+    JValue results = pbnjson::Array();
+    int failedCount = 0;
+    for (auto it = batch->items.begin(); it != batch->items.end(); ++it) {
+        if (!it->result["returnValue"].asBool())
+            failedCount++;
+        results.append(it->result);
+    }
+
+    m_lastTotalTime = (int)(Time::getCurrentTime() - batch->startTime);
+    LOG_INFO(getClassName(), __FUNCTION__,
+             Logger::format("batch(%d) completed: totalTime(%d) failed(%d/%d)",
+             batch->id, m_lastTotalTime, failedCount, (int)batch->items.size()));
+
+    batch->lunaTask->getResponsePayload().put("results", results);
+    batch->lunaTask->getResponsePayload().put("totalTime", m_lastTotalTime);
+    m_batches.erase(batch->id);
+    ApplicationManager::getInstance().resumeRunningPost();
+    LunaTaskList::getInstance().removeAfterReply(batch->lunaTask);
+}
@@ -0,0 +1,99 @@
+// Copyright (c) 2020 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#ifndef MANAGER_BULKTERMINATOR_H_
+#define MANAGER_BULKTERMINATOR_H_
+
+#include <iostream>
+#include <map>
+#include <memory>
+#include <vector>
+#include <pbnjson.hpp>
+
+#include "base/LunaTask.h"
+#include "base/RunningApp.h"
+#include "interface/ISingleton.h"
+#include "interface/IClassName.h"
+
+using namespace std;
+using namespace pbnjson;
+
+// BulkTerminator closes several apps at once (memory pressure, close all).
+//  - All close requests are issued in the same main loop iteration. They don't wait for each other.
+//  - Apps in the batch don't have their own killing timers. A single timer kills the remaining apps.
+//  - 'running' is posted once after all apps are closed.
+//  - The response has per-app outcomes in request order and the total elapsed time.
+class BulkTerminator : public ISingleton<BulkTerminator>,
+                       public IClassName {
+friend class ISingleton<BulkTerminator>;
+public:
+    static const int DEFAULT_TIMEOUT = 1000; // 1 second
+    static const int MAX_ESCALATION = 3;
+
+    virtual ~BulkTerminator();
+
+    void close(LunaTaskPtr lunaTask);
+    void onRemove(RunningAppPtr runningApp);
+
+    void toJson(JValue& json);
+
+private:
+    struct Item {
+        int index;
+        string instanceId;
+        string appId;
+        LunaTaskPtr lunaTask;
+        bool isDone;
+        bool isKilled;
+        JValue result;
+    };
+
+    struct Batch {
+        int id;
+        LunaTaskPtr lunaTask;
+        vector<Item> items;
+        size_t remaining;
+        int timeout;
+        int escalation;
+        unsigned long timer;
+        bool isIssuing;
+        bool isFinished;
+        long long startTime;
+    };
+    typedef shared_ptr<Batch> BatchPtr;
+
+    BulkTerminator();
+
+    void onEscalationTimer(int batchId);
+    void onItemReplied(int batchId, int index, LunaTaskPtr lunaTask);
+
+    BatchPtr getBatch(int batchId);
+    void complete(BatchPtr batch, Item& item, const string& status, const string& errorText = "");
+    void escalate(BatchPtr batch);
+    void finish(BatchPtr batch);
+
+    map<int, BatchPtr> m_batches;
+    int m_batchCounter;
+
+    int m_closedCount;
+    int m_killedCount;
+    int m_failedCount;
+    int m_lastTotalTime;
+
+};
+
+#endif /* MANAGER_BULKTERMINATOR_H_ */
@@ -0,0 +1,186 @@
+// Copyright (c) 2020 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "FlightRecorder.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <glib.h>
+
+#include "Environment.h"
+#include "conf/SAMConf.h"
+#include "util/Logger.h"
+
+FlightRecorder::FlightRecorder()
+    : m_header(nullptr),
+      m_strings(nullptr),
+      m_records(nullptr),
+      m_mapSize(0),
+      m_mask(0),
+      m_overflowCount(0)
+{
+    setClassName("FlightRecorder");
+    // Index 0 is reserved for unknown or overflowed strings
+    m_texts.push_back("");
+}
+
+FlightRecorder::~FlightRecorder()
+{
+    finalize();
+}
+
+void FlightRecorder::initialize()
+{
+    if (m_header != nullptr)
+        return;
+
+    int capacity = SAMConf::getInstance().getFlightRecorderCapacity();
+    if (capacity <= 0) {
+        LOG_INFO(getClassName(), __FUNCTION__, "FlightRecorder is disabled");
+        return;
+    }
+    if (capacity > MAX_CAPACITY)
+        capacity = MAX_CAPACITY;
+    uint32_t ringSize = 1;
+    while (ringSize < (uint32_t)capacity)
+        ringSize <<= 1;
+
+    // The ring of the previous run is the most valuable one after a crash
+    if (access(PATH_FLIGHT_RECORDER, F_OK) == 0 && rename(PATH_FLIGHT_RECORDER, PATH_FLIGHT_RECORDER_PREV) == -1) {
+        Logger::warning(getClassName(), __FUNCTION__, Logger::format("Failed to keep previous ring: %s", strerror(errno)));
+    }
+
+    size_t mapSize = FLIGHT_HEADER_SIZE + sizeof(FlightString) * STRING_CAPACITY + sizeof(FlightRecord) * ringSize;
+    int fd = open(PATH_FLIGHT_RECORDER, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd == -1) {
+        Logger::error(getClassName(), __FUNCTION__, Logger::format("Failed to open %s: %s", PATH_FLIGHT_RECORDER, strerror(errno)));
+        return;
+    }
+    if (ftruncate(fd, mapSize) == -1) {
+        Logger::error(getClassName(), __FUNCTION__, Logger::format("Failed to resize %s: %s", PATH_FLIGHT_RECORDER, strerror(errno)));
+        close(fd);
+        return;
+    }
+    void* map = mmap(nullptr, mapSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        Logger::error(getClassName(), __FUNCTION__, Logger::format("Failed to map %s: %s", PATH_FLIGHT_RECORDER, strerror(errno)));
+        return;
+    }
+
+    // The file is filled with zero by ftruncate. Zero 'seq' means the record is not written yet
+    m_header = (FlightHeader*)map;
+    m_strings = (FlightString*)((char*)map + FLIGHT_HEADER_SIZE);
+    m_mapSize = mapSize;
+    m_mask = ringSize - 1;
+
+    m_header->magic = FLIGHT_MAGIC;
+    m_header->version = FLIGHT_VERSION;
+    m_header->recordSize = sizeof(FlightRecord);
+    m_header->capacity = ringSize;
+    m_header->stringCapacity = STRING_CAPACITY;
+    m_header->pid = getpid();
+    m_header->startRealTime = g_get_real_time();
+    m_header->startTime = Time::getCurrentTimeUs();
+    m_header->head = 0;
+
+    // Strings which were interned before initialization
+    for (unsigned int i = 1; i < m_texts.size(); ++i)
+        writeString(i);
+
+    m_records = (FlightRecord*)((char*)m_strings + sizeof(FlightString) * STRING_CAPACITY);
+    record(FlightRecordType_Start, 0, 0, getpid(), 0);
+    LOG_INFO(getClassName(), __FUNCTION__, Logger::format("capacity(%u) size(%d KB)", ringSize, (int)(mapSize / 1024)));
+}
+
+void FlightRecorder::finalize()
+{
+    if (m_header == nullptr)
+        return;
+
+    // The file is kept for the next run
+    munmap(m_header, m_mapSize);
+    m_header = nullptr;
+    m_strings = nullptr;
+    m_records = nullptr;
+    m_mapSize = 0;
+}
+
+unsigned int FlightRecorder::intern(const string& text)
+{
+    auto it = m_indexes.find(text);
+    if (it != m_indexes.end())
+        return it->second;
+
+    if (m_texts.size() >= (size_t)STRING_CAPACITY) {
+        m_overflowCount++;
+        return 0;
+    }
+
+    unsigned int index = m_texts.size();
+    m_texts.push_back(text);
+    m_indexes[text] = index;
+    if (m_header != nullptr)
+        writeString(index);
+    return index;
+}
+
+void FlightRecorder::recordLifeStatus(const string& appId, const char* oldStatus, const char* newStatus, int pid)
+{
+    if (m_records == nullptr)
+        return;
+    record(FlightRecordType_LifeStatus, intern(appId), intern(newStatus), intern(oldStatus), pid);
+}
+
+void FlightRecorder::recordChildExit(const string& appId, int pid, int status)
+{
+    if (m_records == nullptr)
+        return;
+    record(FlightRecordType_ChildExit, intern(appId), 0, pid, status);
+}
+
+void FlightRecorder::recordStall(const string& activity, int duration)
+{
+    if (m_records == nullptr)
+        return;
+    record(FlightRecordType_Stall, intern(activity), 0, duration, 0);
+}
+
+void FlightRecorder::toJson(JValue& json)
+{
+    json.put("enabled", m_header != nullptr);
+    if (m_header == nullptr)
+        return;
+
+    json.put("path", PATH_FLIGHT_RECORDER);
+    json.put("capacity", (int)m_header->capacity);
+    json.put("head", (int64_t)m_header->head);
+    json.put("strings", (int)m_texts.size());
+    json.put("overflowCount", m_overflowCount);
+}
+
+void FlightRecorder::writeString(unsigned int index)
+{
+    // Too long strings are truncated. They are still distinguished by their index
+    g_strlcpy(m_strings[index].text, m_texts[index].c_str(), FLIGHT_STRING_SIZE);
+    atomic_signal_fence(memory_order_release);
+    if (m_header->stringCount < index + 1)
+        m_header->stringCount = index + 1;
+}
@@ -0,0 +1,101 @@
+// Copyright (c) 2020 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef MANAGER_FLIGHTRECORDER_H_
+#define MANAGER_FLIGHTRECORDER_H_
+
+#include <iostream>
+#include <atomic>
+#include <unordered_map>
+#include <vector>
+#include <pbnjson.hpp>
+
+#include "interface/ISingleton.h"
+#include "interface/IClassName.h"
+#include "util/FlightRecord.h"
+#include "util/Time.h"
+
+using namespace std;
+using namespace pbnjson;
+
+// FlightRecorder keeps the latest lifecycle events in a ring of fixed-width records (util/FlightRecord.h).
+// The ring is a shared mapping of PATH_FLIGHT_RECORDER, so the kernel keeps it even if SAM crashes.
+// The file of the previous run is moved to PATH_FLIGHT_RECORDER_PREV when SAM starts.
+// Use 'sam-flight-decoder <file>' to read it.
+//
+// Strings are interned once and records only have their indexes. Frequent subjects (API methods)
+// should be interned in advance, so record() is only a few stores to the mapping.
+// Records are written only from the main loop.
+class FlightRecorder : public ISingleton<FlightRecorder>,
+                       public IClassName {
+friend class ISingleton<FlightRecorder>;
+public:
+    static const int DEFAULT_CAPACITY = 8192; // records
+    static const int MAX_CAPACITY = 1048576;
+    static const int STRING_CAPACITY = 1024;
+
+    virtual ~FlightRecorder();
+
+    void initialize();
+    void finalize();
+
+    // Returns 0 (empty string) if the string table is full
+    unsigned int intern(const string& text);
+
+    void record(FlightRecordType type, unsigned int subject, unsigned int detail, int arg0, int arg1)
+    {
+        if (m_records == nullptr)
+            return;
+
+        uint64_t seq = m_header->head + 1;
+        FlightRecord& record = m_records[seq & m_mask];
+        record.seq = 0;
+        atomic_signal_fence(memory_order_release);
+        record.type = (uint8_t)type;
+        record.time = Time::getCurrentTimeUs();
+        record.subject = subject;
+        record.detail = detail;
+        record.arg0 = arg0;
+        record.arg1 = arg1;
+        atomic_signal_fence(memory_order_release);
+        record.seq = (uint32_t)seq;
+        m_header->head = seq;
+    }
+
+    void recordLifeStatus(const string& appId, const char* oldStatus, const char* newStatus, int pid);
+    void recordChildExit(const string& appId, int pid, int status);
+    void recordStall(const string& activity, int duration);
+
+    void toJson(JValue& json);
+
+private:
+    FlightRecorder();
+
+    void writeString(unsigned int index);
+
+    FlightHeader* m_header;
+    FlightString* m_strings;
+    FlightRecord* m_records;
+    size_t m_mapSize;
+    uint64_t m_mask;
+
+    unordered_map<string, unsigned int> m_indexes;
+    vector<string> m_texts;
+    int m_overflowCount;
+
+};
+
+#endif /* MANAGER_FLIGHTRECORDER_H_ */
@@ -0,0 +1,156 @@
+// Copyright (c) 2020 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#include "LaunchStatistics.h"
+
+#include "Environment.h"
+#include "conf/Persistence.h"
+#include "util/JValueUtil.h"
+#include "util/Logger.h"
+
+gboolean LaunchStatistics::onSave(gpointer data)
+{
+    getInstance().m_saveTimer = 0;
+    getInstance().save();
+    return G_SOURCE_REMOVE;
+}
+
+LaunchStatistics::LaunchStatistics()
+    : m_saveTimer(0)
+{
+    setClassName("LaunchStatistics");
+}
+
+LaunchStatistics::~LaunchStatistics()
+{
+}
+
+void LaunchStatistics::initialize()
+{
+    load();
+}
+
+void LaunchStatistics::finalize()
+{
+    if (m_saveTimer != 0) {
+        g_source_remove(m_saveTimer);
+        m_saveTimer = 0;
+        save();
+    }
+}
+
+void LaunchStatistics::add(const string& appId, LaunchStage stage, long long elapsed)
+{
+    if (stage >= LaunchStage::LaunchStage_MAX)
+        return;
+
+    m_global.histograms[(int)stage].add(elapsed);
+    m_apps[appId].histograms[(int)stage].add(elapsed);
+
+    // Saving is delayed to merge updates of several stages and launches
+    if (m_saveTimer == 0) {
+        m_saveTimer = g_timeout_add_seconds(SAVE_DELAY, onSave, nullptr);
+    }
+}
+
+void LaunchStatistics::reset()
+{
+    m_global = StageHistograms();
+    m_apps.clear();
+    save();
+}
+
+long long LaunchStatistics::getMedian(const string& appId, LaunchStage stage)
+{
+    if (stage >= LaunchStage::LaunchStage_MAX)
+        return -1;
+
+    auto it = m_apps.find(appId);
+    if (it != m_apps.end() && it->second.histograms[(int)stage].getCount() > 0)
+        return it->second.histograms[(int)stage].getPercentile(50);
+    if (m_global.histograms[(int)stage].getCount() > 0)
+        return m_global.histograms[(int)stage].getPercentile(50);
+    return -1;
+}
+
+void LaunchStatistics::toJson(JValue& json, const string& appId)
+{
+    JValue global = pbnjson::Object();
+    toJson(m_global, global);
+    json.put("global", global);
+
+    JValue apps = pbnjson::Object();
+    for (auto it = m_apps.begin(); it != m_apps.end(); ++it) {
+        if (!appId.empty() && appId != it->first)
+            continue;
+
+        JValue app = pbnjson::Object();
+        toJson(it->second, app);
+        apps.put(it->first, app);
+    }
+    json.put("apps", apps);
+}
+
+void LaunchStatistics::load()
+{
+    JValue json = JDomParser::fromFile(PATH_LAUNCH_STATISTICS);
+    if (json.isNull() || !json.isObject()) {
+        LOG_INFO(getClassName(), __FUNCTION__, PATH_LAUNCH_STATISTICS, "No saved statistics");
+        return;
+    }
+
+    JValue global;
+    if (JValueUtil::getValue(json, "global", global)) {
+        fromJson(global, m_global);
+    }
+
+    JValue apps;
+    if (JValueUtil::getValue(json, "apps", apps) && apps.isObject()) {
+        for (JValue::KeyValue app : apps.children()) {
+            fromJson(app.second, m_apps[app.first.asString()]);
+        }
+    }
+}
+
+void LaunchStatistics::save()
+{
+    JValue json = pbnjson::Object();
+    toJson(json);
+    Persistence::getInstance().write(PATH_LAUNCH_STATISTICS, json);
+}
+
+void LaunchStatistics::toJson(const StageHistograms& stages, JValue& json)
+{
+    for (int i = 0; i < (int)LaunchStage::LaunchStage_MAX; ++i) {
+        if (stages.histograms[i].getCount() == 0)
+            continue;
+
+        JValue histogram = pbnjson::Object();
+        stages.histograms[i].toJson(histogram);
+        json.put(LaunchTrace::toString((LaunchStage)i), histogram);
+    }
+}
+
+void LaunchStatistics::fromJson(const JValue& json, StageHistograms& stages)
+{
+    for (int i = 0; i < (int)LaunchStage::LaunchStage_MAX; ++i) {
+        JValue histogram;
+        if (JValueUtil::getValue(json, LaunchTrace::toString((LaunchStage)i), histogram)) {
+            stages.histograms[i].fromJson(histogram);
+        }
+    }
+}
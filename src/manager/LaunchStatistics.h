@@ -0,0 +1,76 @@
+// Copyright (c) 2020 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#ifndef MANAGER_LAUNCHSTATISTICS_H_
+#define MANAGER_LAUNCHSTATISTICS_H_
+
+#include <iostream>
+#include <map>
+#include <glib.h>
+#include <pbnjson.hpp>
+
+#include "base/LaunchTrace.h"
+#include "interface/ISingleton.h"
+#include "interface/IClassName.h"
+#include "util/Histogram.h"
+
+using namespace std;
+using namespace pbnjson;
+
+// LaunchStatistics aggregates LaunchTrace into per-app and global histograms.
+// Histograms are persisted, so regression can be tracked across restarts.
+class LaunchStatistics : public ISingleton<LaunchStatistics>,
+                         public IClassName {
+friend class ISingleton<LaunchStatistics>;
+public:
+    virtual ~LaunchStatistics();
+
+    void initialize();
+    void finalize();
+
+    void add(const string& appId, LaunchStage stage, long long elapsed);
+    void reset();
+
+    // Returns median (ms) of the stage. Global histogram is used if the app has no sample. -1 if nothing
+    long long getMedian(const string& appId, LaunchStage stage);
+
+    void toJson(JValue& json, const string& appId = "");
+
+private:
+    static const int SAVE_DELAY = 30;
+
+    static gboolean onSave(gpointer data);
+
+    struct StageHistograms {
+        Histogram histograms[(int)LaunchStage::LaunchStage_MAX];
+    };
+
+    LaunchStatistics();
+
+    void load();
+    void save();
+
+    static void toJson(const StageHistograms& stages, JValue& json);
+    static void fromJson(const JValue& json, StageHistograms& stages);
+
+    StageHistograms m_global;
+    map<string, StageHistograms> m_apps;
+    guint m_saveTimer;
+
+};
+
+#endif /* MANAGER_LAUNCHSTATISTICS_H_ */
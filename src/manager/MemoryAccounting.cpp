@@ -0,0 +1,168 @@
+// Copyright (c) 2020 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "MemoryAccounting.h"
+
+#include <malloc.h>
+#include <unistd.h>
+#include <algorithm>
+
+#include "base/AppDescriptionList.h"
+#include "base/LaunchPointList.h"
+#include "base/LunaTaskList.h"
+#include "base/RunningAppList.h"
+#include "bus/service/ApplicationManager.h"
+#include "manager/NativeLogManager.h"
+#include "util/Logger.h"
+#include "util/ProcFs.h"
+
+// mallinfo() overflows over 2GB. mallinfo2() is available since glibc 2.33
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+#define HAS_MALLINFO2
+#endif
+
+bool MemoryAccounting::compareByTotal(const AppUsage& a, const AppUsage& b)
+{
+    return a.total > b.total;
+}
+
+MemoryAccounting::MemoryAccounting()
+{
+    setClassName("MemoryAccounting");
+}
+
+MemoryAccounting::~MemoryAccounting()
+{
+}
+
+void MemoryAccounting::toJson(JValue& json, int top)
+{
+    map<string, AppUsage> apps;
+
+    size_t appDescriptions = 0;
+    const map<string, AppDescriptionPtr>& appDescs = AppDescriptionList::getInstance().getAll();
+    for (auto it = appDescs.begin(); it != appDescs.end(); ++it) {
+        size_t usage = it->second->getMemoryUsage();
+        apps[it->first].appDescription += usage;
+        appDescriptions += usage;
+    }
+
+    size_t launchPoints = 0;
+    const list<LaunchPointPtr>& launchPointList = LaunchPointList::getInstance().getAll();
+    for (auto it = launchPointList.begin(); it != launchPointList.end(); ++it) {
+        size_t usage = (*it)->getMemoryUsage();
+        apps[(*it)->getAppId()].launchPoints += usage;
+        launchPoints += usage;
+    }
+
+    size_t runningApps = 0;
+    const map<string, RunningAppPtr>& runningAppMap = RunningAppList::getInstance().getAll();
+    for (auto it = runningAppMap.begin(); it != runningAppMap.end(); ++it) {
+        size_t usage = it->second->getMemoryUsage();
+        apps[it->second->getAppId()].runningApps += usage;
+        runningApps += usage;
+    }
+
+    size_t lunaTasks = 0;
+    const list<LunaTaskPtr>& lunaTaskList = LunaTaskList::getInstance().getAll();
+    for (auto it = lunaTaskList.begin(); it != lunaTaskList.end(); ++it)
+        lunaTasks += (*it)->getMemoryUsage();
+
+    int subscriberCount = ApplicationManager::getInstance().getSubscriberCount();
+    size_t subscriptions = (size_t)subscriberCount * SUBSCRIBER_SIZE;
+    size_t logger = Logger::getInstance().getMemoryUsage();
+    size_t nativeLogs = NativeLogManager::getInstance().getMemoryUsage();
+
+    JValue item = pbnjson::Object();
+    item.put("count", (int)appDescs.size());
+    item.put("bytes", (int64_t)appDescriptions);
+    json.put("appDescriptions", item);
+
+    item = pbnjson::Object();
+    item.put("count", (int)launchPointList.size());
+    item.put("bytes", (int64_t)launchPoints);
+    json.put("launchPoints", item);
+
+    item = pbnjson::Object();
+    item.put("count", (int)runningAppMap.size());
+    item.put("bytes", (int64_t)runningApps);
+    json.put("runningApps", item);
+
+    item = pbnjson::Object();
+    item.put("count", (int)lunaTaskList.size());
+    item.put("bytes", (int64_t)lunaTasks);
+    json.put("lunaTasks", item);
+
+    item = pbnjson::Object();
+    item.put("count", subscriberCount);
+    item.put("bytes", (int64_t)subscriptions);
+    json.put("subscriptions", item);
+
+    item = pbnjson::Object();
+    item.put("bytes", (int64_t)logger);
+    item.put("nativeLogBytes", (int64_t)nativeLogs);
+    json.put("logger", item);
+
+    size_t total = appDescriptions + launchPoints + runningApps + lunaTasks + subscriptions + logger + nativeLogs;
+    json.put("total", (int64_t)total);
+
+    JValue allocator = pbnjson::Object();
+    toAllocatorJson(allocator);
+    json.put("allocator", allocator);
+
+    // KB
+    JValue process = pbnjson::Object();
+    process.put("rss", (int64_t)ProcFs::getProcessRss(getpid()));
+    process.put("pss", (int64_t)ProcFs::getProcessPss(getpid()));
+    json.put("process", process);
+
+    vector<AppUsage> usages;
+    for (auto it = apps.begin(); it != apps.end(); ++it) {
+        AppUsage usage = it->second;
+        usage.appId = it->first;
+        usage.total = usage.appDescription + usage.launchPoints + usage.runningApps;
+        usages.push_back(usage);
+    }
+    sort(usages.begin(), usages.end(), compareByTotal);
+
+    if (top <= 0)
+        top = DEFAULT_TOP;
+    JValue topApps = pbnjson::Array();
+    for (auto it = usages.begin(); it != usages.end() && topApps.arraySize() < top; ++it) {
+        JValue app = pbnjson::Object();
+        app.put("appId", it->appId);
+        app.put("appDescription", (int64_t)it->appDescription);
+        app.put("launchPoints", (int64_t)it->launchPoints);
+        app.put("runningApps", (int64_t)it->runningApps);
+        app.put("bytes", (int64_t)it->total);
+        topApps.append(app);
+    }
+    json.put("apps", topApps);
+}
+
+void MemoryAccounting::toAllocatorJson(JValue& json)
+{
+#ifdef HAS_MALLINFO2
+    struct mallinfo2 info = mallinfo2();
+#else
+    struct mallinfo info = mallinfo();
+#endif
+    json.put("arena", (int64_t)info.arena);
+    json.put("mmap", (int64_t)info.hblkhd);
+    json.put("inUse", (int64_t)info.uordblks);
+    json.put("free", (int64_t)info.fordblks);
+    json.put("releasable", (int64_t)info.keepcost);
+}
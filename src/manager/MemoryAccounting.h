@@ -0,0 +1,64 @@
+// Copyright (c) 2020 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef MANAGER_MEMORYACCOUNTING_H_
+#define MANAGER_MEMORYACCOUNTING_H_
+
+#include <iostream>
+#include <vector>
+#include <pbnjson.hpp>
+
+#include "interface/ISingleton.h"
+#include "interface/IClassName.h"
+
+using namespace std;
+using namespace pbnjson;
+
+// MemoryAccounting reports approximate heap bytes held by SAM structures.
+// Sizes are estimated from object sizes, string capacities and DOM nodes, so they are lower bounds.
+// The difference with 'allocator.inUse' is the memory of libraries and untracked structures.
+// Walking all DOMs is not cheap. It is done only when 'dev/memory' is called.
+class MemoryAccounting : public ISingleton<MemoryAccounting>,
+                         public IClassName {
+friend class ISingleton<MemoryAccounting>;
+public:
+    static const int DEFAULT_TOP = 10;
+    // LSMessage and subscription list entry which are kept by luna-service2 per subscriber
+    static const int SUBSCRIBER_SIZE = 256;
+
+    virtual ~MemoryAccounting();
+
+    // 'top' is the number of apps in 'apps'. They are sorted by bytes
+    void toJson(JValue& json, int top);
+
+private:
+    struct AppUsage {
+        string appId;
+        size_t appDescription;
+        size_t launchPoints;
+        size_t runningApps;
+        size_t total;
+    };
+
+    static bool compareByTotal(const AppUsage& a, const AppUsage& b);
+
+    MemoryAccounting();
+
+    void toAllocatorJson(JValue& json);
+
+};
+
+#endif /* MANAGER_MEMORYACCOUNTING_H_ */
@@ -0,0 +1,89 @@
+// Copyright (c) 2020 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#include "MemoryEstimator.h"
+
+#include "base/RunningAppList.h"
+#include "conf/SAMConf.h"
+#include "util/Logger.h"
+
+MemoryEstimator::MemoryEstimator()
+{
+    setClassName("MemoryEstimator");
+}
+
+MemoryEstimator::~MemoryEstimator()
+{
+}
+
+void MemoryEstimator::initialize()
+{
+    m_footprints = SAMConf::getInstance().getMemoryFootprints();
+}
+
+int MemoryEstimator::getRequiredMemory(AppDescriptionPtr appDesc)
+{
+    // appinfo has higher priority than the estimate
+    int requiredMemory = appDesc->getRequiredMemory();
+    if (requiredMemory > 0)
+        return requiredMemory;
+
+    if (JValueUtil::getValue(m_footprints, appDesc->getAppId(), requiredMemory) && requiredMemory > 0)
+        return requiredMemory;
+    return DEFAULT_REQUIRED_MEMORY;
+}
+
+void MemoryEstimator::onSample(RunningAppPtr runningApp, long memory)
+{
+    runningApp->setPeakMemory(memory);
+}
+
+void MemoryEstimator::onRemove(RunningAppPtr runningApp)
+{
+    // Short-lived apps are not sampled at all
+    if (runningApp->getPeakMemory() <= 0)
+        return;
+
+    int peak = (int)((runningApp->getPeakMemory() + 1023) / 1024);
+    int estimate = 0;
+    if (!JValueUtil::getValue(m_footprints, runningApp->getAppId(), estimate) || peak >= estimate) {
+        estimate = peak;
+    } else {
+        estimate -= (estimate - peak) * DECAY_PERCENT / 100;
+    }
+
+    LOG_INFO(getClassName(), __FUNCTION__, runningApp->getAppId(), Logger::format("peak(%d MB) estimate(%d MB)", peak, estimate));
+    m_footprints.put(runningApp->getAppId(), estimate);
+    SAMConf::getInstance().setMemoryFootprints(m_footprints);
+}
+
+void MemoryEstimator::toJson(JValue& json)
+{
+    json.put("footprints", m_footprints.duplicate());
+
+    JValue running = pbnjson::Array();
+    const map<string, RunningAppPtr>& runningApps = RunningAppList::getInstance().getAll();
+    for (auto it = runningApps.begin(); it != runningApps.end(); ++it) {
+        JValue item = pbnjson::Object();
+        item.put("instanceId", it->second->getInstanceId());
+        item.put("appId", it->second->getAppId());
+        item.put("peakMemory", (int)it->second->getPeakMemory());
+        item.put("requiredMemory", getRequiredMemory(it->second->getLaunchPoint()->getAppDesc()));
+        running.append(item);
+    }
+    json.put("running", running);
+}
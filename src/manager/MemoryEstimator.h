@@ -0,0 +1,63 @@
+// Copyright (c) 2020 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#ifndef MANAGER_MEMORYESTIMATOR_H_
+#define MANAGER_MEMORYESTIMATOR_H_
+
+#include <iostream>
+#include <pbnjson.hpp>
+
+#include "base/AppDescription.h"
+#include "base/RunningApp.h"
+#include "interface/ISingleton.h"
+#include "interface/IClassName.h"
+
+using namespace std;
+using namespace pbnjson;
+
+// MemoryEstimator learns memory footprint of each app.
+// Peak memory of the process tree is sampled by ResourceSampler while the app is running,
+// and it is applied to the estimate when the app is closed.
+// The estimate grows immediately and decays slowly.
+class MemoryEstimator : public ISingleton<MemoryEstimator>,
+                        public IClassName {
+friend class ISingleton<MemoryEstimator>;
+public:
+    virtual ~MemoryEstimator();
+
+    void initialize();
+
+    // Returns MB which should be secured before launching the app
+    int getRequiredMemory(AppDescriptionPtr appDesc);
+
+    // 'memory' (KB) is the current footprint of the app
+    void onSample(RunningAppPtr runningApp, long memory);
+    void onRemove(RunningAppPtr runningApp);
+
+    void toJson(JValue& json);
+
+private:
+    static const int DEFAULT_REQUIRED_MEMORY = 150;
+    static const int DECAY_PERCENT = 20;
+
+    MemoryEstimator();
+
+    JValue m_footprints;
+
+};
+
+#endif /* MANAGER_MEMORYESTIMATOR_H_ */
@@ -0,0 +1,284 @@
+// Copyright (c) 2020 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#include "NativeLogManager.h"
+
+#include <algorithm>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "Environment.h"
+#include "conf/RuntimeInfo.h"
+#include "conf/SAMConf.h"
+#include "util/File.h"
+#include "util/Logger.h"
+
+gboolean NativeLogManager::onRead(GIOChannel* channel, GIOCondition condition, gpointer data)
+{
+    NativeLogManager& self = getInstance();
+    int fd = GPOINTER_TO_INT(data);
+
+    auto it = self.m_captures.find(fd);
+    if (it == self.m_captures.end())
+        return FALSE;
+
+    if (self.drain(fd))
+        return TRUE;
+
+    // Returning FALSE removes the watch
+    it->second.watch = 0;
+    self.detach(fd);
+    return FALSE;
+}
+
+NativeLogManager::NativeLogManager()
+    : m_isEnabled(false),
+      m_bufferSize(0),
+      m_readBytes(0),
+      m_flushCount(0)
+{
+    setClassName("NativeLogManager");
+}
+
+NativeLogManager::~NativeLogManager()
+{
+}
+
+void NativeLogManager::initialize()
+{
+    m_isEnabled = SAMConf::getInstance().isNativeLogCaptureEnabled();
+    m_bufferSize = SAMConf::getInstance().getNativeLogBufferSize() * 1024;
+    LOG_INFO(getClassName(), __FUNCTION__, Logger::format("enabled(%d) bufferSize(%d)", m_isEnabled, (int)m_bufferSize));
+}
+
+void NativeLogManager::finalize()
+{
+    while (!m_captures.empty()) {
+        detach(m_captures.begin()->first);
+    }
+}
+
+void NativeLogManager::attach(const string& appId, pid_t pid, int fd)
+{
+    if (fd < 0)
+        return;
+
+    int flags = fcntl(fd, F_GETFL);
+    if (flags == -1 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) == -1) {
+        Logger::warning(getClassName(), __FUNCTION__, appId, strerror(errno));
+    }
+
+    start(appId, pid);
+
+    Capture capture;
+    capture.appId = appId;
+    capture.pid = pid;
+    capture.channel = g_io_channel_unix_new(fd);
+    capture.watch = g_io_add_watch(capture.channel, (GIOCondition)(G_IO_IN | G_IO_HUP | G_IO_ERR), onRead, GINT_TO_POINTER(fd));
+    m_captures[fd] = capture;
+}
+
+void NativeLogManager::reassign(pid_t pid, const string& appId)
+{
+    for (auto it = m_captures.begin(); it != m_captures.end(); ++it) {
+        if (it->second.pid != pid)
+            continue;
+
+        // Output of the idle runner belongs to nobody
+        string runnerName = it->second.appId;
+        drain(it->first);
+        it->second.appId = appId;
+        if (!isCapturing(runnerName))
+            m_buffers.erase(runnerName);
+        start(appId, pid);
+        return;
+    }
+}
+
+void NativeLogManager::onExit(const string& appId, pid_t pid, int status)
+{
+    // Read what is left in the pipe. The pipe is closed when all descendants release it
+    for (auto it = m_captures.begin(); it != m_captures.end(); ++it) {
+        if (it->second.pid == pid) {
+            drain(it->first);
+            break;
+        }
+    }
+
+    m_exitedApps.erase(std::remove(m_exitedApps.begin(), m_exitedApps.end(), appId), m_exitedApps.end());
+    m_exitedApps.push_back(appId);
+    trim();
+
+    bool isCrashed = false;
+    if (WIFSIGNALED(status)) {
+        isCrashed = (WTERMSIG(status) != SIGTERM && WTERMSIG(status) != SIGKILL);
+    } else if (WIFEXITED(status)) {
+        isCrashed = (WEXITSTATUS(status) != 0);
+    }
+    if (!isCrashed)
+        return;
+
+    string path = flush(appId);
+    Logger::warning(getClassName(), __FUNCTION__, appId,
+                    Logger::format("Process(%d) exited abnormally with status(%d). Log is written to %s", pid, status, path.c_str()));
+}
+
+void NativeLogManager::remove(const string& appId)
+{
+    m_exitedApps.erase(std::remove(m_exitedApps.begin(), m_exitedApps.end(), appId), m_exitedApps.end());
+    if (!isCapturing(appId))
+        m_buffers.erase(appId);
+}
+
+string NativeLogManager::flush(const string& appId)
+{
+    auto it = m_buffers.find(appId);
+    if (it == m_buffers.end() || it->second.getSize() == 0)
+        return "";
+
+    string path;
+    if (RuntimeInfo::getInstance().getUser().empty())
+        path = Logger::format("%s/%s.log", PATH_NATIVE_LOG, appId.c_str());
+    else
+        path = Logger::format("%s/%s-%s.log", PATH_NATIVE_LOG, appId.c_str(), RuntimeInfo::getInstance().getUser().c_str());
+
+    if (!File::writeFile(path, it->second.toString())) {
+        Logger::error(getClassName(), __FUNCTION__, path, "Failed to write log");
+        return "";
+    }
+    m_flushCount++;
+    return path;
+}
+
+bool NativeLogManager::toJson(const string& appId, JValue& json)
+{
+    auto it = m_buffers.find(appId);
+    if (it == m_buffers.end())
+        return false;
+
+    // Logs which are not delivered to the main loop yet
+    bool isCapturing = false;
+    for (auto capture = m_captures.begin(); capture != m_captures.end(); ++capture) {
+        if (capture->second.appId == appId) {
+            drain(capture->first);
+            isCapturing = true;
+        }
+    }
+
+    json.put("id", appId);
+    json.put("capturing", isCapturing);
+    json.put("size", (int)it->second.getSize());
+    json.put("dropped", (int64_t)it->second.getDropped());
+    json.put("log", it->second.toString());
+    return true;
+}
+
+void NativeLogManager::toJson(JValue& json)
+{
+    JValue apps = pbnjson::Array();
+    for (auto it = m_buffers.begin(); it != m_buffers.end(); ++it) {
+        JValue app = pbnjson::Object();
+        app.put("id", it->first);
+        app.put("size", (int)it->second.getSize());
+        app.put("dropped", (int64_t)it->second.getDropped());
+        apps.append(app);
+    }
+
+    json.put("enabled", m_isEnabled);
+    json.put("bufferSize", (int)m_bufferSize);
+    json.put("captures", (int)m_captures.size());
+    json.put("readBytes", (int64_t)m_readBytes);
+    json.put("flushCount", m_flushCount);
+    json.put("apps", apps);
+}
+
+size_t NativeLogManager::getMemoryUsage()
+{
+    size_t usage = 0;
+    for (auto it = m_buffers.begin(); it != m_buffers.end(); ++it)
+        usage += sizeof(RingBuffer) + it->first.capacity() + it->second.getCapacity();
+    return usage;
+}
+
+void NativeLogManager::start(const string& appId, pid_t pid)
+{
+    m_exitedApps.erase(std::remove(m_exitedApps.begin(), m_exitedApps.end(), appId), m_exitedApps.end());
+
+    RingBuffer& buffer = m_buffers[appId];
+    buffer.setCapacity(m_bufferSize);
+    string marker = Logger::format("--- %s(%d) started ---\n", appId.c_str(), pid);
+    buffer.append(marker.c_str(), marker.size());
+}
+
+bool NativeLogManager::isCapturing(const string& appId)
+{
+    for (auto it = m_captures.begin(); it != m_captures.end(); ++it) {
+        if (it->second.appId == appId)
+            return true;
+    }
+    return false;
+}
+
+void NativeLogManager::trim()
+{
+    while (m_exitedApps.size() > MAX_EXITED_APPS) {
+        const string& appId = m_exitedApps.front();
+        if (!isCapturing(appId))
+            m_buffers.erase(appId);
+        m_exitedApps.pop_front();
+    }
+}
+
+bool NativeLogManager::drain(int fd)
+{
+    auto it = m_captures.find(fd);
+    if (it == m_captures.end())
+        return false;
+
+    RingBuffer& buffer = m_buffers[it->second.appId];
+    char data[4096];
+    while (true) {
+        ssize_t length = read(fd, data, sizeof(data));
+        if (length > 0) {
+            buffer.append(data, length);
+            m_readBytes += length;
+            continue;
+        }
+        if (length == 0)
+            return false;
+        if (errno == EINTR)
+            continue;
+        return (errno == EAGAIN || errno == EWOULDBLOCK);
+    }
+}
+
+void NativeLogManager::detach(int fd)
+{
+    auto it = m_captures.find(fd);
+    if (it == m_captures.end())
+        return;
+
+    if (it->second.watch != 0)
+        g_source_remove(it->second.watch);
+    g_io_channel_unref(it->second.channel);
+    close(fd);
+    m_captures.erase(it);
+}
@@ -0,0 +1,104 @@
+// Copyright (c) 2020 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#ifndef MANAGER_NATIVELOGMANAGER_H_
+#define MANAGER_NATIVELOGMANAGER_H_
+
+#include <deque>
+#include <iostream>
+#include <map>
+#include <glib.h>
+#include <pbnjson.hpp>
+
+#include "interface/ISingleton.h"
+#include "interface/IClassName.h"
+#include "util/RingBuffer.h"
+
+using namespace std;
+using namespace pbnjson;
+
+// NativeLogManager captures stdout/stderr of native apps through a pipe.
+// Output is kept in a bounded ring buffer per app instead of a file in /var/log.
+// Pipes are drained in the main loop. Buffers are written to disk only when
+// the app crashes or when it is requested through 'getAppLogs'.
+// Buffers of only the last MAX_EXITED_APPS exited apps are kept.
+class NativeLogManager : public ISingleton<NativeLogManager>,
+                         public IClassName {
+friend class ISingleton<NativeLogManager>;
+public:
+    static const size_t MAX_EXITED_APPS = 5;
+
+    virtual ~NativeLogManager();
+
+    void initialize();
+    void finalize();
+
+    bool isEnabled() const
+    {
+        return m_isEnabled;
+    }
+
+    // Takes ownership of 'fd' which is the read end of the app's stdout/stderr pipe
+    void attach(const string& appId, pid_t pid, int fd);
+    // Idle runner is captured with the runner name until it is handed over to an app
+    void reassign(pid_t pid, const string& appId);
+    void onExit(const string& appId, pid_t pid, int status);
+    // The app is uninstalled
+    void remove(const string& appId);
+
+    // Returns the path of the written file. It is empty if there is nothing to write
+    string flush(const string& appId);
+
+    bool toJson(const string& appId, JValue& json);
+    void toJson(JValue& json);
+
+    // Capacity of all ring buffers
+    size_t getMemoryUsage();
+
+private:
+    static gboolean onRead(GIOChannel* channel, GIOCondition condition, gpointer data);
+
+    struct Capture {
+        string appId;
+        pid_t pid;
+        GIOChannel* channel;
+        guint watch;
+    };
+
+    NativeLogManager();
+
+    // Returns false if the pipe is closed
+    bool drain(int fd);
+    void detach(int fd);
+
+    void start(const string& appId, pid_t pid);
+    bool isCapturing(const string& appId);
+    void trim();
+
+    map<int, Capture> m_captures;
+    map<string, RingBuffer> m_buffers;
+    // Oldest first
+    deque<string> m_exitedApps;
+
+    bool m_isEnabled;
+    size_t m_bufferSize;
+    unsigned long long m_readBytes;
+    int m_flushCount;
+
+};
+
+#endif /* MANAGER_NATIVELOGMANAGER_H_ */
@@ -20,6 +20,10 @@
 #include "bus/client/WAM.h"
 #include "bus/client/NativeContainer.h"
 #include "bus/client/MemoryManager.h"
+#include "manager/MemoryEstimator.h"
+#include "manager/PreloadManager.h"
+#include "manager/ResidentAppManager.h"
+#include "util/Tracer.h"
 
 PolicyManager::PolicyManager()
 {
@@ -32,9 +36,17 @@ PolicyManager::~PolicyManager()
 
 void PolicyManager::launch(LunaTaskPtr lunaTask)
 {
+    TRACE_SCOPE("policy", __FUNCTION__, lunaTask->getId().c_str(), lunaTask->getTraceId());
     pre(lunaTask);
 
+    // Coalesced requests follow the launch even if it is restarted with new instance (relaunch of native app)
     string instanceId = RunningApp::generateInstanceId(lunaTask->getDisplayId());
+    auto old = m_inFlightLaunches.find(lunaTask->getInstanceId());
+    if (old != m_inFlightLaunches.end() && old->second.primary == lunaTask) {
+        m_inFlightLaunches[instanceId] = old->second;
+        m_inFlightLaunches[instanceId].isRelaunching = false;
+        m_inFlightLaunches.erase(old);
+    }
     lunaTask->setInstanceId(instanceId);
     RunningAppPtr runningApp = RunningAppList::getInstance().createByLunaTask(lunaTask);
     if (runningApp == nullptr) {
@@ -47,15 +59,46 @@ void PolicyManager::launch(LunaTaskPtr lunaTask)
         lunaTask->error(lunaTask);
         return;
     }
+    // Failures from here are replied through onReplyWithIds. It releases the entry with followers.
+    InFlightLaunch& inFlight = m_inFlightLaunches[instanceId];
+    inFlight.primary = lunaTask;
+    inFlight.isRelaunching = false;
+    runningApp->setTraceId(lunaTask->getTraceId());
+    TRACE_ASYNC_BEGIN("launch", "launch", runningApp->getAppId().c_str(), lunaTask->getTraceId(), lunaTask->getTraceId());
+    PreloadManager::getInstance().onLaunch(lunaTask, runningApp);
+    // Launches made by SAM itself are not user-visible. They are excluded from launch statistics
+    if (lunaTask->isExternal()) {
+        runningApp->getLaunchTrace().start(lunaTask->getReceivedTime());
+        runningApp->markStage(LaunchStage::LaunchStage_SCHEMA_CHECKED, lunaTask->getSchemaCheckedTime());
+    }
     runningApp->setLifeStatus(LifeStatus::LifeStatus_SPLASHING);
     RunningAppList::getInstance().add(runningApp);
 
+    // Predicted apps are the cheapest memory to give back before asking MemoryManager.
+    // Idle runners are released by RunnerPool itself under memory pressure.
+    if (lunaTask->isExternal()) {
+        int requiredMemory = MemoryEstimator::getInstance().getRequiredMemory(runningApp->getLaunchPoint()->getAppDesc());
+        PreloadManager::getInstance().evict(requiredMemory);
+        ResidentAppManager::getInstance().reserve(requiredMemory);
+    }
+
     lunaTask->setSuccessCallback(boost::bind(&PolicyManager::onRequireMemory, this, boost::placeholders::_1));
-    MemoryManager::getInstance().requireMemory(runningApp, lunaTask);
+    if (lunaTask->isMemoryReserved()) {
+        lunaTask->success(lunaTask);
+    } else {
+        MemoryManager::getInstance().requireMemory(runningApp, lunaTask);
+    }
+
+    // Launch preparation is overlapped with memory negotiation.
+    // If MemoryManager already replied (or failed), the status is not 'SPLASHING' anymore.
+    if (runningApp->getLifeStatus() == LifeStatus::LifeStatus_SPLASHING) {
+        AbsLifeHandler::getLifeHandler(runningApp).prepare(runningApp, lunaTask);
+    }
 }
 
 void PolicyManager::pause(LunaTaskPtr lunaTask)
 {
+    TRACE_SCOPE("policy", __FUNCTION__, lunaTask->getId().c_str(), lunaTask->getTraceId());
     pre(lunaTask);
 
     RunningAppPtr runningApp = RunningAppList::getInstance().getByInstanceId(lunaTask->getInstanceId());
@@ -80,6 +123,7 @@ void PolicyManager::pause(LunaTaskPtr lunaTask)
 
 void PolicyManager::close(LunaTaskPtr lunaTask)
 {
+    TRACE_SCOPE("policy", __FUNCTION__, lunaTask->getId().c_str(), lunaTask->getTraceId());
     pre(lunaTask);
 
     RunningAppPtr runningApp = RunningAppList::getInstance().getByInstanceId(lunaTask->getInstanceId());
@@ -107,6 +151,7 @@ void PolicyManager::close(LunaTaskPtr lunaTask)
 
 void PolicyManager::relaunch(LunaTaskPtr lunaTask)
 {
+    TRACE_SCOPE("policy", __FUNCTION__, lunaTask->getId().c_str(), lunaTask->getTraceId());
     pre(lunaTask);
 
     RunningAppPtr runningApp = RunningAppList::getInstance().getByInstanceId(lunaTask->getInstanceId());
@@ -116,6 +161,15 @@ void PolicyManager::relaunch(LunaTaskPtr lunaTask)
         return;
     }
 
+    auto it = m_inFlightLaunches.find(runningApp->getInstanceId());
+    if (it != m_inFlightLaunches.end() && it->second.primary != lunaTask) {
+        coalesce(it->second, runningApp, lunaTask);
+        return;
+    }
+    PreloadManager::getInstance().onLaunch(lunaTask, runningApp);
+    runningApp->setTraceId(lunaTask->getTraceId());
+    TRACE_ASYNC_BEGIN("launch", "launch", runningApp->getAppId().c_str(), lunaTask->getTraceId(), lunaTask->getTraceId());
+
     if (runningApp->isRegistered()) {
         JValue payload = pbnjson::Object();
         runningApp->toEventJson(payload, lunaTask, "relaunch");
@@ -129,13 +183,37 @@ void PolicyManager::relaunch(LunaTaskPtr lunaTask)
     if (runningApp->getLaunchPoint()->getAppDesc()->getAppType() == AppType::AppType_Web) {
         AbsLifeHandler::getLifeHandler(runningApp).launch(runningApp, lunaTask);
     } else {
+        // Native app is launched again with new span after it is closed
+        TRACE_ASYNC_END("launch", "launch", "relaunchByClose", lunaTask->getTraceId(), lunaTask->getTraceId());
+        if (it != m_inFlightLaunches.end())
+            it->second.isRelaunching = true;
         lunaTask->setSuccessCallback(boost::bind(&PolicyManager::launch, this, boost::placeholders::_1));
         close(lunaTask);
     }
 }
 
+void PolicyManager::onRemove(RunningAppPtr runningApp)
+{
+    auto it = m_inFlightLaunches.find(runningApp->getInstanceId());
+    if (it == m_inFlightLaunches.end() || it->second.isRelaunching)
+        return;
+
+    // The primary is replied by its own error path. Followers should not wait for the app anymore.
+    InFlightLaunch inFlight = it->second;
+    m_inFlightLaunches.erase(it);
+
+    vector<LunaTaskPtr> followers = inFlight.sameParams;
+    followers.insert(followers.end(), inFlight.otherParams.begin(), inFlight.otherParams.end());
+    for (auto follower = followers.begin(); follower != followers.end(); ++follower) {
+        (*follower)->setInstanceId(runningApp->getInstanceId());
+        (*follower)->setErrCodeAndText(ErrCode_LAUNCH, runningApp->getAppId() + " is closed before launch is completed");
+        LunaTaskList::getInstance().removeAfterReply(*follower, true);
+    }
+}
+
 void PolicyManager::removeLaunchPoint(LunaTaskPtr lunaTask)
 {
+    TRACE_SCOPE("policy", __FUNCTION__, lunaTask->getId().c_str(), lunaTask->getTraceId());
     pre(lunaTask);
     RunningAppPtr runningApp = RunningAppList::getInstance().getByLunaTask(lunaTask);
     if (runningApp) {
@@ -171,7 +249,7 @@ void PolicyManager::onCloseForRemove(LunaTaskPtr lunaTask)
         // TODO launchPoint
     //    if (AppLocation::AppLocation_System_ReadOnly != launchPoint->getAppDesc()->getAppLocation()) {
     //        Call call = AppInstallService::getInstance().remove(launchPoint->getAppDesc()->getAppId());
-    //        Logger::info(getClassName(), __FUNCTION__, launchPoint->getAppDesc()->getAppId(), "requested_to_appinstalld");
+    //        LOG_INFO(getClassName(), __FUNCTION__, launchPoint->getAppDesc()->getAppId(), "requested_to_appinstalld");
     //    }
 
     //    if (!launchPoint->getAppDesc()->isVisible()) {
@@ -206,6 +284,7 @@ void PolicyManager::pre(LunaTaskPtr lunaTask)
 
 void PolicyManager::onRequireMemory(LunaTaskPtr lunaTask)
 {
+    TRACE_SCOPE("policy", __FUNCTION__, lunaTask->getId().c_str(), lunaTask->getTraceId());
     lunaTask->setSuccessCallback(boost::bind(&PolicyManager::onReplyWithIds, this, boost::placeholders::_1));
     RunningAppPtr runningApp = RunningAppList::getInstance().getByInstanceId(lunaTask->getInstanceId());
     if (runningApp == nullptr) {
@@ -214,13 +293,68 @@ void PolicyManager::onRequireMemory(LunaTaskPtr lunaTask)
         return;
     }
 
+    runningApp->markStage(LaunchStage::LaunchStage_MEMORY_GRANTED);
     runningApp->setLifeStatus(LifeStatus::LifeStatus_SPLASHED);
     AbsLifeHandler::getLifeHandler(runningApp).launch(runningApp, lunaTask);
 }
 
+void PolicyManager::coalesce(InFlightLaunch& inFlight, RunningAppPtr runningApp, LunaTaskPtr lunaTask)
+{
+    if (!inFlight.primary->getRequestPayload().hasKey("preload") && lunaTask->getParams() == inFlight.primary->getParams()) {
+        LOG_INFO(getClassName(), __FUNCTION__, runningApp->getInstanceId(), "Coalesced into in-flight launch");
+        inFlight.sameParams.push_back(lunaTask);
+    } else {
+        LOG_INFO(getClassName(), __FUNCTION__, runningApp->getInstanceId(), "Relaunch is deferred until in-flight launch is completed");
+        inFlight.otherParams.push_back(lunaTask);
+    }
+}
+
+void PolicyManager::onLaunchCompleted(LunaTaskPtr lunaTask)
+{
+    TRACE_SCOPE("policy", __FUNCTION__, lunaTask->getId().c_str(), lunaTask->getTraceId());
+    auto it = m_inFlightLaunches.find(lunaTask->getInstanceId());
+    if (it == m_inFlightLaunches.end() || it->second.primary != lunaTask)
+        return;
+
+    InFlightLaunch inFlight = it->second;
+    m_inFlightLaunches.erase(it);
+
+    bool isFailed = (lunaTask->getErrCode() != ErrCode_NOERROR || !lunaTask->getErrText().empty());
+    TRACE_ASYNC_END("launch", "launch", lunaTask->getErrText().c_str(), lunaTask->getTraceId(), lunaTask->getTraceId());
+    for (auto follower = inFlight.sameParams.begin(); follower != inFlight.sameParams.end(); ++follower) {
+        (*follower)->setInstanceId(lunaTask->getInstanceId());
+        if (isFailed)
+            (*follower)->setErrCodeAndText(lunaTask->getErrCode(), lunaTask->getErrText());
+        LunaTaskList::getInstance().removeAfterReply(*follower, true);
+    }
+
+    if (inFlight.otherParams.empty())
+        return;
+
+    if (isFailed) {
+        for (auto follower = inFlight.otherParams.begin(); follower != inFlight.otherParams.end(); ++follower) {
+            (*follower)->setErrCodeAndText(lunaTask->getErrCode(), lunaTask->getErrText());
+            LunaTaskList::getInstance().removeAfterReply(*follower, true);
+        }
+        return;
+    }
+
+    // The last request wins. Others wait for its result
+    LunaTaskPtr relaunchTask = inFlight.otherParams.back();
+    inFlight.otherParams.pop_back();
+
+    InFlightLaunch& next = m_inFlightLaunches[lunaTask->getInstanceId()];
+    next.primary = relaunchTask;
+    next.isRelaunching = false;
+    next.sameParams = inFlight.otherParams;
+    relaunchTask->setInstanceId(lunaTask->getInstanceId());
+    relaunch(relaunchTask);
+}
+
 void PolicyManager::onReplyWithIds(LunaTaskPtr lunaTask)
 {
     LunaTaskList::getInstance().removeAfterReply(lunaTask, true);
+    onLaunchCompleted(lunaTask);
 }
 
 void PolicyManager::onReplyWithoutIds(LunaTaskPtr lunaTask)
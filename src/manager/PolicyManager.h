@@ -19,6 +19,8 @@
 #define MANAGER_POLICYMANAGER_H_
 
 #include <iostream>
+#include <map>
+#include <vector>
 
 #include "base/AppDescription.h"
 #include "base/AppDescriptionList.h"
@@ -44,17 +46,42 @@ public:
     void close(LunaTaskPtr lunaTask);
     void relaunch(LunaTaskPtr lunaTask);
 
+    // Coalesced requests of the app are failed if the app is removed during launch
+    void onRemove(RunningAppPtr runningApp);
+
     void removeLaunchPoint(LunaTaskPtr lunaTask);
 
 private:
+    // Launch requests for an app which is already starting are coalesced into the first launch.
+    // Following rules are applied when the first launch is completed.
+    //  - If params are same with the first launch, the request gets the same response.
+    //  - Otherwise, only one relaunch is issued with params of the last request.
+    //    All requests with different params get the response of the relaunch.
+    //  - If the first launch fails, all coalesced requests fail with the same error.
+    // Launches for 'preload' never absorb other requests because they don't bring the app to the user.
+    // The entry is registered after the launch is validated and released on every reply of the primary.
+    struct InFlightLaunch {
+        LunaTaskPtr primary;
+        vector<LunaTaskPtr> sameParams;
+        vector<LunaTaskPtr> otherParams;
+        // Native app is closed and launched again. The removal of the old instance is expected.
+        bool isRelaunching;
+    };
+
     PolicyManager();
 
+    void coalesce(InFlightLaunch& inFlight, RunningAppPtr runningApp, LunaTaskPtr lunaTask);
+    void onLaunchCompleted(LunaTaskPtr lunaTask);
+
     void onRequireMemory(LunaTaskPtr lunaTask);
     void onCloseForRemove(LunaTaskPtr lunaTask);
 
     void pre(LunaTaskPtr lunaTask);
     void onReplyWithIds(LunaTaskPtr lunaTask);
     void onReplyWithoutIds(LunaTaskPtr lunaTask);
+
+    // instanceId => launch which is not replied yet
+    map<string, InFlightLaunch> m_inFlightLaunches;
 };
 
 #endif /* MANAGER_POLICYMANAGER_H_ */
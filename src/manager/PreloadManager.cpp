@@ -0,0 +1,421 @@
+// Copyright (c) 2020 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#include "PreloadManager.h"
+
+#include <algorithm>
+#include <time.h>
+#include <boost/bind.hpp>
+
+#include "Environment.h"
+#include "base/LunaTaskList.h"
+#include "base/RunningAppList.h"
+#include "bus/client/LSM.h"
+#include "bus/service/ApplicationManager.h"
+#include "conf/Persistence.h"
+#include "conf/SAMConf.h"
+#include "manager/MemoryEstimator.h"
+#include "manager/PolicyManager.h"
+#include "util/File.h"
+#include "util/JValueUtil.h"
+#include "util/Logger.h"
+#include "util/ProcFs.h"
+
+static int getCurrentHour()
+{
+    time_t now = time(NULL);
+    struct tm local;
+    if (localtime_r(&now, &local) == NULL)
+        return 0;
+    return local.tm_hour;
+}
+
+gboolean PreloadManager::onIdle(gpointer data)
+{
+    PreloadManager& self = getInstance();
+    self.m_idleTimer = 0;
+
+    if ((int)self.m_predicted.size() >= SAMConf::getInstance().getPreloadMaxCount())
+        return G_SOURCE_REMOVE;
+
+    if (!self.isIdle()) {
+        self.scheduleIdle();
+        return G_SOURCE_REMOVE;
+    }
+
+    vector<string> candidates;
+    self.predict(candidates);
+    for (auto it = candidates.begin(); it != candidates.end(); ++it) {
+        AppDescriptionPtr appDesc = AppDescriptionList::getInstance().getByAppId(*it);
+        if (!self.hasHeadroom(appDesc))
+            continue;
+
+        self.preload(*it);
+        // Next candidate is checked after this preloading is completed
+        self.scheduleIdle();
+        break;
+    }
+    return G_SOURCE_REMOVE;
+}
+
+gboolean PreloadManager::onSave(gpointer data)
+{
+    getInstance().m_saveTimer = 0;
+    getInstance().save();
+    return G_SOURCE_REMOVE;
+}
+
+PreloadManager::PreloadManager()
+    : m_lastAppId(""),
+      m_idleTimer(0),
+      m_saveTimer(0),
+      m_preloadCount(0),
+      m_hitCount(0),
+      m_missCount(0),
+      m_evictCount(0),
+      m_wasteCount(0)
+{
+    setClassName("PreloadManager");
+}
+
+PreloadManager::~PreloadManager()
+{
+}
+
+void PreloadManager::initialize()
+{
+    load();
+    LSM::getInstance().EventFullWindowAppChanged.connect(boost::bind(&PreloadManager::onFullWindowAppChanged, this, boost::placeholders::_1));
+}
+
+void PreloadManager::finalize()
+{
+    if (m_idleTimer != 0) {
+        g_source_remove(m_idleTimer);
+        m_idleTimer = 0;
+    }
+    if (m_saveTimer != 0) {
+        g_source_remove(m_saveTimer);
+        m_saveTimer = 0;
+        save();
+    }
+}
+
+void PreloadManager::onFullWindowAppChanged(const string& appId)
+{
+    if (appId.empty() || appId == m_lastAppId)
+        return;
+
+    if (!m_lastAppId.empty())
+        learn(m_transitions[m_lastAppId], appId);
+    learn(m_hourly[getCurrentHour()], appId);
+    m_lastAppId = appId;
+
+    scheduleSave();
+    scheduleIdle();
+}
+
+bool PreloadManager::onLaunch(LunaTaskPtr lunaTask, RunningAppPtr runningApp)
+{
+    if (!lunaTask->isExternal())
+        return false;
+
+    if (runningApp->getLifeStatus() != LifeStatus::LifeStatus_STOP) {
+        if (m_predicted.erase(runningApp->getInstanceId()) == 0)
+            return false;
+
+        m_hitCount++;
+        LOG_INFO(getClassName(), __FUNCTION__, runningApp->getAppId(), "Predicted app is launched");
+        return true;
+    }
+
+    // Cold launch of an app which could have been preloaded
+    if (canPreload(runningApp->getLaunchPoint()->getAppDesc()))
+        m_missCount++;
+    return false;
+}
+
+void PreloadManager::onRemove(RunningAppPtr runningApp)
+{
+    if (m_predicted.erase(runningApp->getInstanceId()) == 0)
+        return;
+
+    m_wasteCount++;
+    LOG_INFO(getClassName(), __FUNCTION__, runningApp->getAppId(), "Predicted app is removed without launch");
+}
+
+void PreloadManager::evict(int requiredMemory)
+{
+    if (m_predicted.empty())
+        return;
+
+    long available = ProcFs::getAvailableMemory();
+    long threshold = (requiredMemory + SAMConf::getInstance().getPreloadMemoryHeadroom()) * 1024L;
+    if (available < 0 || available >= threshold)
+        return;
+
+    set<string> predicted = m_predicted;
+    for (auto it = predicted.begin(); it != predicted.end() && available < threshold; ++it) {
+        RunningAppPtr runningApp = RunningAppList::getInstance().getByInstanceId(*it);
+        m_predicted.erase(*it);
+        if (runningApp == nullptr)
+            continue;
+
+        LOG_INFO(getClassName(), __FUNCTION__, runningApp->getAppId(), Logger::format("Evict predicted app. available(%ld KB)", available));
+        available += MemoryEstimator::getInstance().getRequiredMemory(runningApp->getLaunchPoint()->getAppDesc()) * 1024L;
+        m_evictCount++;
+        close(*it);
+    }
+}
+
+void PreloadManager::toJson(JValue& json)
+{
+    json.put("preloadCount", m_preloadCount);
+    json.put("hitCount", m_hitCount);
+    json.put("missCount", m_missCount);
+    json.put("evictCount", m_evictCount);
+    json.put("wasteCount", m_wasteCount);
+    if (m_hitCount + m_missCount > 0)
+        json.put("hitRate", m_hitCount * 100 / (m_hitCount + m_missCount));
+
+    JValue predicted = pbnjson::Array();
+    for (auto it = m_predicted.begin(); it != m_predicted.end(); ++it) {
+        predicted.append(*it);
+    }
+    json.put("predicted", predicted);
+
+    vector<string> candidates;
+    predict(candidates);
+    JValue next = pbnjson::Array();
+    for (auto it = candidates.begin(); it != candidates.end(); ++it) {
+        next.append(*it);
+    }
+    json.put("candidates", next);
+}
+
+void PreloadManager::learn(Counts& counts, const string& appId)
+{
+    if (++counts[appId] > MAX_COUNT) {
+        for (auto it = counts.begin(); it != counts.end();) {
+            it->second /= 2;
+            if (it->second == 0)
+                it = counts.erase(it);
+            else
+                ++it;
+        }
+    }
+
+    // Keep only frequent entries. New entry replaces the least frequent one.
+    while ((int)counts.size() > MAX_ENTRIES) {
+        auto least = counts.end();
+        for (auto it = counts.begin(); it != counts.end(); ++it) {
+            if (it->first == appId)
+                continue;
+            if (least == counts.end() || it->second < least->second)
+                least = it;
+        }
+        counts.erase(least);
+    }
+}
+
+int PreloadManager::getScore(const Counts& counts, const string& appId)
+{
+    int sum = 0;
+    int count = 0;
+    for (auto it = counts.begin(); it != counts.end(); ++it) {
+        sum += it->second;
+        if (it->first == appId)
+            count = it->second;
+    }
+    if (sum == 0)
+        return 0;
+    return count * 100 / sum;
+}
+
+bool PreloadManager::canPreload(AppDescriptionPtr appDesc)
+{
+    if (appDesc == nullptr)
+        return false;
+    if (appDesc->getAppType() != AppType::AppType_Web)
+        return false;
+    if (appDesc->isLocked() || SAMConf::getInstance().isBlockedApp(appDesc->getAppId()))
+        return false;
+    return true;
+}
+
+bool PreloadManager::hasHeadroom(AppDescriptionPtr appDesc)
+{
+    long available = ProcFs::getAvailableMemory();
+    if (available < 0)
+        return false;
+
+    long required = MemoryEstimator::getInstance().getRequiredMemory(appDesc) + SAMConf::getInstance().getPreloadMemoryHeadroom();
+    return available >= required * 1024L;
+}
+
+bool PreloadManager::isIdle()
+{
+    return !RunningAppList::getInstance().isTransition(false);
+}
+
+void PreloadManager::scheduleIdle()
+{
+    if (SAMConf::getInstance().getPreloadMaxCount() <= 0)
+        return;
+
+    // Idle timer is restarted whenever user changes foreground app
+    if (m_idleTimer != 0)
+        g_source_remove(m_idleTimer);
+    m_idleTimer = g_timeout_add_seconds(SAMConf::getInstance().getPreloadIdleDelay(), onIdle, nullptr);
+}
+
+void PreloadManager::scheduleSave()
+{
+    if (m_saveTimer == 0) {
+        m_saveTimer = g_timeout_add_seconds(SAVE_DELAY, onSave, nullptr);
+    }
+}
+
+void PreloadManager::predict(vector<string>& candidates)
+{
+    const Counts& hourly = m_hourly[getCurrentHour()];
+    static const Counts empty;
+    const Counts& transitions = m_transitions.count(m_lastAppId) ? m_transitions[m_lastAppId] : empty;
+
+    set<string> appIds;
+    for (auto it = transitions.begin(); it != transitions.end(); ++it)
+        appIds.insert(it->first);
+    for (auto it = hourly.begin(); it != hourly.end(); ++it)
+        appIds.insert(it->first);
+
+    // What comes after the current app is a stronger signal than time of day
+    vector<pair<int, string>> scores;
+    for (auto it = appIds.begin(); it != appIds.end(); ++it) {
+        if (*it == m_lastAppId || RunningAppList::getInstance().getByAppId(*it) != nullptr)
+            continue;
+        if (!canPreload(AppDescriptionList::getInstance().getByAppId(*it)))
+            continue;
+
+        int score = (getScore(transitions, *it) * 7 + getScore(hourly, *it) * 3) / 10;
+        if (score < MIN_SCORE)
+            continue;
+        scores.push_back(make_pair(score, *it));
+    }
+    sort(scores.rbegin(), scores.rend());
+
+    for (auto it = scores.begin(); it != scores.end(); ++it) {
+        candidates.push_back(it->second);
+    }
+}
+
+void PreloadManager::preload(const string& appId)
+{
+    JValue requestPayload = pbnjson::Object();
+    requestPayload.put("id", appId);
+    requestPayload.put("preload", "partial");
+    requestPayload.put("noSplash", true);
+    requestPayload.put("spinner", false);
+    requestPayload.put("reason", "predictivePreload");
+
+    LunaTaskPtr lunaTask = make_shared<LunaTask>(File::join(ApplicationManager::CATEGORY_ROOT, ApplicationManager::METHOD_LAUNCH), requestPayload);
+    LunaTaskList::getInstance().add(lunaTask);
+    ApplicationManager::getInstance().launch(lunaTask);
+
+    RunningAppPtr runningApp = RunningAppList::getInstance().getByInstanceId(lunaTask->getInstanceId());
+    if (runningApp == nullptr) {
+        Logger::warning(getClassName(), __FUNCTION__, appId, "Failed to preload");
+        return;
+    }
+    m_predicted.insert(runningApp->getInstanceId());
+    m_preloadCount++;
+    LOG_INFO(getClassName(), __FUNCTION__, appId, "Preload predicted app");
+}
+
+void PreloadManager::close(const string& instanceId)
+{
+    JValue requestPayload = pbnjson::Object();
+    requestPayload.put("instanceId", instanceId);
+    requestPayload.put("reason", "predictivePreload");
+
+    LunaTaskPtr lunaTask = make_shared<LunaTask>(File::join(ApplicationManager::CATEGORY_ROOT, ApplicationManager::METHOD_CLOSE), requestPayload);
+    LunaTaskList::getInstance().add(lunaTask);
+    PolicyManager::getInstance().close(lunaTask);
+}
+
+void PreloadManager::load()
+{
+    JValue json = JDomParser::fromFile(PATH_USAGE_MODEL);
+    if (json.isNull() || !json.isObject()) {
+        LOG_INFO(getClassName(), __FUNCTION__, PATH_USAGE_MODEL, "No saved usage model");
+        return;
+    }
+
+    JValue transitions;
+    if (JValueUtil::getValue(json, "transitions", transitions) && transitions.isObject()) {
+        for (JValue::KeyValue from : transitions.children()) {
+            fromJson(from.second, m_transitions[from.first.asString()]);
+        }
+    }
+
+    JValue hourly;
+    if (JValueUtil::getValue(json, "hourly", hourly) && hourly.isArray()) {
+        for (int i = 0; i < hourly.arraySize() && i < HOURS; ++i) {
+            fromJson(hourly[i], m_hourly[i]);
+        }
+    }
+}
+
+void PreloadManager::save()
+{
+    JValue json = pbnjson::Object();
+
+    JValue transitions = pbnjson::Object();
+    for (auto it = m_transitions.begin(); it != m_transitions.end(); ++it) {
+        JValue counts = pbnjson::Object();
+        toJson(it->second, counts);
+        transitions.put(it->first, counts);
+    }
+    json.put("transitions", transitions);
+
+    JValue hourly = pbnjson::Array();
+    for (int i = 0; i < HOURS; ++i) {
+        JValue counts = pbnjson::Object();
+        toJson(m_hourly[i], counts);
+        hourly.append(counts);
+    }
+    json.put("hourly", hourly);
+
+    Persistence::getInstance().write(PATH_USAGE_MODEL, json);
+}
+
+void PreloadManager::toJson(const Counts& counts, JValue& json)
+{
+    for (auto it = counts.begin(); it != counts.end(); ++it) {
+        json.put(it->first, it->second);
+    }
+}
+
+void PreloadManager::fromJson(const JValue& json, Counts& counts)
+{
+    if (!json.isObject())
+        return;
+
+    for (JValue::KeyValue item : json.children()) {
+        if (item.second.isNumber() && item.second.asNumber<int>() > 0)
+            counts[item.first.asString()] = item.second.asNumber<int>();
+    }
+}
@@ -0,0 +1,112 @@
+// Copyright (c) 2020 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#ifndef MANAGER_PRELOADMANAGER_H_
+#define MANAGER_PRELOADMANAGER_H_
+
+#include <iostream>
+#include <map>
+#include <set>
+#include <vector>
+#include <glib.h>
+#include <pbnjson.hpp>
+
+#include "base/AppDescription.h"
+#include "base/LunaTask.h"
+#include "base/RunningApp.h"
+#include "interface/ISingleton.h"
+#include "interface/IClassName.h"
+
+using namespace std;
+using namespace pbnjson;
+
+// PreloadManager predicts the next app from usage history and preloads it while the system is idle.
+// The usage model has two parts which are learned from full window app changes.
+//  - transitions : how often 'to' follows 'from'
+//  - hourly      : how often the app comes to foreground in each hour of a day
+// Counts are halved when they become too large, so old habits fade out.
+// Only web apps are preloaded because 'preload' is handled by WAM.
+class PreloadManager : public ISingleton<PreloadManager>,
+                       public IClassName {
+friend class ISingleton<PreloadManager>;
+public:
+    virtual ~PreloadManager();
+
+    void initialize();
+    void finalize();
+
+    void onFullWindowAppChanged(const string& appId);
+
+    // Called before a user launch. Returns true if the app was preloaded by prediction
+    bool onLaunch(LunaTaskPtr lunaTask, RunningAppPtr runningApp);
+    void onRemove(RunningAppPtr runningApp);
+
+    // Closes predicted apps until 'requiredMemory' (MB) is available over headroom
+    void evict(int requiredMemory);
+
+    void toJson(JValue& json);
+
+private:
+    static const int HOURS = 24;
+    static const int MAX_ENTRIES = 8;
+    static const int MAX_COUNT = 1000;
+    static const int MIN_SCORE = 20;
+    static const int SAVE_DELAY = 60;
+
+    static gboolean onIdle(gpointer data);
+    static gboolean onSave(gpointer data);
+
+    typedef map<string, int> Counts;
+
+    PreloadManager();
+
+    void learn(Counts& counts, const string& appId);
+    int getScore(const Counts& counts, const string& appId);
+    bool canPreload(AppDescriptionPtr appDesc);
+    bool hasHeadroom(AppDescriptionPtr appDesc);
+    bool isIdle();
+
+    void scheduleIdle();
+    void scheduleSave();
+    void predict(vector<string>& candidates);
+    void preload(const string& appId);
+    void close(const string& instanceId);
+
+    void load();
+    void save();
+    static void toJson(const Counts& counts, JValue& json);
+    static void fromJson(const JValue& json, Counts& counts);
+
+    string m_lastAppId;
+    map<string, Counts> m_transitions;
+    Counts m_hourly[HOURS];
+
+    // instanceIds which are preloaded by prediction and are not used yet
+    set<string> m_predicted;
+
+    guint m_idleTimer;
+    guint m_saveTimer;
+
+    int m_preloadCount;
+    int m_hitCount;
+    int m_missCount;
+    int m_evictCount;
+    int m_wasteCount;
+
+};
+
+#endif /* MANAGER_PRELOADMANAGER_H_ */
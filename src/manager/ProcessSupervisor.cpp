@@ -0,0 +1,267 @@
+// Copyright (c) 2020 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#include "ProcessSupervisor.h"
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <vector>
+
+#include "util/Logger.h"
+#include "util/ProcFs.h"
+
+// Syscall number of pidfd_open is same in all architectures
+#ifndef SYS_pidfd_open
+#define SYS_pidfd_open 434
+#endif
+#ifndef P_PIDFD
+#define P_PIDFD 3
+#endif
+
+GSourceFuncs ProcessSupervisor::s_sourceFuncs = {
+    NULL,
+    NULL,
+    ProcessSupervisor::onDispatch,
+    NULL
+};
+
+gboolean ProcessSupervisor::onDispatch(GSource* source, GSourceFunc callback, gpointer data)
+{
+    ProcessSupervisor& self = getInstance();
+
+    // Callbacks can add new watches. Exited processes are collected first
+    vector<pid_t> exited;
+    for (auto it = self.m_watches.begin(); it != self.m_watches.end(); ++it) {
+        if (it->second.pidfd >= 0 && g_source_query_unix_fd(source, it->second.tag) != 0)
+            exited.push_back(it->first);
+    }
+    for (pid_t pid : exited) {
+        self.notify(pid);
+    }
+    return G_SOURCE_CONTINUE;
+}
+
+gboolean ProcessSupervisor::onPoll(gpointer data)
+{
+    ProcessSupervisor& self = getInstance();
+
+    vector<pid_t> exited;
+    bool hasPolled = false;
+    for (auto it = self.m_watches.begin(); it != self.m_watches.end(); ++it) {
+        if (it->second.pidfd >= 0 || it->second.isChild)
+            continue;
+        if (ProcFs::getProcessStartTime(it->first) != it->second.startTime)
+            exited.push_back(it->first);
+        else
+            hasPolled = true;
+    }
+    for (pid_t pid : exited) {
+        self.notify(pid);
+    }
+
+    if (hasPolled)
+        return G_SOURCE_CONTINUE;
+    self.m_pollTimer = 0;
+    return G_SOURCE_REMOVE;
+}
+
+ProcessSupervisor::ProcessSupervisor()
+    : m_source(nullptr),
+      m_pollTimer(0),
+      m_isPidfdSupported(false),
+      m_isWaitidSupported(false),
+      m_exitCount(0),
+      m_adoptCount(0),
+      m_rejectCount(0)
+{
+    setClassName("ProcessSupervisor");
+}
+
+ProcessSupervisor::~ProcessSupervisor()
+{
+}
+
+void ProcessSupervisor::initialize()
+{
+    int pidfd = openPidfd(getpid());
+    if (pidfd < 0) {
+        Logger::warning(getClassName(), __FUNCTION__, Logger::format("pidfd is not supported: %s", strerror(errno)));
+        return;
+    }
+
+    // SAM is not a child of itself. ECHILD means waitid(P_PIDFD) is supported. EINVAL means it is not.
+    siginfo_t info;
+    memset(&info, 0, sizeof(info));
+    m_isWaitidSupported = (waitid((idtype_t)P_PIDFD, pidfd, &info, WEXITED | WNOHANG) == 0 || errno != EINVAL);
+    if (!m_isWaitidSupported)
+        Logger::warning(getClassName(), __FUNCTION__, "waitid(P_PIDFD) is not supported. Children are reaped with waitpid");
+    close(pidfd);
+
+    m_isPidfdSupported = true;
+    m_source = g_source_new(&s_sourceFuncs, sizeof(GSource));
+    g_source_attach(m_source, NULL);
+}
+
+void ProcessSupervisor::finalize()
+{
+    for (auto it = m_watches.begin(); it != m_watches.end(); ++it) {
+        if (it->second.pidfd >= 0)
+            close(it->second.pidfd);
+    }
+    m_watches.clear();
+
+    if (m_source) {
+        g_source_destroy(m_source);
+        g_source_unref(m_source);
+        m_source = nullptr;
+    }
+    if (m_pollTimer != 0) {
+        g_source_remove(m_pollTimer);
+        m_pollTimer = 0;
+    }
+}
+
+bool ProcessSupervisor::watch(pid_t pid, GChildWatchFunc func, gpointer data)
+{
+    int pidfd = m_isPidfdSupported ? openPidfd(pid) : -1;
+    if (pidfd < 0) {
+        g_child_watch_add(pid, func, data);
+        return true;
+    }
+
+    Watch& watch = m_watches[pid];
+    watch.pidfd = pidfd;
+    watch.tag = g_source_add_unix_fd(m_source, pidfd, G_IO_IN);
+    watch.isChild = true;
+    watch.startTime = 0;
+    watch.func = func;
+    watch.data = data;
+    return true;
+}
+
+bool ProcessSupervisor::adopt(pid_t pid, unsigned long long startTime, GChildWatchFunc func, gpointer data)
+{
+    // pidfd is opened before checking start time. If the check passes, pidfd refers to the verified process
+    int pidfd = m_isPidfdSupported ? openPidfd(pid) : -1;
+    if (m_isPidfdSupported && pidfd < 0) {
+        m_rejectCount++;
+        return false;
+    }
+
+    unsigned long long currentStartTime = ProcFs::getProcessStartTime(pid);
+    if (currentStartTime == 0 || (startTime != 0 && startTime != currentStartTime)) {
+        Logger::warning(getClassName(), __FUNCTION__,
+                        Logger::format("Process(%d) is not the same process. startTime(%llu => %llu)", pid, startTime, currentStartTime));
+        if (pidfd >= 0)
+            close(pidfd);
+        m_rejectCount++;
+        return false;
+    }
+
+    Watch& watch = m_watches[pid];
+    watch.pidfd = pidfd;
+    watch.tag = (pidfd >= 0) ? g_source_add_unix_fd(m_source, pidfd, G_IO_IN) : nullptr;
+    watch.isChild = false;
+    watch.startTime = currentStartTime;
+    watch.func = func;
+    watch.data = data;
+    if (pidfd < 0)
+        schedulePoll();
+
+    m_adoptCount++;
+    LOG_INFO(getClassName(), __FUNCTION__, Logger::format("Process(%d) is adopted", pid));
+    return true;
+}
+
+void ProcessSupervisor::toJson(JValue& json)
+{
+    json.put("pidfd", m_isPidfdSupported);
+    json.put("waitid", m_isWaitidSupported);
+    json.put("watches", (int)m_watches.size());
+    json.put("exitCount", m_exitCount);
+    json.put("adoptCount", m_adoptCount);
+    json.put("rejectCount", m_rejectCount);
+}
+
+int ProcessSupervisor::openPidfd(pid_t pid)
+{
+    return (int)syscall(SYS_pidfd_open, pid, 0);
+}
+
+int ProcessSupervisor::reap(pid_t pid, const Watch& watch)
+{
+    if (!m_isWaitidSupported) {
+        int status = 0;
+        if (waitpid(pid, &status, WNOHANG) == -1) {
+            Logger::error(getClassName(), __FUNCTION__, strerror(errno));
+            return 0;
+        }
+        return status;
+    }
+
+    siginfo_t info;
+    memset(&info, 0, sizeof(info));
+    if (waitid((idtype_t)P_PIDFD, watch.pidfd, &info, WEXITED | WNOHANG) == -1) {
+        Logger::error(getClassName(), __FUNCTION__, strerror(errno));
+        return 0;
+    }
+
+    // Same with the status of waitpid()
+    switch (info.si_code) {
+    case CLD_EXITED:
+        return W_EXITCODE(info.si_status, 0);
+
+    case CLD_KILLED:
+        return info.si_status;
+
+    case CLD_DUMPED:
+        return info.si_status | WCOREFLAG;
+
+    default:
+        return 0;
+    }
+}
+
+void ProcessSupervisor::notify(pid_t pid)
+{
+    auto it = m_watches.find(pid);
+    if (it == m_watches.end())
+        return;
+
+    Watch watch = it->second;
+    m_watches.erase(it);
+
+    int status = 0;
+    if (watch.pidfd >= 0) {
+        g_source_remove_unix_fd(m_source, watch.tag);
+        if (watch.isChild)
+            status = reap(pid, watch);
+        close(watch.pidfd);
+    }
+    m_exitCount++;
+    watch.func(pid, status, watch.data);
+}
+
+void ProcessSupervisor::schedulePoll()
+{
+    if (m_pollTimer != 0)
+        return;
+    m_pollTimer = g_timeout_add_seconds(POLL_INTERVAL, onPoll, nullptr);
+}
@@ -0,0 +1,90 @@
+// Copyright (c) 2020 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#ifndef MANAGER_PROCESSSUPERVISOR_H_
+#define MANAGER_PROCESSSUPERVISOR_H_
+
+#include <iostream>
+#include <map>
+#include <glib.h>
+#include <pbnjson.hpp>
+
+#include "interface/ISingleton.h"
+#include "interface/IClassName.h"
+
+using namespace std;
+using namespace pbnjson;
+
+// ProcessSupervisor observes exits of native processes with pidfd (Linux 5.3).
+// All pidfds are polled by a single GSource. Child processes are reaped with waitid(P_PIDFD) (Linux 5.4).
+// With Linux 5.3, they are reaped with waitpid().
+// Processes which were spawned by previous SAM are adopted only if their start time is not changed,
+// so a reused pid is never taken as the app. Their exit status is unknown and reported as 0.
+// If pidfd is not supported, children are watched by g_child_watch and adopted processes are polled.
+class ProcessSupervisor : public ISingleton<ProcessSupervisor>,
+                          public IClassName {
+friend class ISingleton<ProcessSupervisor>;
+public:
+    virtual ~ProcessSupervisor();
+
+    void initialize();
+    void finalize();
+
+    // 'func' is called once when the child process exits
+    bool watch(pid_t pid, GChildWatchFunc func, gpointer data);
+
+    // Returns false if the process is not alive or the pid belongs to another process now
+    bool adopt(pid_t pid, unsigned long long startTime, GChildWatchFunc func, gpointer data);
+
+    void toJson(JValue& json);
+
+private:
+    static const int POLL_INTERVAL = 2;
+    static GSourceFuncs s_sourceFuncs;
+
+    static gboolean onDispatch(GSource* source, GSourceFunc callback, gpointer data);
+    static gboolean onPoll(gpointer data);
+
+    struct Watch {
+        int pidfd;
+        gpointer tag;
+        bool isChild;
+        unsigned long long startTime;
+        GChildWatchFunc func;
+        gpointer data;
+    };
+
+    ProcessSupervisor();
+
+    int openPidfd(pid_t pid);
+    int reap(pid_t pid, const Watch& watch);
+    void notify(pid_t pid);
+    void schedulePoll();
+
+    map<pid_t, Watch> m_watches;
+    GSource* m_source;
+    guint m_pollTimer;
+    bool m_isPidfdSupported;
+    bool m_isWaitidSupported;
+
+    int m_exitCount;
+    int m_adoptCount;
+    int m_rejectCount;
+
+};
+
+#endif /* MANAGER_PROCESSSUPERVISOR_H_ */
@@ -0,0 +1,267 @@
+// Copyright (c) 2020 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ResidentAppManager.h"
+
+#include <algorithm>
+#include <boost/bind.hpp>
+
+#include "base/LunaTaskList.h"
+#include "base/RunningAppList.h"
+#include "bus/client/LSM.h"
+#include "bus/service/ApplicationManager.h"
+#include "conf/SAMConf.h"
+#include "manager/BulkTerminator.h"
+#include "manager/LaunchStatistics.h"
+#include "manager/MemoryEstimator.h"
+#include "util/Cgroup.h"
+#include "util/File.h"
+#include "util/Logger.h"
+#include "util/Time.h"
+
+gboolean ResidentAppManager::onEnforce(gpointer data)
+{
+    getInstance().m_enforceTimer = 0;
+    getInstance().enforce(0);
+    return G_SOURCE_REMOVE;
+}
+
+bool ResidentAppManager::compareByScore(const Candidate& a, const Candidate& b)
+{
+    // Bigger app is closed first if both have the same score
+    if (a.score != b.score)
+        return a.score < b.score;
+    return a.memory > b.memory;
+}
+
+ResidentAppManager::ResidentAppManager()
+    : m_fullWindowAppId(""),
+      m_enforceTimer(0),
+      m_residentMemory(0),
+      m_evictCount(0),
+      m_reclaimedMemory(0)
+{
+    setClassName("ResidentAppManager");
+}
+
+ResidentAppManager::~ResidentAppManager()
+{
+}
+
+void ResidentAppManager::initialize()
+{
+    LSM::getInstance().EventFullWindowAppChanged.connect(boost::bind(&ResidentAppManager::onFullWindowAppChanged, this, boost::placeholders::_1));
+}
+
+void ResidentAppManager::finalize()
+{
+    if (m_enforceTimer != 0) {
+        g_source_remove(m_enforceTimer);
+        m_enforceTimer = 0;
+    }
+}
+
+void ResidentAppManager::onFullWindowAppChanged(const string& appId)
+{
+    long long now = Time::getCurrentTime();
+
+    // Previous app was in foreground until now
+    if (!m_fullWindowAppId.empty())
+        m_usages[m_fullWindowAppId].lastForeground = now;
+
+    m_fullWindowAppId = appId;
+    if (!appId.empty()) {
+        Usage& usage = m_usages[appId];
+        usage.lastForeground = now;
+        usage.count++;
+
+        // Old habits fade out
+        if (usage.count > MAX_COUNT) {
+            for (auto it = m_usages.begin(); it != m_usages.end(); ++it)
+                it->second.count /= 2;
+        }
+    }
+    scheduleEnforce();
+}
+
+void ResidentAppManager::onAdd(RunningAppPtr runningApp)
+{
+    scheduleEnforce();
+}
+
+void ResidentAppManager::reserve(int requiredMemory)
+{
+    enforce(requiredMemory);
+}
+
+void ResidentAppManager::toJson(JValue& json)
+{
+    json.put("memoryBudget", SAMConf::getInstance().getResidentMemoryBudget());
+    json.put("residentMemory", m_residentMemory);
+    json.put("evictCount", m_evictCount);
+    json.put("reclaimedMemory", m_reclaimedMemory);
+
+    vector<Candidate> candidates;
+    collect(candidates);
+    sort(candidates.begin(), candidates.end(), compareByScore);
+
+    JValue residents = pbnjson::Array();
+    for (auto it = candidates.begin(); it != candidates.end(); ++it) {
+        JValue resident = pbnjson::Object();
+        resident.put("instanceId", it->instanceId);
+        resident.put("appId", it->appId);
+        resident.put("memory", it->memory);
+        resident.put("score", it->score);
+        residents.append(resident);
+    }
+    json.put("residents", residents);
+}
+
+bool ResidentAppManager::isResident(RunningAppPtr runningApp)
+{
+    if (runningApp->getAppId() == m_fullWindowAppId || runningApp->isBulkClosing())
+        return false;
+
+    switch (runningApp->getLifeStatus()) {
+    case LifeStatus::LifeStatus_BACKGROUND:
+    case LifeStatus::LifeStatus_PAUSED:
+    case LifeStatus::LifeStatus_PRELOADED:
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+int ResidentAppManager::getMemory(RunningAppPtr runningApp)
+{
+    const string& cgroup = runningApp->getLinuxProcess().getCgroup();
+    if (!cgroup.empty()) {
+        long long current = Cgroup::getMemoryCurrent(cgroup);
+        if (current > 0)
+            return (int)(current / (1024 * 1024));
+    }
+    if (runningApp->getPeakMemory() > 0)
+        return (int)((runningApp->getPeakMemory() + 1023) / 1024);
+    return MemoryEstimator::getInstance().getRequiredMemory(runningApp->getLaunchPoint()->getAppDesc());
+}
+
+int ResidentAppManager::getScore(RunningAppPtr runningApp, long long now)
+{
+    int recency = 0;
+    int frequency = 0;
+    auto it = m_usages.find(runningApp->getAppId());
+    if (it != m_usages.end()) {
+        long long age = (now - it->second.lastForeground) / 1000;
+        if (age < 0)
+            age = 0;
+        recency = (int)(MAX_SCORE * HALF_LIFE / (HALF_LIFE + age));
+        frequency = MAX_SCORE * it->second.count / (it->second.count + 10);
+    }
+
+    // Unknown cost is regarded as average
+    int cost = MAX_SCORE / 2;
+    long long launchTime = LaunchStatistics::getInstance().getMedian(runningApp->getAppId(), LaunchStage::LaunchStage_FOREGROUND);
+    if (launchTime >= 0)
+        cost = (int)(MAX_SCORE * launchTime / (launchTime + 3000));
+
+    int score = recency + frequency + cost;
+    if (runningApp->isKeepAlive() || SAMConf::getInstance().isKeepAliveApp(runningApp->getAppId()))
+        score += KEEP_ALIVE_BONUS;
+    return score;
+}
+
+int ResidentAppManager::collect(vector<Candidate>& candidates)
+{
+    long long now = Time::getCurrentTime();
+    int total = 0;
+
+    const map<string, RunningAppPtr>& runningApps = RunningAppList::getInstance().getAll();
+    for (auto it = runningApps.begin(); it != runningApps.end(); ++it) {
+        if (!isResident(it->second))
+            continue;
+
+        Candidate candidate;
+        candidate.instanceId = it->second->getInstanceId();
+        candidate.appId = it->second->getAppId();
+        candidate.memory = getMemory(it->second);
+        candidate.score = getScore(it->second, now);
+        candidates.push_back(candidate);
+        total += candidate.memory;
+    }
+    return total;
+}
+
+void ResidentAppManager::scheduleEnforce()
+{
+    if (m_enforceTimer != 0 || SAMConf::getInstance().getResidentMemoryBudget() <= 0)
+        return;
+    m_enforceTimer = g_timeout_add(ENFORCE_DELAY, onEnforce, nullptr);
+}
+
+void ResidentAppManager::enforce(int requiredMemory)
+{
+    int budget = SAMConf::getInstance().getResidentMemoryBudget();
+    if (budget <= 0)
+        return;
+
+    vector<Candidate> candidates;
+    m_residentMemory = collect(candidates);
+    int limit = budget - requiredMemory;
+    if (m_residentMemory <= limit)
+        return;
+
+    sort(candidates.begin(), candidates.end(), compareByScore);
+    vector<Candidate> victims;
+    int total = m_residentMemory;
+    for (auto it = candidates.begin(); it != candidates.end() && total > limit; ++it) {
+        victims.push_back(*it);
+        total -= it->memory;
+    }
+
+    LOG_INFO(getClassName(), __FUNCTION__,
+             Logger::format("resident(%d MB) required(%d MB) budget(%d MB) victims(%d)",
+             m_residentMemory, requiredMemory, budget, (int)victims.size()));
+    evict(victims);
+}
+
+void ResidentAppManager::evict(const vector<Candidate>& victims)
+{
+    if (victims.empty())
+        return;
+
+    JValue apps = pbnjson::Array();
+    for (auto it = victims.begin(); it != victims.end(); ++it) {
+        JValue app = pbnjson::Object();
+        app.put("instanceId", it->instanceId);
+        apps.append(app);
+
+        LOG_INFO(getClassName(), __FUNCTION__, it->appId,
+                 Logger::format("Evict resident app. memory(%d MB) score(%d)", it->memory, it->score));
+        m_evictCount++;
+        m_reclaimedMemory += it->memory;
+    }
+
+    // keepAlive apps should be closed. Otherwise, WAM pauses them again.
+    JValue requestPayload = pbnjson::Object();
+    requestPayload.put("apps", apps);
+    requestPayload.put("force", true);
+    requestPayload.put("reason", "residentBudget");
+
+    LunaTaskPtr lunaTask = make_shared<LunaTask>(File::join(ApplicationManager::CATEGORY_ROOT, ApplicationManager::METHOD_CLOSE_BATCH), requestPayload);
+    LunaTaskList::getInstance().add(lunaTask);
+    BulkTerminator::getInstance().close(lunaTask);
+}
@@ -0,0 +1,100 @@
+// Copyright (c) 2020 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef MANAGER_RESIDENTAPPMANAGER_H_
+#define MANAGER_RESIDENTAPPMANAGER_H_
+
+#include <iostream>
+#include <map>
+#include <vector>
+#include <glib.h>
+#include <pbnjson.hpp>
+
+#include "base/RunningApp.h"
+#include "interface/ISingleton.h"
+#include "interface/IClassName.h"
+
+using namespace std;
+using namespace pbnjson;
+
+// ResidentAppManager keeps memory of resident apps (background, paused and preloaded) within a budget.
+// Each app has a score. Apps with the lowest score are closed first when they are over budget.
+//  - recency   : how recently the app was in foreground
+//  - frequency : how often the app comes to foreground
+//  - cost      : how long the app takes to be launched again
+// keepAlive apps have extra score, so they are closed after other apps.
+// Launches reserve their memory in the budget before asking MemoryManager.
+class ResidentAppManager : public ISingleton<ResidentAppManager>,
+                           public IClassName {
+friend class ISingleton<ResidentAppManager>;
+public:
+    virtual ~ResidentAppManager();
+
+    void initialize();
+    void finalize();
+
+    void onFullWindowAppChanged(const string& appId);
+    void onAdd(RunningAppPtr runningApp);
+
+    // Closes resident apps until 'requiredMemory' (MB) fits in the budget
+    void reserve(int requiredMemory);
+
+    void toJson(JValue& json);
+
+private:
+    static const int ENFORCE_DELAY = 1000;
+    static const int HALF_LIFE = 300;
+    static const int MAX_COUNT = 1000;
+    static const int MAX_SCORE = 100;
+    static const int KEEP_ALIVE_BONUS = 100;
+
+    struct Usage {
+        long long lastForeground;
+        int count;
+    };
+
+    struct Candidate {
+        string instanceId;
+        string appId;
+        int memory;
+        int score;
+    };
+
+    static gboolean onEnforce(gpointer data);
+    static bool compareByScore(const Candidate& a, const Candidate& b);
+
+    ResidentAppManager();
+
+    bool isResident(RunningAppPtr runningApp);
+    int getMemory(RunningAppPtr runningApp);
+    int getScore(RunningAppPtr runningApp, long long now);
+    int collect(vector<Candidate>& candidates);
+
+    void scheduleEnforce();
+    void enforce(int requiredMemory);
+    void evict(const vector<Candidate>& victims);
+
+    map<string, Usage> m_usages;
+    string m_fullWindowAppId;
+    guint m_enforceTimer;
+
+    int m_residentMemory;
+    int m_evictCount;
+    int m_reclaimedMemory;
+
+};
+
+#endif /* MANAGER_RESIDENTAPPMANAGER_H_ */
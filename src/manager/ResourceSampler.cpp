@@ -0,0 +1,233 @@
+// Copyright (c) 2020 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ResourceSampler.h"
+
+#include <stdlib.h>
+#include <algorithm>
+#include <vector>
+
+#include "base/RunningAppList.h"
+#include "bus/service/ApplicationManager.h"
+#include "conf/SAMConf.h"
+#include "manager/MemoryEstimator.h"
+#include "util/Cgroup.h"
+#include "util/Logger.h"
+#include "util/ProcFs.h"
+#include "util/Time.h"
+
+gboolean ResourceSampler::onSampling(gpointer data)
+{
+    if (RunningAppList::getInstance().getAll().empty()) {
+        getInstance().m_samplingTimer = 0;
+        return G_SOURCE_REMOVE;
+    }
+    getInstance().sample();
+    return G_SOURCE_CONTINUE;
+}
+
+ResourceSampler::ResourceSampler()
+    : m_samplingTimer(0),
+      m_interval(0),
+      m_sampleCount(0),
+      m_lastDuration(0)
+{
+    setClassName("ResourceSampler");
+}
+
+ResourceSampler::~ResourceSampler()
+{
+    finalize();
+}
+
+void ResourceSampler::initialize()
+{
+    m_interval = SAMConf::getInstance().getResourceSamplingInterval();
+    if (m_interval <= 0)
+        LOG_INFO(getClassName(), __FUNCTION__, "Usage sampling is disabled. Only memory is sampled");
+}
+
+void ResourceSampler::finalize()
+{
+    if (m_samplingTimer != 0) {
+        g_source_remove(m_samplingTimer);
+        m_samplingTimer = 0;
+    }
+}
+
+void ResourceSampler::onAdd(RunningAppPtr runningApp)
+{
+    if (m_samplingTimer == 0)
+        m_samplingTimer = g_timeout_add(getTimerInterval(), onSampling, nullptr);
+}
+
+void ResourceSampler::onRemove(RunningAppPtr runningApp)
+{
+    m_windows.erase(runningApp->getInstanceId());
+}
+
+bool ResourceSampler::toJson(const string& instanceId, JValue& json)
+{
+    auto it = m_windows.find(instanceId);
+    if (it == m_windows.end() || it->second.count == 0)
+        return false;
+
+    const Window& window = it->second;
+    const Sample& last = window.samples[(window.head + WINDOW_SIZE - 1) % WINDOW_SIZE];
+    const Sample& first = window.samples[(window.head + WINDOW_SIZE - window.count) % WINDOW_SIZE];
+    int cpuTotal = 0;
+    int cpuMax = 0;
+    long memoryMax = 0;
+    for (int i = 0; i < window.count; ++i) {
+        const Sample& sample = window.samples[(window.head + WINDOW_SIZE - 1 - i) % WINDOW_SIZE];
+        cpuTotal += sample.cpu;
+        if (sample.cpu > cpuMax)
+            cpuMax = sample.cpu;
+        if (sample.memory > memoryMax)
+            memoryMax = sample.memory;
+    }
+
+    // CPU is % of a single core. Memory is KB
+    json.put("source", window.isCgroup ? "cgroup" : "proc");
+    json.put("cpu", last.cpu / 10.0);
+    json.put("cpuAvg", cpuTotal / window.count / 10.0);
+    json.put("cpuMax", cpuMax / 10.0);
+    json.put(window.isCgroup ? "anon" : "rss", (int64_t)last.memory);
+    json.put(window.isCgroup ? "anonMax" : "rssMax", (int64_t)memoryMax);
+    if (!window.isCgroup && window.pss >= 0)
+        json.put("pss", (int64_t)window.pss);
+    json.put("window", (int64_t)(last.time - first.time + m_interval));
+    return true;
+}
+
+void ResourceSampler::toJson(JValue& json)
+{
+    json.put("enabled", isEnabled());
+    json.put("interval", getTimerInterval());
+    json.put("windowSize", WINDOW_SIZE);
+    json.put("instances", (int)m_windows.size());
+    json.put("sampleCount", (int64_t)m_sampleCount);
+    json.put("lastDurationUs", (int64_t)m_lastDuration);
+}
+
+void ResourceSampler::sample()
+{
+    long long startTime = Time::getCurrentTimeUs();
+    long long now = Time::getCurrentTime();
+
+    const map<string, RunningAppPtr>& runningApps = RunningAppList::getInstance().getAll();
+    for (auto it = runningApps.begin(); it != runningApps.end(); ++it) {
+        auto result = m_windows.insert(make_pair(it->first, Window()));
+        Window& window = result.first->second;
+        if (result.second) {
+            window.head = 0;
+            window.count = 0;
+            window.isCgroup = false;
+            window.pid = -1;
+            window.lastCpuTime = 0;
+            window.lastTime = -1;
+            window.pss = -1;
+            window.lastPssTime = -1;
+        }
+
+        bool wasCgroup = window.isCgroup;
+        pid_t lastPid = window.pid;
+        unsigned long long cpuTime = 0;
+        long memory = 0;
+        if (!read(it->second, window, now, cpuTime, memory) || !isEnabled())
+            continue;
+
+        // Memory samples of the other source are not comparable
+        if (window.isCgroup != wasCgroup)
+            window.count = 0;
+
+        // The first sample is only a baseline. CPU time of cgroup and process are different counters.
+        // So the baseline is also reset if the source or the process (e.g. web process) is changed.
+        bool isBaseline = window.lastTime < 0 ||
+                          window.isCgroup != wasCgroup ||
+                          window.pid != lastPid ||
+                          cpuTime < window.lastCpuTime ||
+                          now <= window.lastTime;
+        if (!isBaseline) {
+            Sample& sample = window.samples[window.head];
+            sample.time = now;
+            sample.cpu = (int)((cpuTime - window.lastCpuTime) / (now - window.lastTime));
+            sample.memory = memory;
+            window.head = (window.head + 1) % WINDOW_SIZE;
+            if (window.count < WINDOW_SIZE)
+                window.count++;
+        }
+        window.lastCpuTime = cpuTime;
+        window.lastTime = now;
+    }
+
+    m_sampleCount++;
+    m_lastDuration = Time::getCurrentTimeUs() - startTime;
+    if (isEnabled())
+        ApplicationManager::getInstance().postRunningResourceUsage();
+}
+
+bool ResourceSampler::read(RunningAppPtr runningApp, Window& window, long long now, unsigned long long& cpuTime, long& memory)
+{
+    // cgroup includes descendants which left the process tree. It also counts page cache of the app
+    const string& cgroup = runningApp->getLinuxProcess().getCgroup();
+    if (!cgroup.empty()) {
+        long long current = Cgroup::getMemoryCurrent(cgroup);
+        long long usage = isEnabled() ? Cgroup::getCpuUsage(cgroup) : 0;
+        long long anon = isEnabled() ? Cgroup::getMemoryAnon(cgroup) : 0;
+        if (current >= 0 && usage >= 0 && anon >= 0) {
+            MemoryEstimator::getInstance().onSample(runningApp, (long)(current / 1024));
+            window.isCgroup = true;
+            window.pid = -1;
+            cpuTime = (unsigned long long)usage;
+            memory = (long)(anon / 1024);
+            return true;
+        }
+    }
+
+    pid_t pid = getRootPid(runningApp);
+    if (pid <= 0)
+        return false;
+
+    window.isCgroup = false;
+    window.pid = pid;
+    if (window.lastPssTime < 0 || now - window.lastPssTime >= PSS_INTERVAL) {
+        vector<pid_t> pids;
+        ProcFs::getProcessTree(pid, pids);
+
+        long total = 0;
+        for (pid_t child : pids) {
+            long pss = ProcFs::getProcessPss(child);
+            if (child == pid)
+                window.pss = pss;
+            total += (pss >= 0) ? pss : max(ProcFs::getProcessRss(child), 0L);
+        }
+        MemoryEstimator::getInstance().onSample(runningApp, total);
+        window.lastPssTime = now;
+    }
+    return !isEnabled() || ProcFs::getProcessStat(pid, cpuTime, memory);
+}
+
+pid_t ResourceSampler::getRootPid(RunningAppPtr runningApp)
+{
+    if (runningApp->getProcessId() > 0)
+        return runningApp->getProcessId();
+
+    // Web process can be shared with other apps. In this case, the estimate is pessimistic.
+    if (!runningApp->getWebprocessid().empty())
+        return (pid_t)atoi(runningApp->getWebprocessid().c_str());
+    return -1;
+}
@@ -0,0 +1,108 @@
+// Copyright (c) 2020 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef MANAGER_RESOURCESAMPLER_H_
+#define MANAGER_RESOURCESAMPLER_H_
+
+#include <iostream>
+#include <map>
+#include <glib.h>
+#include <pbnjson.hpp>
+
+#include "base/RunningApp.h"
+#include "interface/ISingleton.h"
+#include "interface/IClassName.h"
+
+using namespace std;
+using namespace pbnjson;
+
+// ResourceSampler samples CPU and memory of all running apps every 'ResourceSampler.Interval' (ms) in sam-conf.
+//  - Apps in a cgroup are sampled with 'cpu.stat' and 'anon' in 'memory.stat'. They include all descendants.
+//  - Other apps are sampled with a single read of /proc/<pid>/stat of the native process or web process.
+//  - PSS needs a walk of page tables (smaps_rollup). It is sampled every PSS_INTERVAL (ms).
+// Each instance keeps the last WINDOW_SIZE samples. The timer runs only while any app is running.
+//
+// It is also the only sampler of app memory for MemoryEstimator. Even if usage sampling is disabled,
+// memory of each app is sampled every MEMORY_INTERVAL (ms) and passed to MemoryEstimator.
+class ResourceSampler : public ISingleton<ResourceSampler>,
+                        public IClassName {
+friend class ISingleton<ResourceSampler>;
+public:
+    static const int WINDOW_SIZE = 15;
+    static const int MEMORY_INTERVAL = 3000;
+    static const int PSS_INTERVAL = 10000;
+
+    virtual ~ResourceSampler();
+
+    void initialize();
+    void finalize();
+
+    void onAdd(RunningAppPtr runningApp);
+    void onRemove(RunningAppPtr runningApp);
+
+    bool isEnabled() const
+    {
+        return m_interval > 0;
+    }
+
+    // Returns false if the instance is not sampled yet
+    bool toJson(const string& instanceId, JValue& json);
+    void toJson(JValue& json);
+
+private:
+    struct Sample {
+        long long time;
+        int cpu;        // 0.1%
+        long memory;    // KB. Anonymous memory of cgroup or RSS of the process
+    };
+
+    struct Window {
+        Sample samples[WINDOW_SIZE];
+        int head;
+        int count;
+        bool isCgroup;
+        pid_t pid;
+        unsigned long long lastCpuTime; // us
+        long long lastTime;
+        long pss;
+        long long lastPssTime;
+    };
+
+    static gboolean onSampling(gpointer data);
+
+    // Native process or web process of the app. -1 means unknown
+    static pid_t getRootPid(RunningAppPtr runningApp);
+
+    ResourceSampler();
+
+    int getTimerInterval() const
+    {
+        return (m_interval > 0) ? m_interval : MEMORY_INTERVAL;
+    }
+
+    void sample();
+    bool read(RunningAppPtr runningApp, Window& window, long long now, unsigned long long& cpuTime, long& memory);
+
+    map<string, Window> m_windows;
+    guint m_samplingTimer;
+    int m_interval;
+
+    long long m_sampleCount;
+    long long m_lastDuration; // us
+
+};
+
+#endif /* MANAGER_RESOURCESAMPLER_H_ */
@@ -0,0 +1,321 @@
+// Copyright (c) 2020 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#include "RunnerPool.h"
+
+#include <stdio.h>
+#include <unistd.h>
+#include <algorithm>
+#include <vector>
+
+#include "Environment.h"
+#include "bus/client/NativeContainer.h"
+#include "conf/SAMConf.h"
+#include "manager/NativeLogManager.h"
+#include "manager/ProcessSupervisor.h"
+#include "util/Logger.h"
+#include "util/ProcFs.h"
+
+const char* RunnerPool::STANDBY_ARGUMENT = "--standby";
+
+void RunnerPool::onChildExit(GPid pid, gint status, gpointer data)
+{
+    if (getInstance().m_releasedRunners.erase(pid) > 0) {
+        g_spawn_close_pid(pid);
+        return;
+    }
+
+    auto it = getInstance().m_idleRunners.find(pid);
+    if (it == getInstance().m_idleRunners.end()) {
+        // The runner was already handed over to an application
+        NativeContainer::onKillChildProcess(pid, status, data);
+        return;
+    }
+
+    Logger::warning(getInstance().getClassName(), __FUNCTION__, Logger::format("Idle runner(%d) was exited with status(%d)", pid, status));
+    g_spawn_close_pid(pid);
+    File::deleteFile(it->second.process.getStdFile());
+    getInstance().m_idleRunners.erase(it);
+    getInstance().scheduleRefill(REFILL_DELAY);
+}
+
+gboolean RunnerPool::onRefill(gpointer data)
+{
+    RunnerPool& pool = getInstance();
+    pool.m_refillTimer = 0;
+
+    if (pool.m_isFinalized)
+        return G_SOURCE_REMOVE;
+
+    if (pool.isUnderPressure()) {
+        pool.shrink();
+        return G_SOURCE_REMOVE;
+    }
+
+    // Only one runner is spawned at a time not to disturb other launches
+    const AppType types[] = { AppType::AppType_Native_Qml, AppType::AppType_Native_AppShell };
+    for (AppType type : types) {
+        if (pool.getIdleCount(type) >= SAMConf::getInstance().getRunnerPoolSize(pool.getRunnerName(type)))
+            continue;
+
+        if (pool.spawn(type))
+            pool.scheduleRefill(SPAWN_INTERVAL);
+        break;
+    }
+    return G_SOURCE_REMOVE;
+}
+
+gboolean RunnerPool::onPressureCheck(gpointer data)
+{
+    RunnerPool& pool = getInstance();
+    if (pool.m_isFinalized || pool.m_idleRunners.empty()) {
+        pool.m_pressureTimer = 0;
+        return G_SOURCE_REMOVE;
+    }
+    pool.shrink();
+    return G_SOURCE_CONTINUE;
+}
+
+RunnerPool::RunnerPool()
+    : m_refillTimer(0),
+      m_pressureTimer(0),
+      m_runnerCounter(1),
+      m_isFinalized(false)
+{
+    setClassName("RunnerPool");
+}
+
+RunnerPool::~RunnerPool()
+{
+}
+
+void RunnerPool::initialize()
+{
+    if (SAMConf::getInstance().getRunnerPoolSize(getRunnerName(AppType::AppType_Native_Qml)) <= 0 &&
+        SAMConf::getInstance().getRunnerPoolSize(getRunnerName(AppType::AppType_Native_AppShell)) <= 0) {
+        LOG_INFO(getClassName(), __FUNCTION__, "RunnerPool is disabled");
+        return;
+    }
+    // Filling pool is delayed not to disturb boot time launches
+    scheduleRefill(INITIAL_DELAY);
+}
+
+void RunnerPool::finalize()
+{
+    m_isFinalized = true;
+    if (m_refillTimer != 0) {
+        g_source_remove(m_refillTimer);
+        m_refillTimer = 0;
+    }
+    if (m_pressureTimer != 0) {
+        g_source_remove(m_pressureTimer);
+        m_pressureTimer = 0;
+    }
+    while (!m_idleRunners.empty()) {
+        release(m_idleRunners.begin()->first);
+    }
+}
+
+bool RunnerPool::handOver(AppType type, NativeProcess& process)
+{
+    if (type != AppType::AppType_Native_Qml && type != AppType::AppType_Native_AppShell)
+        return false;
+    if (SAMConf::getInstance().getRunnerPoolSize(getRunnerName(type)) <= 0)
+        return false;
+
+    auto it = m_idleRunners.begin();
+    for (; it != m_idleRunners.end(); ++it) {
+        if (it->second.type == type)
+            break;
+    }
+    if (it == m_idleRunners.end()) {
+        LOG_INFO(getClassName(), __FUNCTION__, getRunnerName(type), "No idle runner. Fallback to cold launch");
+        scheduleRefill(REFILL_DELAY);
+        return false;
+    }
+
+    JValue arguments = pbnjson::Array();
+    for (const string& argument : process.getArguments()) {
+        arguments.append(argument);
+    }
+    map<string, string> variables;
+    process.getEnvironments(variables);
+    JValue environments = pbnjson::Object();
+    for (auto env = variables.begin(); env != variables.end(); ++env) {
+        environments.put(env->first, env->second);
+    }
+    JValue message = pbnjson::Object();
+    message.put("arguments", arguments);
+    message.put("environments", environments);
+
+    pid_t pid = it->first;
+    NativeProcess& runner = it->second.process;
+    if (!runner.writeControl(message.stringify() + "\n")) {
+        Logger::warning(getClassName(), __FUNCTION__, Logger::format("Failed to hand over to runner(%d)", pid));
+        release(pid);
+        scheduleRefill(REFILL_DELAY);
+        return false;
+    }
+    runner.closeControlChannel();
+
+    // Application log should be located in the same place with cold launch
+    if (!process.getStdFile().empty() && rename(runner.getStdFile().c_str(), process.getStdFile().c_str()) != 0) {
+        Logger::warning(getClassName(), __FUNCTION__, runner.getStdFile(), "Failed to rename runner log");
+    }
+    process.closeStdFd();
+    process.setPid(pid);
+
+    LOG_INFO(getClassName(), __FUNCTION__, getRunnerName(type), Logger::format("Runner(%d) is handed over", pid));
+    m_idleRunners.erase(it);
+    scheduleRefill(REFILL_DELAY);
+    return true;
+}
+
+void RunnerPool::shrink()
+{
+    if (m_idleRunners.empty())
+        return;
+
+    long available = ProcFs::getAvailableMemory();
+    long threshold = SAMConf::getInstance().getRunnerPoolMemoryThreshold() * 1024L;
+    if (available < 0 || available >= threshold)
+        return;
+
+    // Release bigger runners first until expected available memory reaches to threshold
+    vector<pair<long, pid_t>> runners;
+    for (auto it = m_idleRunners.begin(); it != m_idleRunners.end(); ++it) {
+        runners.push_back(make_pair(ProcFs::getProcessRss(it->first), it->first));
+    }
+    sort(runners.rbegin(), runners.rend());
+
+    for (auto it = runners.begin(); it != runners.end() && available < threshold; ++it) {
+        LOG_INFO(getClassName(), __FUNCTION__, Logger::format("Release runner(%d) rss(%ld KB) available(%ld KB)", it->second, it->first, available));
+        release(it->second);
+        if (it->first > 0)
+            available += it->first;
+    }
+}
+
+void RunnerPool::toJson(JValue& json)
+{
+    long total = 0;
+    JValue runners = pbnjson::Array();
+    for (auto it = m_idleRunners.begin(); it != m_idleRunners.end(); ++it) {
+        long rss = ProcFs::getProcessRss(it->first);
+        JValue runner = pbnjson::Object();
+        runner.put("processId", (int)it->first);
+        runner.put("type", getRunnerName(it->second.type));
+        runner.put("rss", (int)rss);
+        runners.append(runner);
+        if (rss > 0)
+            total += rss;
+    }
+    json.put("idleRunners", runners);
+    json.put("rss", (int)total);
+}
+
+bool RunnerPool::spawn(AppType type)
+{
+    NativeProcess process;
+    process.setCommand(getRunnerPath(type));
+    process.addArgument(STANDBY_ARGUMENT);
+    process.setEnvironmentBlock(NativeContainer::getInstance().getEnvironmentBlock());
+    // also force the use of webos waylandinputcontext plugin
+    process.addEnv("QT_IM_MODULE", "wayland");
+    // Captured runner output is moved to the app buffer when it is handed over
+    int logFd = -1;
+    if (NativeLogManager::getInstance().isEnabled())
+        logFd = process.openStdPipe();
+    else
+        process.openStdFile(Logger::format("%s/%s-standby-%d", PATH_NATIVE_LOG, getRunnerName(type), m_runnerCounter++));
+
+    if (!process.openControlChannel() || !process.run()) {
+        Logger::error(getClassName(), __FUNCTION__, getRunnerName(type), "Failed to spawn idle runner");
+        process.closeControlChannel();
+        process.closeStdFd();
+        if (logFd >= 0)
+            close(logFd);
+        File::deleteFile(process.getStdFile());
+        return false;
+    }
+    process.closeStdFd();
+    if (logFd >= 0)
+        NativeLogManager::getInstance().attach(getRunnerName(type), process.getPid(), logFd);
+    process.track();
+    ProcessSupervisor::getInstance().watch(process.getPid(), onChildExit, nullptr);
+
+    LOG_INFO(getClassName(), __FUNCTION__, getRunnerName(type), Logger::format("Idle runner(%d) is spawned", process.getPid()));
+    IdleRunner& idleRunner = m_idleRunners[process.getPid()];
+    idleRunner.type = type;
+    idleRunner.process = process;
+    if (m_pressureTimer == 0)
+        m_pressureTimer = g_timeout_add(PRESSURE_INTERVAL, onPressureCheck, nullptr);
+    return true;
+}
+
+void RunnerPool::release(pid_t pid)
+{
+    auto it = m_idleRunners.find(pid);
+    if (it == m_idleRunners.end())
+        return;
+
+    // Closing stdin is enough for runners waiting handover. SIGTERM is sent for stuck ones.
+    it->second.process.closeControlChannel();
+    it->second.process.term();
+    File::deleteFile(it->second.process.getStdFile());
+    m_releasedRunners.insert(pid);
+    m_idleRunners.erase(it);
+}
+
+void RunnerPool::scheduleRefill(guint delay)
+{
+    if (m_refillTimer != 0 || m_isFinalized)
+        return;
+    m_refillTimer = g_timeout_add(delay, onRefill, nullptr);
+}
+
+const char* RunnerPool::getRunnerName(AppType type)
+{
+    if (type == AppType::AppType_Native_Qml)
+        return "QmlRunner";
+    return "AppShellRunner";
+}
+
+const string& RunnerPool::getRunnerPath(AppType type)
+{
+    if (type == AppType::AppType_Native_Qml)
+        return SAMConf::getInstance().getQmlRunnerPath();
+    return SAMConf::getInstance().getAppShellRunnerPath();
+}
+
+int RunnerPool::getIdleCount(AppType type)
+{
+    int count = 0;
+    for (auto it = m_idleRunners.begin(); it != m_idleRunners.end(); ++it) {
+        if (it->second.type == type)
+            count++;
+    }
+    return count;
+}
+
+bool RunnerPool::isUnderPressure()
+{
+    long available = ProcFs::getAvailableMemory();
+    if (available < 0)
+        return false;
+    return available < SAMConf::getInstance().getRunnerPoolMemoryThreshold() * 1024L;
+}
@@ -0,0 +1,96 @@
+// Copyright (c) 2020 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#ifndef MANAGER_RUNNERPOOL_H_
+#define MANAGER_RUNNERPOOL_H_
+
+#include <iostream>
+#include <map>
+#include <set>
+#include <glib.h>
+#include <pbnjson.hpp>
+
+#include "base/AppDescription.h"
+#include "interface/ISingleton.h"
+#include "interface/IClassName.h"
+#include "util/NativeProcess.h"
+
+using namespace std;
+using namespace pbnjson;
+
+// RunnerPool keeps idle qml / appshell runners which are spawned in advance.
+// Idle runner is launched with '--standby' and waits on stdin.
+// When a new app is launched, SAM writes one line JSON to stdin of the runner
+// {"arguments": [...], "environments": {...}}
+// Those are same arguments and environments which are used in cold launch.
+// Runner should exit if stdin is closed before receiving the message.
+class RunnerPool : public ISingleton<RunnerPool>,
+                   public IClassName {
+friend class ISingleton<RunnerPool>;
+public:
+    static void onChildExit(GPid pid, gint status, gpointer data);
+
+    virtual ~RunnerPool();
+
+    void initialize();
+    void finalize();
+
+    // Returns true if 'process' is taken over by idle runner
+    bool handOver(AppType type, NativeProcess& process);
+
+    // Release idle runners if the system doesn't have enough memory.
+    // It is checked every PRESSURE_INTERVAL while any idle runner exists, not in the launch path.
+    void shrink();
+
+    void toJson(JValue& json);
+
+private:
+    static const char* STANDBY_ARGUMENT;
+    static const int INITIAL_DELAY = 10000;
+    static const int REFILL_DELAY = 3000;
+    static const int SPAWN_INTERVAL = 500;
+    static const int PRESSURE_INTERVAL = 5000;
+
+    static gboolean onRefill(gpointer data);
+    static gboolean onPressureCheck(gpointer data);
+
+    struct IdleRunner {
+        AppType type;
+        NativeProcess process;
+    };
+
+    RunnerPool();
+
+    bool spawn(AppType type);
+    void release(pid_t pid);
+    void scheduleRefill(guint delay);
+
+    const char* getRunnerName(AppType type);
+    const string& getRunnerPath(AppType type);
+    int getIdleCount(AppType type);
+    bool isUnderPressure();
+
+    map<pid_t, IdleRunner> m_idleRunners;
+    set<pid_t> m_releasedRunners;
+    guint m_refillTimer;
+    guint m_pressureTimer;
+    int m_runnerCounter;
+    bool m_isFinalized;
+
+};
+
+#endif /* MANAGER_RUNNERPOOL_H_ */
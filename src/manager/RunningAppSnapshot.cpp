@@ -0,0 +1,262 @@
+// Copyright (c) 2020 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "RunningAppSnapshot.h"
+
+#include <algorithm>
+
+#include "Environment.h"
+#include "base/RunningAppList.h"
+#include "bus/service/ApplicationManager.h"
+#include "conf/Persistence.h"
+#include "util/JValueUtil.h"
+#include "util/Logger.h"
+#include "util/Time.h"
+
+gboolean RunningAppSnapshot::onSave(gpointer data)
+{
+    getInstance().m_saveTimer = 0;
+    getInstance().save();
+    return G_SOURCE_REMOVE;
+}
+
+gboolean RunningAppSnapshot::onReconcileTimeout(gpointer data)
+{
+    getInstance().m_reconcileTimer = 0;
+    Logger::warning(getInstance().getClassName(), __FUNCTION__,
+                    Logger::format("Reconciliation is timeout: web(%s) foreground(%s)",
+                    Logger::toString(getInstance().m_isWebReconciled), Logger::toString(getInstance().m_isForegroundReconciled)));
+    getInstance().complete();
+    return G_SOURCE_REMOVE;
+}
+
+RunningAppSnapshot::RunningAppSnapshot()
+    : m_saveTimer(0),
+      m_reconcileTimer(0),
+      m_isReconciling(false),
+      m_isWebReconciled(false),
+      m_isForegroundReconciled(false),
+      m_restoredCount(0),
+      m_droppedCount(0),
+      m_saveCount(0),
+      m_reconcileStart(0),
+      m_reconcileTime(0)
+{
+    setClassName("RunningAppSnapshot");
+}
+
+RunningAppSnapshot::~RunningAppSnapshot()
+{
+}
+
+void RunningAppSnapshot::initialize()
+{
+    restore();
+}
+
+void RunningAppSnapshot::finalize()
+{
+    if (m_reconcileTimer != 0) {
+        g_source_remove(m_reconcileTimer);
+        m_reconcileTimer = 0;
+    }
+    if (m_saveTimer != 0) {
+        g_source_remove(m_saveTimer);
+        m_saveTimer = 0;
+        save();
+    }
+}
+
+void RunningAppSnapshot::update()
+{
+    if (m_saveTimer != 0)
+        return;
+    m_saveTimer = g_idle_add(onSave, nullptr);
+}
+
+LifeStatus RunningAppSnapshot::getLifeStatus(const string& instanceId, LifeStatus defaultStatus)
+{
+    auto it = m_lifeStatuses.find(instanceId);
+    if (it == m_lifeStatuses.end())
+        return defaultStatus;
+    return it->second;
+}
+
+void RunningAppSnapshot::onWebAppsReconciled()
+{
+    if (!m_isReconciling || m_isWebReconciled)
+        return;
+
+    m_isWebReconciled = true;
+    if (m_isForegroundReconciled)
+        complete();
+}
+
+void RunningAppSnapshot::onForegroundReconciled(const vector<string>& foregroundAppIds)
+{
+    if (!m_isReconciling || m_isForegroundReconciled)
+        return;
+
+    // LSM sets BACKGROUND only for apps which were reported as foreground by itself
+    for (auto it = m_restored.begin(); it != m_restored.end(); ++it) {
+        RunningAppPtr runningApp = RunningAppList::getInstance().getByInstanceId(*it);
+        if (runningApp == nullptr || runningApp->getLifeStatus() != LifeStatus::LifeStatus_FOREGROUND)
+            continue;
+        if (find(foregroundAppIds.begin(), foregroundAppIds.end(), runningApp->getAppId()) == foregroundAppIds.end())
+            runningApp->setLifeStatus(LifeStatus::LifeStatus_BACKGROUND);
+    }
+
+    m_isForegroundReconciled = true;
+    if (m_isWebReconciled)
+        complete();
+}
+
+void RunningAppSnapshot::toJson(JValue& json)
+{
+    json.put("isReconciling", m_isReconciling);
+    json.put("restoredCount", m_restoredCount);
+    json.put("droppedCount", m_droppedCount);
+    json.put("saveCount", m_saveCount);
+    json.put("reconcileTime", (int64_t)m_reconcileTime);
+}
+
+void RunningAppSnapshot::restore()
+{
+    JValue snapshot = JDomParser::fromFile(PATH_RUNNING_SNAPSHOT);
+    JValue apps;
+    if (!JValueUtil::getValue(snapshot, "apps", apps) || !apps.isArray() || apps.arraySize() == 0)
+        return;
+
+    // Restored apps and reconciliation are posted together
+    ApplicationManager::getInstance().deferRunningPost();
+    m_isReconciling = true;
+    m_reconcileStart = Time::getCurrentTime();
+
+    for (int i = 0; i < apps.arraySize(); ++i) {
+        string instanceId;
+        string launchPointId;
+        int status = (int)LifeStatus::LifeStatus_BACKGROUND;
+
+        if (!JValueUtil::getValue(apps[i], "instanceId", instanceId) ||
+            !JValueUtil::getValue(apps[i], "launchPointId", launchPointId)) {
+            m_droppedCount++;
+            continue;
+        }
+        JValueUtil::getValue(apps[i], "lifeStatus", status);
+
+        // Transitions can't be continued by the new SAM
+        LifeStatus lifeStatus = (LifeStatus)status;
+        if (status < (int)LifeStatus::LifeStatus_STOP || status > (int)LifeStatus::LifeStatus_CLOSING ||
+            lifeStatus == LifeStatus::LifeStatus_STOP || RunningApp::isTransition(lifeStatus))
+            lifeStatus = LifeStatus::LifeStatus_BACKGROUND;
+
+        RunningAppPtr runningApp = RunningAppList::getInstance().createByLaunchPointId(launchPointId);
+        if (runningApp == nullptr) {
+            m_droppedCount++;
+            continue;
+        }
+
+        AppType appType = runningApp->getLaunchPoint()->getAppDesc()->getAppType();
+        if (appType == AppType::AppType_Stub || appType == AppType::AppType_None) {
+            m_droppedCount++;
+            continue;
+        }
+        if (appType != AppType::AppType_Web) {
+            // NativeContainer adopts the process if it is still alive
+            m_lifeStatuses[instanceId] = lifeStatus;
+            m_restored.insert(instanceId);
+            continue;
+        }
+
+        int displayId = -1;
+        int processId = 0;
+        string webprocessid;
+        JValueUtil::getValue(apps[i], "displayId", displayId);
+        JValueUtil::getValue(apps[i], "processId", processId);
+        JValueUtil::getValue(apps[i], "webprocessid", webprocessid);
+
+        JValue requestPayload = pbnjson::Object();
+        bool keepAlive = false;
+        string preload;
+        if (JValueUtil::getValue(apps[i], "keepAlive", keepAlive))
+            requestPayload.put("keepAlive", keepAlive);
+        if (JValueUtil::getValue(apps[i], "preload", preload))
+            requestPayload.put("preload", preload);
+        runningApp->loadRequestPayload(requestPayload);
+
+        runningApp->setInstanceId(instanceId);
+        runningApp->setDisplayId(displayId);
+        runningApp->setProcessId(processId);
+        runningApp->setWebprocid(webprocessid);
+        // New app is in WAM's CONTEXT_STOP. WAM removes it if it isn't listed by listRunningApps
+        runningApp->setLifeStatus(lifeStatus);
+        if (RunningAppList::getInstance().add(runningApp)) {
+            m_restored.insert(instanceId);
+            m_restoredCount++;
+        }
+    }
+
+    LOG_INFO(getClassName(), __FUNCTION__,
+             Logger::format("Restored: web(%d) native(%d) dropped(%d)",
+             m_restoredCount, (int)m_lifeStatuses.size(), m_droppedCount));
+    m_reconcileTimer = g_timeout_add(RECONCILE_TIMEOUT, onReconcileTimeout, nullptr);
+}
+
+void RunningAppSnapshot::save()
+{
+    JValue apps = pbnjson::Array();
+    const map<string, RunningAppPtr>& runningApps = RunningAppList::getInstance().getAll();
+    for (auto it = runningApps.begin(); it != runningApps.end(); ++it) {
+        RunningAppPtr runningApp = it->second;
+        JValue app = pbnjson::Object();
+        app.put("instanceId", runningApp->getInstanceId());
+        app.put("launchPointId", runningApp->getLaunchPointId());
+        app.put("processId", (int)runningApp->getProcessId());
+        app.put("displayId", runningApp->getDisplayId());
+        app.put("lifeStatus", (int)runningApp->getLifeStatus());
+        if (!runningApp->getWebprocessid().empty())
+            app.put("webprocessid", runningApp->getWebprocessid());
+        if (runningApp->isKeepAlive())
+            app.put("keepAlive", true);
+        if (!runningApp->getPreload().empty())
+            app.put("preload", runningApp->getPreload());
+        apps.append(app);
+    }
+
+    JValue snapshot = pbnjson::Object();
+    snapshot.put("apps", apps);
+    Persistence::getInstance().write(PATH_RUNNING_SNAPSHOT, snapshot);
+    m_saveCount++;
+}
+
+void RunningAppSnapshot::complete()
+{
+    if (!m_isReconciling)
+        return;
+
+    if (m_reconcileTimer != 0) {
+        g_source_remove(m_reconcileTimer);
+        m_reconcileTimer = 0;
+    }
+    m_isReconciling = false;
+    m_lifeStatuses.clear();
+    m_restored.clear();
+    m_reconcileTime = Time::getCurrentTime() - m_reconcileStart;
+
+    LOG_INFO(getClassName(), __FUNCTION__, Logger::format("Reconciled in %lld ms", m_reconcileTime));
+    ApplicationManager::getInstance().resumeRunningPost();
+    update();
+}
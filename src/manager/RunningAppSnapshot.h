@@ -0,0 +1,90 @@
+// Copyright (c) 2020 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef MANAGER_RUNNINGAPPSNAPSHOT_H_
+#define MANAGER_RUNNINGAPPSNAPSHOT_H_
+
+#include <iostream>
+#include <map>
+#include <set>
+#include <vector>
+#include <glib.h>
+#include <pbnjson.hpp>
+
+#include "base/RunningApp.h"
+#include "interface/ISingleton.h"
+#include "interface/IClassName.h"
+
+using namespace std;
+using namespace pbnjson;
+
+// RunningAppSnapshot keeps running apps in a tmpfs file, so a restarted SAM knows them in one step.
+//  - The snapshot is rewritten (through Persistence) after running apps or their life status are changed.
+//  - Web apps are restored directly. WAM removes the ones which are not running anymore.
+//  - Native apps are adopted by NativeContainer (/proc is checked there). Only their life status comes from here.
+//  - LSM demotes restored foreground apps which are not in foreground anymore.
+// 'running' is posted once after WAM and LSM are reconciled (or RECONCILE_TIMEOUT).
+// Luna tokens and registrations are not restored. Apps register again to the new SAM.
+class RunningAppSnapshot : public ISingleton<RunningAppSnapshot>,
+                           public IClassName {
+friend class ISingleton<RunningAppSnapshot>;
+public:
+    static const int RECONCILE_TIMEOUT = 3000; // ms
+
+    virtual ~RunningAppSnapshot();
+
+    // Should be called after apps are scanned and before luna clients are initialized
+    void initialize();
+    void finalize();
+
+    // Running apps or their life status are changed
+    void update();
+
+    LifeStatus getLifeStatus(const string& instanceId, LifeStatus defaultStatus);
+
+    void onWebAppsReconciled();
+    void onForegroundReconciled(const vector<string>& foregroundAppIds);
+
+    void toJson(JValue& json);
+
+private:
+    static gboolean onSave(gpointer data);
+    static gboolean onReconcileTimeout(gpointer data);
+
+    RunningAppSnapshot();
+
+    void restore();
+    void save();
+    void complete();
+
+    guint m_saveTimer;
+    guint m_reconcileTimer;
+    bool m_isReconciling;
+    bool m_isWebReconciled;
+    bool m_isForegroundReconciled;
+
+    map<string, LifeStatus> m_lifeStatuses;
+    set<string> m_restored;
+
+    int m_restoredCount;
+    int m_droppedCount;
+    int m_saveCount;
+    long long m_reconcileStart;
+    long long m_reconcileTime;
+
+};
+
+#endif /* MANAGER_RUNNINGAPPSNAPSHOT_H_ */
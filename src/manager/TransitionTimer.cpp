@@ -0,0 +1,255 @@
+// Copyright (c) 2020 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "TransitionTimer.h"
+
+#include <boost/bind.hpp>
+
+#include "base/AppDescription.h"
+#include "base/RunningAppList.h"
+#include "bus/client/AbsLifeHandler.h"
+#include "conf/SAMConf.h"
+#include "util/JValueUtil.h"
+#include "util/Logger.h"
+#include "util/Time.h"
+
+TransitionTimer::TransitionTimer()
+    : m_wheel(TICK),
+      m_source(0),
+      m_sourceExpiry(-1)
+{
+    setClassName("TransitionTimer");
+}
+
+TransitionTimer::~TransitionTimer()
+{
+    finalize();
+}
+
+void TransitionTimer::initialize()
+{
+}
+
+void TransitionTimer::finalize()
+{
+    if (m_source > 0) {
+        g_source_remove(m_source);
+        m_source = 0;
+        m_sourceExpiry = -1;
+    }
+}
+
+unsigned long TransitionTimer::add(int delay, TimerWheelCallback callback)
+{
+    unsigned long id = m_wheel.add(Time::getCurrentTime(), delay, callback);
+    arm();
+    return id;
+}
+
+void TransitionTimer::remove(unsigned long id)
+{
+    if (m_wheel.remove(id))
+        arm();
+}
+
+void TransitionTimer::start(RunningApp& runningApp)
+{
+    const string& instanceId = runningApp.getInstanceId();
+    stop(instanceId);
+
+    Deadline& deadline = m_deadlines[instanceId];
+    deadline.timer = 0;
+    deadline.appId = runningApp.getAppId();
+    deadline.status = runningApp.getLifeStatus();
+    deadline.next = 0;
+    deadline.backoff = 0;
+    loadSteps(runningApp, deadline.steps);
+
+    // App should be closed within the first step. Other transitions have longer deadline.
+    if (deadline.status == LifeStatus::LifeStatus_CLOSING)
+        schedule(instanceId, deadline, deadline.steps[0].delay);
+    else
+        schedule(instanceId, deadline, SAMConf::getInstance().getTransitionTimeout());
+}
+
+void TransitionTimer::stop(const string& instanceId)
+{
+    auto it = m_deadlines.find(instanceId);
+    if (it == m_deadlines.end())
+        return;
+
+    if (it->second.timer > 0)
+        m_wheel.remove(it->second.timer);
+    m_deadlines.erase(it);
+    arm();
+}
+
+void TransitionTimer::toJson(JValue& json)
+{
+    json.put("tick", TICK);
+    json.put("timers", (int)m_wheel.size());
+    json.put("deadlines", (int)m_deadlines.size());
+
+    JValue apps = pbnjson::Object();
+    for (auto it = m_counters.begin(); it != m_counters.end(); ++it) {
+        JValue app = pbnjson::Object();
+        JValue timeouts = pbnjson::Object();
+        for (auto timeout = it->second.timeouts.begin(); timeout != it->second.timeouts.end(); ++timeout)
+            timeouts.put(timeout->first, timeout->second);
+        app.put("timeouts", timeouts);
+        app.put("term", it->second.termCount);
+        app.put("kill", it->second.killCount);
+        apps.put(it->first, app);
+    }
+    json.put("apps", apps);
+}
+
+gboolean TransitionTimer::onTimeout(gpointer context)
+{
+    TransitionTimer& self = getInstance();
+    self.m_source = 0;
+    self.m_sourceExpiry = -1;
+
+    self.m_wheel.advance(Time::getCurrentTime());
+    self.arm();
+    return G_SOURCE_REMOVE;
+}
+
+const char* TransitionTimer::toString(Action action)
+{
+    switch (action) {
+    case Action::Action_Term:
+        return "term";
+
+    case Action::Action_Kill:
+        return "kill";
+    }
+    return "unknown";
+}
+
+void TransitionTimer::onDeadline(string instanceId)
+{
+    auto it = m_deadlines.find(instanceId);
+    if (it == m_deadlines.end())
+        return;
+    Deadline& deadline = it->second;
+    deadline.timer = 0;
+
+    RunningAppPtr runningApp = RunningAppList::getInstance().getByInstanceId(instanceId);
+    if (runningApp == nullptr) {
+        m_deadlines.erase(it);
+        return;
+    }
+
+    Counter& counter = m_counters[deadline.appId];
+    if (deadline.next == 0) {
+        counter.timeouts[RunningApp::toString(deadline.status)]++;
+        Logger::warning(getClassName(), __FUNCTION__, instanceId,
+                        Logger::format("Transition is timeout: %s", RunningApp::toString(deadline.status)));
+    }
+
+    // Non-closing transitions start the first step right after timeout
+    size_t index = deadline.next < deadline.steps.size() ? deadline.next : deadline.steps.size() - 1;
+    Step step = deadline.steps[index];
+
+    int delay = 0;
+    deadline.next++;
+    if (deadline.next < deadline.steps.size()) {
+        delay = deadline.steps[deadline.next].delay;
+    } else {
+        // Repeat the last step with backoff
+        int maxBackoff = SAMConf::getInstance().getKillMaxBackoff();
+        deadline.backoff = deadline.backoff > 0 ? deadline.backoff * 2 : step.delay * 2;
+        if (deadline.backoff > maxBackoff)
+            deadline.backoff = maxBackoff;
+        if (deadline.backoff < TICK)
+            deadline.backoff = TICK;
+        delay = deadline.backoff;
+    }
+    schedule(instanceId, deadline, delay);
+
+    Logger::warning(getClassName(), __FUNCTION__, instanceId,
+                    Logger::format("step(%d) action(%s) next(%dms)", (int)index, toString(step.action), delay));
+
+    // The action can remove the app synchronously. 'deadline' should not be used after this.
+    if (step.action == Action::Action_Term) {
+        counter.termCount++;
+        AbsLifeHandler::getLifeHandler(runningApp).term(runningApp);
+    } else {
+        counter.killCount++;
+        AbsLifeHandler::getLifeHandler(runningApp).kill(runningApp);
+    }
+}
+
+void TransitionTimer::loadSteps(RunningApp& runningApp, vector<Step>& steps)
+{
+    steps.clear();
+
+    string appType = AppDescription::toString(runningApp.getLaunchPoint()->getAppDesc()->getAppType());
+    JValue escalation = SAMConf::getInstance().getKillEscalation(appType);
+    for (int i = 0; i < escalation.arraySize(); ++i) {
+        string action = "";
+        Step step;
+        step.delay = 0;
+        JValueUtil::getValue(escalation[i], "action", action);
+        JValueUtil::getValue(escalation[i], "delay", step.delay);
+
+        if (action == "term") {
+            step.action = Action::Action_Term;
+        } else if (action == "kill") {
+            step.action = Action::Action_Kill;
+        } else {
+            Logger::warning(getClassName(), __FUNCTION__, Logger::format("Unknown action: %s", action.c_str()));
+            continue;
+        }
+        if (step.delay < 0)
+            step.delay = 0;
+        steps.push_back(step);
+    }
+
+    if (steps.empty()) {
+        Step step;
+        step.action = Action::Action_Kill;
+        step.delay = 1000;
+        steps.push_back(step);
+    }
+}
+
+void TransitionTimer::schedule(const string& instanceId, Deadline& deadline, int delay)
+{
+    deadline.timer = add(delay, boost::bind(&TransitionTimer::onDeadline, this, instanceId));
+}
+
+void TransitionTimer::arm()
+{
+    long long expiry = m_wheel.getNextExpiry();
+    if (expiry == m_sourceExpiry && m_source > 0)
+        return;
+
+    if (m_source > 0) {
+        g_source_remove(m_source);
+        m_source = 0;
+        m_sourceExpiry = -1;
+    }
+    if (expiry < 0)
+        return;
+
+    long long timeout = expiry - Time::getCurrentTime();
+    if (timeout < 0)
+        timeout = 0;
+    m_source = g_timeout_add((guint)timeout, onTimeout, nullptr);
+    m_sourceExpiry = expiry;
+}
@@ -0,0 +1,109 @@
+// Copyright (c) 2020 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef MANAGER_TRANSITIONTIMER_H_
+#define MANAGER_TRANSITIONTIMER_H_
+
+#include <iostream>
+#include <map>
+#include <vector>
+#include <glib.h>
+#include <pbnjson.hpp>
+
+#include "base/RunningApp.h"
+#include "interface/ISingleton.h"
+#include "interface/IClassName.h"
+#include "util/TimerWheel.h"
+
+using namespace std;
+using namespace pbnjson;
+
+// TransitionTimer keeps all transition deadlines of running apps in a single timer wheel.
+// Only one GLib timeout is armed for the nearest deadline.
+//
+// If an app doesn't finish the transition in time, it is terminated step by step.
+// The close event (or WAM killApp) is the first step and it is sent by the close request.
+// Next steps come from 'TransitionTimeout.Escalation' in sam-conf per app type.
+// The last step is repeated with doubled delay until 'MaxBackoff'.
+class TransitionTimer : public ISingleton<TransitionTimer>,
+                        public IClassName {
+friend class ISingleton<TransitionTimer>;
+public:
+    static const int TICK = 10; // ms
+    static const int DEFAULT_TRANSITION_TIMEOUT = 10000;
+    static const int DEFAULT_MAX_BACKOFF = 8000;
+
+    virtual ~TransitionTimer();
+
+    void initialize();
+    void finalize();
+
+    // Generic one-shot timers on the shared wheel
+    unsigned long add(int delay, TimerWheelCallback callback);
+    void remove(unsigned long id);
+
+    // Deadline for the current transition of the app. CLOSING starts escalation directly
+    void start(RunningApp& runningApp);
+    void stop(const string& instanceId);
+
+    void toJson(JValue& json);
+
+private:
+    enum Action {
+        Action_Term,
+        Action_Kill,
+    };
+
+    struct Step {
+        Action action;
+        int delay;
+    };
+
+    struct Deadline {
+        unsigned long timer;
+        string appId;
+        LifeStatus status;
+        vector<Step> steps;
+        size_t next;
+        int backoff;
+    };
+
+    struct Counter {
+        map<string, int> timeouts;
+        int termCount;
+        int killCount;
+    };
+
+    static gboolean onTimeout(gpointer context);
+    static const char* toString(Action action);
+
+    TransitionTimer();
+
+    void onDeadline(string instanceId);
+    void loadSteps(RunningApp& runningApp, vector<Step>& steps);
+    void schedule(const string& instanceId, Deadline& deadline, int delay);
+    void arm();
+
+    TimerWheel m_wheel;
+    guint m_source;
+    long long m_sourceExpiry;
+
+    map<string, Deadline> m_deadlines;
+    map<string, Counter> m_counters;
+
+};
+
+#endif /* MANAGER_TRANSITIONTIMER_H_ */
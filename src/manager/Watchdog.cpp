@@ -0,0 +1,287 @@
+// Copyright (c) 2020 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Watchdog.h"
+
+#include <execinfo.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+#include "conf/SAMConf.h"
+#include "manager/FlightRecorder.h"
+#include "util/Logger.h"
+#include "util/Time.h"
+
+// Filled by the signal handler in the main thread
+static void* s_frames[Watchdog::MAX_FRAMES];
+static volatile sig_atomic_t s_frameCount = 0;
+static volatile sig_atomic_t s_isCaptured = 0;
+
+static const int CAPTURE_TIMEOUT = 100; // ms
+
+GSourceFuncs Watchdog::s_sourceFuncs = {
+    Watchdog::onPrepare,
+    Watchdog::onCheck,
+    Watchdog::onDispatch,
+    nullptr
+};
+
+gboolean Watchdog::onPrepare(GSource* source, gint* timeout)
+{
+    getInstance().onIterationFinished();
+    *timeout = -1;
+    return FALSE;
+}
+
+gboolean Watchdog::onCheck(GSource* source)
+{
+    getInstance().onIterationStarted();
+    return FALSE;
+}
+
+gboolean Watchdog::onDispatch(GSource* source, GSourceFunc callback, gpointer data)
+{
+    // The heartbeat source is never ready
+    return G_SOURCE_CONTINUE;
+}
+
+gpointer Watchdog::onWatchdogThread(gpointer data)
+{
+    getInstance().run();
+    return nullptr;
+}
+
+void Watchdog::onBacktraceSignal(int signal)
+{
+    s_frameCount = backtrace(s_frames, MAX_FRAMES);
+    s_isCaptured = 1;
+}
+
+Watchdog::Watchdog()
+    : m_source(nullptr),
+      m_thread(nullptr),
+      m_threshold(DEFAULT_THRESHOLD),
+      m_mainThreadId(0),
+      m_isStopping(false),
+      m_busyStart(0),
+      m_capturedStart(0),
+      m_stallCount(0),
+      m_stallTime(0)
+{
+    setClassName("Watchdog");
+    g_mutex_init(&m_mutex);
+    g_cond_init(&m_cond);
+    m_activity[0] = '\0';
+}
+
+Watchdog::~Watchdog()
+{
+    g_cond_clear(&m_cond);
+    g_mutex_clear(&m_mutex);
+}
+
+void Watchdog::initialize()
+{
+    if (m_thread != nullptr)
+        return;
+
+    m_threshold = SAMConf::getInstance().getStallThreshold();
+    if (m_threshold <= 0) {
+        LOG_INFO(getClassName(), __FUNCTION__, "Watchdog is disabled");
+        return;
+    }
+    m_mainThreadId = (pid_t)syscall(SYS_gettid);
+
+    // The first backtrace() loads libgcc. It should not happen in the signal handler
+    s_frameCount = backtrace(s_frames, MAX_FRAMES);
+
+    struct sigaction act;
+    memset(&act, 0, sizeof(act));
+    sigemptyset(&act.sa_mask);
+    act.sa_handler = onBacktraceSignal;
+    act.sa_flags = SA_RESTART;
+    sigaction(SIGNAL_BACKTRACE, &act, NULL);
+
+    m_source = g_source_new(&s_sourceFuncs, sizeof(GSource));
+    g_source_set_priority(m_source, G_PRIORITY_HIGH - 100);
+    g_source_set_name(m_source, "watchdog");
+    g_source_attach(m_source, nullptr);
+
+    m_isStopping = false;
+    m_thread = g_thread_new("watchdog", onWatchdogThread, nullptr);
+}
+
+void Watchdog::finalize()
+{
+    if (m_thread != nullptr) {
+        g_mutex_lock(&m_mutex);
+        m_isStopping = true;
+        g_cond_broadcast(&m_cond);
+        g_mutex_unlock(&m_mutex);
+
+        g_thread_join(m_thread);
+        m_thread = nullptr;
+        signal(SIGNAL_BACKTRACE, SIG_DFL);
+    }
+
+    if (m_source != nullptr) {
+        g_source_destroy(m_source);
+        g_source_unref(m_source);
+        m_source = nullptr;
+    }
+}
+
+void Watchdog::setActivity(const char* activity)
+{
+    if (m_thread == nullptr)
+        return;
+
+    g_mutex_lock(&m_mutex);
+    g_strlcpy(m_activity, activity != nullptr ? activity : "", MAX_ACTIVITY);
+    g_mutex_unlock(&m_mutex);
+}
+
+void Watchdog::toJson(JValue& json)
+{
+    json.put("enabled", m_thread != nullptr);
+    json.put("threshold", m_threshold);
+    json.put("stallCount", m_stallCount);
+    json.put("stallTime", (int64_t)m_stallTime);
+
+    JValue durations = pbnjson::Object();
+    m_durations.toJson(durations);
+    json.put("durations", durations);
+
+    JValue stalls = pbnjson::Array();
+    for (auto it = m_stalls.rbegin(); it != m_stalls.rend(); ++it) {
+        JValue stall = pbnjson::Object();
+        stall.put("time", (int64_t)it->time);
+        stall.put("duration", (int64_t)it->duration);
+        stall.put("activity", it->activity);
+
+        JValue backtrace = pbnjson::Array();
+        for (auto frame = it->backtrace.begin(); frame != it->backtrace.end(); ++frame)
+            backtrace.append(*frame);
+        stall.put("backtrace", backtrace);
+        stalls.append(stall);
+    }
+    json.put("stalls", stalls);
+}
+
+void Watchdog::onIterationStarted()
+{
+    long long now = Time::getCurrentTime();
+
+    g_mutex_lock(&m_mutex);
+    m_busyStart = now;
+    g_mutex_unlock(&m_mutex);
+}
+
+void Watchdog::onIterationFinished()
+{
+    long long now = Time::getCurrentTime();
+    bool isStalled = false;
+    Stall stall;
+
+    g_mutex_lock(&m_mutex);
+    if (m_busyStart > 0 && now - m_busyStart > m_threshold) {
+        isStalled = true;
+        stall.time = m_busyStart;
+        stall.duration = now - m_busyStart;
+        stall.activity = m_activity;
+        if (m_capturedStart == m_busyStart)
+            stall.backtrace.swap(m_capturedBacktrace);
+    }
+    m_busyStart = 0;
+    m_activity[0] = '\0';
+    g_mutex_unlock(&m_mutex);
+
+    if (isStalled)
+        record(stall);
+}
+
+void Watchdog::run()
+{
+    g_mutex_lock(&m_mutex);
+    while (!m_isStopping) {
+        gint64 deadline = g_get_monotonic_time() + m_threshold * G_TIME_SPAN_MILLISECOND / 2;
+        g_cond_wait_until(&m_cond, &m_mutex, deadline);
+        if (m_isStopping)
+            break;
+
+        long long busyStart = m_busyStart;
+        if (busyStart == 0 || busyStart == m_capturedStart || Time::getCurrentTime() - busyStart <= m_threshold)
+            continue;
+
+        string activity = m_activity;
+        m_capturedStart = busyStart;
+        g_mutex_unlock(&m_mutex);
+
+        vector<string> backtrace;
+        capture(backtrace);
+        Logger::warning(getClassName(), __FUNCTION__,
+                        Logger::format("Main loop is busy over %d ms: activity(%s)", m_threshold, activity.c_str()));
+
+        g_mutex_lock(&m_mutex);
+        if (m_busyStart == busyStart)
+            m_capturedBacktrace.swap(backtrace);
+    }
+    g_mutex_unlock(&m_mutex);
+}
+
+void Watchdog::capture(vector<string>& backtrace)
+{
+    s_isCaptured = 0;
+    if (syscall(SYS_tgkill, getpid(), m_mainThreadId, SIGNAL_BACKTRACE) != 0)
+        return;
+
+    for (int i = 0; i < CAPTURE_TIMEOUT && !s_isCaptured; ++i)
+        g_usleep(1000);
+    if (!s_isCaptured)
+        return;
+    __sync_synchronize();
+
+    char** symbols = backtrace_symbols(s_frames, s_frameCount);
+    if (symbols == nullptr)
+        return;
+
+    // The first frame is the signal handler
+    for (int i = 1; i < s_frameCount; ++i)
+        backtrace.push_back(symbols[i]);
+    free(symbols);
+}
+
+void Watchdog::record(Stall& stall)
+{
+    m_stallCount++;
+    m_stallTime += stall.duration;
+    m_durations.add(stall.duration);
+    FlightRecorder::getInstance().recordStall(stall.activity, (int)stall.duration);
+
+    Logger::warning(getClassName(), __FUNCTION__,
+                    Logger::format("Main loop was stalled: duration(%lld ms) activity(%s) frames(%d)",
+                    stall.duration, stall.activity.c_str(), (int)stall.backtrace.size()));
+
+    m_stalls.push_back(Stall());
+    m_stalls.back().time = stall.time;
+    m_stalls.back().duration = stall.duration;
+    m_stalls.back().activity.swap(stall.activity);
+    m_stalls.back().backtrace.swap(stall.backtrace);
+    if (m_stalls.size() > MAX_STALLS)
+        m_stalls.pop_front();
+}
@@ -0,0 +1,109 @@
+// Copyright (c) 2020 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef MANAGER_WATCHDOG_H_
+#define MANAGER_WATCHDOG_H_
+
+#include <iostream>
+#include <deque>
+#include <vector>
+#include <signal.h>
+#include <sys/types.h>
+#include <glib.h>
+#include <pbnjson.hpp>
+
+#include "interface/ISingleton.h"
+#include "interface/IClassName.h"
+#include "util/Histogram.h"
+
+using namespace std;
+using namespace pbnjson;
+
+// Watchdog detects main loop iterations which take longer than 'Watchdog.StallThreshold' (ms) in sam-conf.
+//  - A heartbeat source is prepared and checked in every iteration, but it is never dispatched.
+//    The time between 'check' (after poll) and the next 'prepare' is the time spent in callbacks.
+//  - The watchdog thread wakes up every half threshold. If the main loop is still busy over the threshold,
+//    it takes a backtrace of the main thread (SIGNAL_BACKTRACE) and the current activity.
+//  - The stall is recorded by the main loop when the iteration is finished.
+// The activity is the API or callback which is set by setActivity(). It is cleared in every iteration.
+class Watchdog : public ISingleton<Watchdog>,
+                 public IClassName {
+friend class ISingleton<Watchdog>;
+public:
+    static const int DEFAULT_THRESHOLD = 500; // ms
+    static const int MAX_STALLS = 16;
+    static const int MAX_FRAMES = 32;
+    static const int MAX_ACTIVITY = 128;
+    static const int SIGNAL_BACKTRACE = SIGUSR2;
+
+    virtual ~Watchdog();
+
+    // Should be called in the main thread
+    void initialize();
+    void finalize();
+
+    void setActivity(const char* activity);
+
+    void toJson(JValue& json);
+
+private:
+    struct Stall {
+        long long time;
+        long long duration;
+        string activity;
+        vector<string> backtrace;
+    };
+
+    static gboolean onPrepare(GSource* source, gint* timeout);
+    static gboolean onCheck(GSource* source);
+    static gboolean onDispatch(GSource* source, GSourceFunc callback, gpointer data);
+    static gpointer onWatchdogThread(gpointer data);
+    static void onBacktraceSignal(int signal);
+
+    static GSourceFuncs s_sourceFuncs;
+
+    Watchdog();
+
+    void onIterationStarted();
+    void onIterationFinished();
+
+    void run();
+    void capture(vector<string>& backtrace);
+    void record(Stall& stall);
+
+    GSource* m_source;
+    GThread* m_thread;
+    int m_threshold;
+    pid_t m_mainThreadId;
+
+    // shared with the watchdog thread (m_mutex)
+    GMutex m_mutex;
+    GCond m_cond;
+    bool m_isStopping;
+    long long m_busyStart;
+    char m_activity[MAX_ACTIVITY];
+    long long m_capturedStart;
+    vector<string> m_capturedBacktrace;
+
+    // main loop only
+    deque<Stall> m_stalls;
+    int m_stallCount;
+    long long m_stallTime;
+    Histogram m_durations;
+
+};
+
+#endif /* MANAGER_WATCHDOG_H_ */
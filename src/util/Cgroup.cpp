@@ -0,0 +1,201 @@
+// Copyright (c) 2020 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#include "Cgroup.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/vfs.h>
+#include <linux/magic.h>
+
+#include "util/Logger.h"
+
+const string Cgroup::CLASS_NAME = "Cgroup";
+
+Cgroup::Cgroup()
+{
+}
+
+Cgroup::~Cgroup()
+{
+}
+
+bool Cgroup::isAvailable(const string& path)
+{
+    struct statfs buf;
+    if (statfs(path.c_str(), &buf) == -1)
+        return false;
+    return buf.f_type == CGROUP2_SUPER_MAGIC;
+}
+
+bool Cgroup::enableControllers(const string& path, const string& controllers)
+{
+    return writeValue(path, "cgroup.subtree_control", controllers);
+}
+
+bool Cgroup::create(const string& path, bool exclusive)
+{
+    if (mkdir(path.c_str(), 0755) == -1 && (exclusive || errno != EEXIST)) {
+        Logger::error(CLASS_NAME, __FUNCTION__, path, strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+bool Cgroup::remove(const string& path)
+{
+    // Non-empty cgroup can't be removed. It fails with EBUSY
+    if (rmdir(path.c_str()) == -1 && errno != ENOENT) {
+        return false;
+    }
+    return true;
+}
+
+vector<string> Cgroup::getChildren(const string& path)
+{
+    vector<string> children;
+    DIR* dir = opendir(path.c_str());
+    if (dir == NULL)
+        return children;
+
+    struct dirent* entry = NULL;
+    while ((entry = readdir(dir)) != NULL) {
+        if (entry->d_type != DT_DIR || strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0)
+            continue;
+        children.push_back(path + "/" + entry->d_name);
+    }
+    closedir(dir);
+    return children;
+}
+
+bool Cgroup::attach(const string& path, pid_t pid)
+{
+    return writeValue(path, "cgroup.procs", std::to_string(pid));
+}
+
+bool Cgroup::setMemoryHigh(const string& path, long long bytes)
+{
+    return writeValue(path, "memory.high", std::to_string(bytes));
+}
+
+long long Cgroup::getMemoryCurrent(const string& path)
+{
+    FILE* fp = fopen((path + "/memory.current").c_str(), "r");
+    if (fp == NULL)
+        return -1;
+
+    long long current = -1;
+    if (fscanf(fp, "%lld", &current) != 1)
+        current = -1;
+    fclose(fp);
+    return current;
+}
+
+long long Cgroup::getMemoryAnon(const string& path)
+{
+    FILE* fp = fopen((path + "/memory.stat").c_str(), "r");
+    if (fp == NULL)
+        return -1;
+
+    char line[128];
+    long long anon = -1;
+    while (fgets(line, sizeof(line), fp) != NULL) {
+        if (sscanf(line, "anon %lld", &anon) == 1)
+            break;
+    }
+    fclose(fp);
+    return anon;
+}
+
+long long Cgroup::getCpuUsage(const string& path)
+{
+    FILE* fp = fopen((path + "/cpu.stat").c_str(), "r");
+    if (fp == NULL)
+        return -1;
+
+    char line[128];
+    long long usage = -1;
+    while (fgets(line, sizeof(line), fp) != NULL) {
+        if (sscanf(line, "usage_usec %lld", &usage) == 1)
+            break;
+    }
+    fclose(fp);
+    return usage;
+}
+
+bool Cgroup::isPopulated(const string& path)
+{
+    FILE* fp = fopen((path + "/cgroup.events").c_str(), "r");
+    if (fp == NULL)
+        return false;
+
+    char line[64];
+    int populated = 0;
+    while (fgets(line, sizeof(line), fp) != NULL) {
+        if (sscanf(line, "populated %d", &populated) == 1)
+            break;
+    }
+    fclose(fp);
+    return populated != 0;
+}
+
+int Cgroup::signal(const string& path, int sig)
+{
+    FILE* fp = fopen((path + "/cgroup.procs").c_str(), "r");
+    if (fp == NULL)
+        return 0;
+
+    int count = 0;
+    pid_t pid = 0;
+    while (fscanf(fp, "%d", &pid) == 1) {
+        if (::kill(pid, sig) == 0)
+            count++;
+    }
+    fclose(fp);
+    return count;
+}
+
+bool Cgroup::kill(const string& path)
+{
+    if (access((path + "/cgroup.kill").c_str(), W_OK) == 0 && writeValue(path, "cgroup.kill", "1"))
+        return true;
+    return signal(path, SIGKILL) > 0;
+}
+
+bool Cgroup::writeValue(const string& path, const char* file, const string& value)
+{
+    string filePath = path + "/" + file;
+    int fd = open(filePath.c_str(), O_WRONLY | O_CLOEXEC);
+    if (fd == -1) {
+        Logger::error(CLASS_NAME, __FUNCTION__, filePath, strerror(errno));
+        return false;
+    }
+
+    bool result = true;
+    if (write(fd, value.c_str(), value.size()) != (ssize_t)value.size()) {
+        Logger::error(CLASS_NAME, __FUNCTION__, filePath, strerror(errno));
+        result = false;
+    }
+    close(fd);
+    return result;
+}
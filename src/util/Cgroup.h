@@ -0,0 +1,77 @@
+// Copyright (c) 2020 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#ifndef UTIL_CGROUP_H_
+#define UTIL_CGROUP_H_
+
+#include <iostream>
+#include <vector>
+#include <sys/types.h>
+
+using namespace std;
+
+// Cgroup handles a cgroup v2 directory. All functions take the absolute path of the cgroup.
+class Cgroup {
+public:
+    // Returns true if 'path' is in cgroup v2 hierarchy
+    static bool isAvailable(const string& path);
+
+    // Enables controllers (e.g. "+memory +cpu") for children of 'path'
+    static bool enableControllers(const string& path, const string& controllers);
+
+    // If 'exclusive' is true, an existing cgroup is regarded as an error
+    static bool create(const string& path, bool exclusive = false);
+    static bool remove(const string& path);
+
+    // Returns absolute paths of child cgroups
+    static vector<string> getChildren(const string& path);
+
+    // Moves the process into the cgroup. Its children follow the process.
+    static bool attach(const string& path, pid_t pid);
+
+    static bool setMemoryHigh(const string& path, long long bytes);
+
+    // Returns 'memory.current' (bytes). -1 means unknown
+    static long long getMemoryCurrent(const string& path);
+
+    // Returns 'anon' in 'memory.stat' (bytes). Unlike 'memory.current', page cache is not included. -1 means unknown
+    static long long getMemoryAnon(const string& path);
+
+    // Returns 'usage_usec' in 'cpu.stat'. -1 means unknown
+    static long long getCpuUsage(const string& path);
+
+    // Returns true if any process is in the cgroup
+    static bool isPopulated(const string& path);
+
+    // Sends the signal to all processes in the cgroup. Returns the number of signaled processes
+    static int signal(const string& path, int sig);
+
+    // Kills all processes in the cgroup at once with 'cgroup.kill' (Linux 5.14).
+    // Otherwise, SIGKILL is sent to each process.
+    static bool kill(const string& path);
+
+    Cgroup();
+    virtual ~Cgroup();
+
+private:
+    static const string CLASS_NAME;
+
+    static bool writeValue(const string& path, const char* file, const string& value);
+
+};
+
+#endif /* UTIL_CGROUP_H_ */
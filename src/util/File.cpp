@@ -16,6 +16,9 @@
 
 #include "File.h"
 
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <unistd.h>
@@ -55,6 +58,48 @@ bool File::writeFile(const string &path, const string& buffer)
     return true;
 }
 
+bool File::writeFileAtomic(const string& filePath, const string& buffer)
+{
+    string tempPath = filePath + ".tmp";
+    int fd = open(tempPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0)
+        return false;
+
+    const char* data = buffer.c_str();
+    size_t remaining = buffer.length();
+    while (remaining > 0) {
+        ssize_t written = write(fd, data, remaining);
+        if (written < 0) {
+            if (errno == EINTR)
+                continue;
+            close(fd);
+            unlink(tempPath.c_str());
+            return false;
+        }
+        data += written;
+        remaining -= written;
+    }
+
+    if (fsync(fd) != 0 || close(fd) != 0) {
+        unlink(tempPath.c_str());
+        return false;
+    }
+    if (rename(tempPath.c_str(), filePath.c_str()) != 0) {
+        unlink(tempPath.c_str());
+        return false;
+    }
+
+    // The rename itself is durable only after the directory is synced
+    size_t pos = filePath.find_last_of('/');
+    string directory = (pos == string::npos) ? "." : (pos == 0 ? "/" : filePath.substr(0, pos));
+    int dirFd = open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dirFd >= 0) {
+        fsync(dirFd);
+        close(dirFd);
+    }
+    return true;
+}
+
 bool File::concatToFilename(const string originPath, string& returnPath, const string addingStr)
 {
     if (originPath.empty() || addingStr.empty())
@@ -131,6 +176,15 @@ bool File::deleteFile(const string& path)
     return true;
 }
 
+void File::prefetch(const string& path)
+{
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+        return;
+    posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+    close(fd);
+}
+
 string File::join(const string& a, const string& b)
 {
     string path = "";
@@ -31,6 +31,9 @@ public:
     static void set_slash_to_base_path(string& path);
     static string readFile(const string& file_name);
     static bool writeFile(const string& filePath, const string& buffer);
+    // Writes a temporary file, syncs it and renames it over 'filePath'.
+    // Readers see either the old file or the new one, never a partial file.
+    static bool writeFileAtomic(const string& filePath, const string& buffer);
     static bool concatToFilename(const string originPath, string& returnPath, const string addingStr);
 
     static bool isDirectory(const string& path);
@@ -38,6 +41,7 @@ public:
     static bool makeDirectory(const string& path);
     static bool createFile(const string& path);
     static bool deleteFile(const string& path);
+    static void prefetch(const string& path);
 
     static string join(const string& a, const string& b);
 
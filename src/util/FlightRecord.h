@@ -0,0 +1,80 @@
+// Copyright (c) 2020 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef UTIL_FLIGHTRECORD_H_
+#define UTIL_FLIGHTRECORD_H_
+
+#include <stdint.h>
+
+// Binary format of the flight recorder file. It is shared with tools/FlightDecoder.cpp.
+// The version should be increased if any layout is changed.
+//
+//   FlightHeader                      (FLIGHT_HEADER_SIZE bytes)
+//   FlightString x stringCapacity     interned strings. Index 0 is empty
+//   FlightRecord x capacity           ring of records. The record of sequence N is in slot (N & (capacity - 1))
+//
+// All integers are in the native byte order. Times are CLOCK_MONOTONIC in microseconds.
+// 'startRealTime' and 'startTime' are taken at the same time, so record times can be converted to wall clock.
+
+#define FLIGHT_MAGIC            0x544c4653 // "SFLT"
+#define FLIGHT_VERSION          1
+#define FLIGHT_HEADER_SIZE      128
+#define FLIGHT_STRING_SIZE      64
+
+enum FlightRecordType {
+    FlightRecordType_None = 0,
+    FlightRecordType_Start,         // arg0 : pid of SAM
+    FlightRecordType_LifeStatus,    // subject : appId, detail : new status, arg0 : old status, arg1 : pid
+    FlightRecordType_ApiRequest,    // subject : method, arg0 : request size
+    FlightRecordType_ApiResponse,   // subject : method, arg0 : errorCode, arg1 : latency (ms)
+    FlightRecordType_CallRequest,   // subject : outbound method, arg0 : request size
+    FlightRecordType_CallResponse,  // subject : outbound method, arg0 : errorCode, arg1 : latency (ms)
+    FlightRecordType_ChildExit,     // subject : appId, arg0 : pid, arg1 : wait status
+    FlightRecordType_Stall,         // subject : activity, arg0 : duration (ms)
+};
+
+struct FlightHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t recordSize;
+    uint32_t capacity;          // records. Power of two
+    uint32_t stringCapacity;
+    uint32_t stringCount;       // updated after the string is written
+    int32_t pid;
+    int64_t startRealTime;      // CLOCK_REALTIME (us)
+    int64_t startTime;          // CLOCK_MONOTONIC (us)
+    uint64_t head;              // sequence of the last record. The first record is 1
+    uint8_t reserved[FLIGHT_HEADER_SIZE - 48];
+};
+
+struct FlightString {
+    char text[FLIGHT_STRING_SIZE];
+};
+
+// 'seq' is cleared while the record is written. The record is valid only if 'seq' is
+// the lower 32 bits of the sequence which belongs to its slot.
+struct FlightRecord {
+    uint32_t seq;
+    uint8_t type;
+    uint8_t reserved[3];
+    int64_t time;
+    uint32_t subject;           // string index
+    uint32_t detail;            // string index
+    int32_t arg0;
+    int32_t arg1;
+};
+
+#endif /* UTIL_FLIGHTRECORD_H_ */
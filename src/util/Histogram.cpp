@@ -0,0 +1,136 @@
+// Copyright (c) 2020 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#include "Histogram.h"
+
+#include <string.h>
+
+#include "util/JValueUtil.h"
+
+// The last bucket has no upper bound
+const long long Histogram::TIME_BOUNDS[BUCKET_COUNT] = {
+    1, 2, 5, 10, 20, 50, 100, 200, 500, 1000, 2000, 5000, 10000, 20000, 50000, -1
+};
+
+const long long Histogram::SIZE_BOUNDS[BUCKET_COUNT] = {
+    64, 128, 256, 512, 1024, 2048, 4096, 8192, 16384, 32768, 65536, 131072, 262144, 524288, 1048576, -1
+};
+
+static const char* toString(HistogramUnit unit)
+{
+    switch (unit) {
+    case HistogramUnit::HistogramUnit_US:
+        return "us";
+    case HistogramUnit::HistogramUnit_BYTES:
+        return "bytes";
+    default:
+        return "ms";
+    }
+}
+
+Histogram::Histogram(HistogramUnit unit)
+    : m_unit(unit),
+      m_bounds(unit == HistogramUnit::HistogramUnit_BYTES ? SIZE_BOUNDS : TIME_BOUNDS)
+{
+    reset();
+}
+
+Histogram::~Histogram()
+{
+}
+
+void Histogram::add(long long value)
+{
+    if (value < 0)
+        return;
+
+    int index = 0;
+    while (index < BUCKET_COUNT - 1 && value > m_bounds[index])
+        index++;
+
+    m_buckets[index]++;
+    if (m_count == 0 || value < m_min)
+        m_min = value;
+    if (m_count == 0 || value > m_max)
+        m_max = value;
+    m_count++;
+    m_sum += value;
+}
+
+void Histogram::reset()
+{
+    memset(m_buckets, 0, sizeof(m_buckets));
+    m_count = 0;
+    m_sum = 0;
+    m_min = 0;
+    m_max = 0;
+}
+
+long long Histogram::getPercentile(int percent) const
+{
+    if (m_count == 0)
+        return 0;
+
+    long long target = (m_count * percent + 99) / 100;
+    long long accumulated = 0;
+    for (int i = 0; i < BUCKET_COUNT; ++i) {
+        accumulated += m_buckets[i];
+        if (accumulated >= target)
+            return (m_bounds[i] < 0 || m_bounds[i] > m_max) ? m_max : m_bounds[i];
+    }
+    return m_max;
+}
+
+void Histogram::toJson(JValue& json) const
+{
+    JValue buckets = pbnjson::Array();
+    for (int i = 0; i < BUCKET_COUNT; ++i) {
+        buckets.append((int64_t)m_buckets[i]);
+    }
+
+    json.put("unit", toString(m_unit));
+    json.put("count", (int64_t)m_count);
+    json.put("sum", (int64_t)m_sum);
+    json.put("min", (int64_t)m_min);
+    json.put("max", (int64_t)m_max);
+    json.put("avg", (int64_t)(m_count > 0 ? m_sum / m_count : 0));
+    json.put("p50", (int64_t)getPercentile(50));
+    json.put("p90", (int64_t)getPercentile(90));
+    json.put("p99", (int64_t)getPercentile(99));
+    json.put("buckets", buckets);
+}
+
+void Histogram::fromJson(const JValue& json)
+{
+    reset();
+
+    JValue buckets;
+    if (!JValueUtil::getValue(json, "buckets", buckets) || !buckets.isArray() || buckets.arraySize() != BUCKET_COUNT)
+        return;
+
+    for (int i = 0; i < BUCKET_COUNT; ++i) {
+        m_buckets[i] = buckets[i].asNumber<int64_t>();
+    }
+    if (json.hasKey("count"))
+        m_count = json["count"].asNumber<int64_t>();
+    if (json.hasKey("sum"))
+        m_sum = json["sum"].asNumber<int64_t>();
+    if (json.hasKey("min"))
+        m_min = json["min"].asNumber<int64_t>();
+    if (json.hasKey("max"))
+        m_max = json["max"].asNumber<int64_t>();
+}
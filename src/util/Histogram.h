@@ -0,0 +1,70 @@
+// Copyright (c) 2020 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#ifndef UTIL_HISTOGRAM_H_
+#define UTIL_HISTOGRAM_H_
+
+#include <iostream>
+#include <pbnjson.hpp>
+
+using namespace std;
+using namespace pbnjson;
+
+enum class HistogramUnit : int8_t {
+    HistogramUnit_MS,       // 1-2-5 buckets from 1 ms
+    HistogramUnit_US,       // 1-2-5 buckets from 1 us
+    HistogramUnit_BYTES,    // Power of 2 buckets from 64 bytes
+};
+
+// Histogram keeps samples in fixed buckets of its unit. The unit is shown in toJson().
+// It doesn't allocate memory while recording.
+class Histogram {
+public:
+    static const int BUCKET_COUNT = 16;
+
+    Histogram(HistogramUnit unit = HistogramUnit::HistogramUnit_MS);
+    virtual ~Histogram();
+
+    void add(long long value);
+    void reset();
+
+    long long getCount() const
+    {
+        return m_count;
+    }
+
+    // Returns upper bound of the bucket which includes the percentile
+    long long getPercentile(int percent) const;
+
+    void toJson(JValue& json) const;
+    void fromJson(const JValue& json);
+
+private:
+    static const long long TIME_BOUNDS[BUCKET_COUNT];
+    static const long long SIZE_BOUNDS[BUCKET_COUNT];
+
+    HistogramUnit m_unit;
+    const long long* m_bounds;
+    long long m_buckets[BUCKET_COUNT];
+    long long m_count;
+    long long m_sum;
+    long long m_min;
+    long long m_max;
+
+};
+
+#endif /* UTIL_HISTOGRAM_H_ */
@@ -47,6 +47,28 @@ JSchema JValueUtil::getSchema(string name)
     return schema;
 }
 
+size_t JValueUtil::getMemoryUsage(const JValue& json)
+{
+    // Average size of jvalue node and hash entry of jobject
+    static const size_t NODE_SIZE = 48;
+    static const size_t ENTRY_SIZE = 16;
+
+    if (!json.isValid())
+        return 0;
+
+    size_t usage = NODE_SIZE;
+    if (json.isObject()) {
+        for (JValue::KeyValue item : json.children())
+            usage += ENTRY_SIZE + getMemoryUsage(item.first) + getMemoryUsage(item.second);
+    } else if (json.isArray()) {
+        for (int i = 0; i < json.arraySize(); ++i)
+            usage += sizeof(void*) + getMemoryUsage(json[i]);
+    } else if (json.isString()) {
+        usage += json.asString().length() + 1;
+    }
+    return usage;
+}
+
 bool JValueUtil::convertValue(const JValue& json, JValue& value)
 {
     value = json;
@@ -29,6 +29,9 @@ public:
     static void addUniqueItemToArray(JValue& arr, string& str);
     static JSchema getSchema(string name);
 
+    // Approximate heap bytes held by the DOM. pbnjson internals are not exposed, so nodes are counted
+    static size_t getMemoryUsage(const JValue& json);
+
     template <typename T>
     static bool getValue(const JValue& json, const string& key, T& value) {
         if (!json)
@@ -25,78 +25,74 @@ bool Logger::s_isVerbose = false;
 
 void Logger::logAPIRequest(const string& className, const string& functionName, Message& request, JValue& requestPayload)
 {
-    if (isVerbose()) {
-        if (request.getSenderServiceName())
-            getInstance().write(LogLevel_INFO, className, functionName, "APIRequest", format("API(%s) Sender(%s)", request.getKind(), request.getSenderServiceName()), requestPayload.stringify("    "));
-        else
-            getInstance().write(LogLevel_INFO, className, functionName, "APIRequest", format("API(%s) Sender(%s)", request.getKind(), request.getApplicationID()), requestPayload.stringify("    "));
-    } else {
-        if (request.getSenderServiceName())
-            getInstance().write(LogLevel_INFO, className, functionName, "APIRequest", format("API(%s) Sender(%s)", request.getKind(), request.getSenderServiceName()), EMPTY);
-        else
-            getInstance().write(LogLevel_INFO, className, functionName, "APIRequest", format("API(%s) Sender(%s)", request.getKind(), request.getApplicationID()), EMPTY);
-    }
+    if (!isEnabled(LogLevel_INFO))
+        return;
+    getInstance().logAPI(className, functionName, "APIRequest", request, requestPayload);
 }
 
 void Logger::logAPIResponse(const string& className, const string& functionName, Message& request, JValue& responsePayload)
 {
-    if (isVerbose()) {
-        if (request.getSenderServiceName())
-            getInstance().write(LogLevel_INFO, className, functionName, "APIResponse", format("API(%s) Sender(%s)", request.getKind(), request.getSenderServiceName()), responsePayload.stringify("    "));
-        else
-            getInstance().write(LogLevel_INFO, className, functionName, "APIResponse", format("API(%s) Sender(%s)", request.getKind(), request.getApplicationID()), responsePayload.stringify("    "));
-    } else {
-        if (request.getSenderServiceName())
-            getInstance().write(LogLevel_INFO, className, functionName, "APIResponse", format("API(%s) Sender(%s)", request.getKind(), request.getSenderServiceName()), EMPTY);
-        else
-            getInstance().write(LogLevel_INFO, className, functionName, "APIResponse", format("API(%s) Sender(%s)", request.getKind(), request.getApplicationID()), EMPTY);
-    }
+    if (!isEnabled(LogLevel_INFO))
+        return;
+    getInstance().logAPI(className, functionName, "APIResponse", request, responsePayload);
 }
 
 void Logger::logCallRequest(const string& className, const string& functionName, const string& method, JValue& requestPayload)
 {
+    if (!isEnabled(LogLevel_INFO))
+        return;
     if (isVerbose())
-        getInstance().write(LogLevel_INFO, className, functionName, "CallRequest", method.c_str(), requestPayload.stringify("    "));
+        getInstance().write(LogLevel_INFO, className, functionName, "CallRequest", method.c_str(), requestPayload.stringify());
     else
         getInstance().write(LogLevel_INFO, className, functionName, "CallRequest", method.c_str(), EMPTY);
 }
 
 void Logger::logCallResponse(const string& className, const string& functionName, Message& response, JValue& responsePayload)
 {
+    if (!isEnabled(LogLevel_INFO))
+        return;
     if (isVerbose())
-        getInstance().write(LogLevel_INFO, className, functionName, "CallResponse", response.getSenderServiceName(), responsePayload.stringify("    "));
+        getInstance().write(LogLevel_INFO, className, functionName, "CallResponse", response.getSenderServiceName(), responsePayload.stringify());
     else
         getInstance().write(LogLevel_INFO, className, functionName, "CallResponse", response.getSenderServiceName(), EMPTY);
 }
 
 void Logger::logSubscriptionRequest(const string& className, const string& functionName, const string& method, JValue& requestPayload)
 {
+    if (!isEnabled(LogLevel_INFO))
+        return;
     if (isVerbose())
-        getInstance().write(LogLevel_INFO, className, functionName, "SubscriptionRequest", method.c_str(), requestPayload.stringify("    "));
+        getInstance().write(LogLevel_INFO, className, functionName, "SubscriptionRequest", method.c_str(), requestPayload.stringify());
     else
         getInstance().write(LogLevel_INFO, className, functionName, "SubscriptionRequest", method.c_str(), EMPTY);
 }
 
 void Logger::logSubscriptionResponse(const string& className, const string& functionName, Message& response, JValue& subscriptionPayload)
 {
+    if (!isEnabled(LogLevel_INFO))
+        return;
     if (isVerbose())
-        getInstance().write(LogLevel_INFO, className, functionName, "SubscriptionResponse", response.getSenderServiceName(), subscriptionPayload.stringify("    "));
+        getInstance().write(LogLevel_INFO, className, functionName, "SubscriptionResponse", response.getSenderServiceName(), subscriptionPayload.stringify());
     else
         getInstance().write(LogLevel_INFO, className, functionName, "SubscriptionResponse", response.getSenderServiceName(), EMPTY);
 }
 
 void Logger::logSubscriptionPost(const string& className, const string& functionName, const LS::SubscriptionPoint& point, JValue& subscriptionPayload)
 {
+    if (!isEnabled(LogLevel_INFO))
+        return;
     if (isVerbose())
-        getInstance().write(LogLevel_INFO, className, functionName, "SubscriptionPost", Logger::format("Count=%d", point.getSubscribersCount()), subscriptionPayload.stringify("    "));
+        getInstance().write(LogLevel_INFO, className, functionName, "SubscriptionPost", Logger::format("Count=%d", point.getSubscribersCount()), subscriptionPayload.stringify());
     else
         getInstance().write(LogLevel_INFO, className, functionName, "SubscriptionPost", Logger::format("Count=%d", point.getSubscribersCount()), EMPTY);
 }
 
 void Logger::logSubscriptionPost(const string& className, const string& functionName, const string& key, JValue& subscriptionPayload)
 {
+    if (!isEnabled(LogLevel_INFO))
+        return;
     if (isVerbose())
-        getInstance().write(LogLevel_INFO, className, functionName, "SubscriptionPost", key, subscriptionPayload.stringify("    "));
+        getInstance().write(LogLevel_INFO, className, functionName, "SubscriptionPost", key, subscriptionPayload.stringify());
     else
         getInstance().write(LogLevel_INFO, className, functionName, "SubscriptionPost", key, EMPTY);
 }
@@ -164,19 +160,56 @@ const string& Logger::toString(const enum LogLevel& level)
     return DEBUG;
 }
 
+gpointer Logger::onWriterThread(gpointer data)
+{
+    getInstance().run();
+    return nullptr;
+}
+
 Logger::Logger()
     : m_level(LogLevel_DEBUG),
-      m_type(LogType_CONSOLE)
+      m_type(LogType_CONSOLE),
+      m_thread(nullptr),
+      m_isStopping(false),
+      m_ring(RING_SIZE),
+      m_head(0),
+      m_count(0),
+      m_maxCount(0),
+      m_writtenCount(0)
 {
     setbuf(stdout, NULL);
     char* LOG_VERBOSE = getenv("LOG_VERBOSE");
     if (LOG_VERBOSE != nullptr) {
         s_isVerbose = true;
     }
+    char* LOG_LEVEL = getenv("LOG_LEVEL");
+    if (LOG_LEVEL != nullptr) {
+        if (strcmp(LOG_LEVEL, "info") == 0)
+            m_level = LogLevel_INFO;
+        else if (strcmp(LOG_LEVEL, "warning") == 0)
+            m_level = LogLevel_WARNING;
+        else if (strcmp(LOG_LEVEL, "error") == 0)
+            m_level = LogLevel_ERROR;
+    }
+
+    for (int i = 0; i <= LogLevel_ERROR; ++i)
+        m_droppedCount[i] = 0;
+    Overhead* overheads[] = { &m_overhead, &m_apiOverhead };
+    for (int i = 0; i < 2; ++i) {
+        overheads[i]->count = 0;
+        overheads[i]->sampled = 0;
+        overheads[i]->total = 0;
+        overheads[i]->max = 0;
+    }
+    g_mutex_init(&m_mutex);
+    g_cond_init(&m_cond);
 }
 
 Logger::~Logger()
 {
+    stopAsync();
+    g_cond_clear(&m_cond);
+    g_mutex_clear(&m_mutex);
 }
 
 void Logger::setLevel(enum LogLevel level)
@@ -189,11 +222,176 @@ void Logger::setType(enum LogType type)
     m_type = type;
 }
 
+void Logger::startAsync()
+{
+    if (m_thread != nullptr || getenv("LOG_SYNC") != nullptr)
+        return;
+
+    // Only the logger thread writes to stdout. It flushes after each batch.
+    setvbuf(stdout, NULL, _IOFBF, BUFSIZ);
+    m_isStopping = false;
+    m_thread = g_thread_new("logger", onWriterThread, nullptr);
+}
+
+void Logger::stopAsync()
+{
+    if (m_thread == nullptr)
+        return;
+
+    g_mutex_lock(&m_mutex);
+    m_isStopping = true;
+    g_cond_signal(&m_cond);
+    g_mutex_unlock(&m_mutex);
+
+    // Remaining logs are written before join
+    g_thread_join(m_thread);
+    m_thread = nullptr;
+    setbuf(stdout, NULL);
+}
+
+size_t Logger::getMemoryUsage()
+{
+    // Strings of written entries keep their capacity until they are reused
+    g_mutex_lock(&m_mutex);
+    size_t usage = m_ring.capacity() * sizeof(Entry);
+    for (auto it = m_ring.begin(); it != m_ring.end(); ++it) {
+        usage += it->className.capacity() + it->functionName.capacity() + it->who.capacity() +
+                 it->what.capacity() + it->detail.capacity();
+    }
+    g_mutex_unlock(&m_mutex);
+    return usage;
+}
+
+void Logger::toJson(JValue& json)
+{
+    json.put("level", toString(m_level));
+    json.put("async", m_thread != nullptr);
+    json.put("ringSize", RING_SIZE);
+
+    g_mutex_lock(&m_mutex);
+    json.put("queued", m_count);
+    json.put("maxQueued", m_maxCount);
+    json.put("writtenCount", (int64_t)m_writtenCount);
+
+    JValue dropped = pbnjson::Object();
+    for (int i = 0; i <= LogLevel_ERROR; ++i)
+        dropped.put(toString((enum LogLevel)i), (int64_t)m_droppedCount[i]);
+    json.put("droppedCount", dropped);
+    g_mutex_unlock(&m_mutex);
+
+    // Benchmark of the cost paid by callers in the main loop
+    const Overhead* overheads[] = { &m_overhead, &m_apiOverhead };
+    const char* names[] = { "overhead", "apiOverhead" };
+    for (int i = 0; i < 2; ++i) {
+        long long sampled = overheads[i]->sampled;
+        long long total = overheads[i]->total;
+        JValue overhead = pbnjson::Object();
+        overhead.put("count", (int64_t)overheads[i]->count);
+        overhead.put("sampledCount", (int64_t)sampled);
+        overhead.put("sampledTotalUs", (int64_t)total);
+        overhead.put("avgUs", (int64_t)(sampled > 0 ? total / sampled : 0));
+        overhead.put("maxUs", (int64_t)overheads[i]->max);
+        json.put(names[i], overhead);
+    }
+}
+
+void Logger::logAPI(const string& className, const string& functionName, const string& who, Message& request, JValue& payload)
+{
+    long long startTime = startMeasure(m_apiOverhead);
+    const char* sender = request.getSenderServiceName() ? request.getSenderServiceName() : request.getApplicationID();
+    write(LogLevel_INFO, className, functionName, who, format("API(%s) Sender(%s)", request.getKind(), sender),
+          isVerbose() ? payload.stringify() : EMPTY);
+    endMeasure(m_apiOverhead, startTime);
+}
+
 void Logger::write(const enum LogLevel& level, const string& className, const string& functionName, const string& who, const string& what, const string& detail)
 {
     if (level < m_level)
         return;
 
+    long long startTime = startMeasure(m_overhead);
+    if (m_thread != nullptr)
+        enqueue(level, className, functionName, who, what, detail);
+    else
+        dispatch(level, className, functionName, who, what, detail);
+    endMeasure(m_overhead, startTime);
+}
+
+void Logger::enqueue(const enum LogLevel& level, const string& className, const string& functionName, const string& who, const string& what, const string& detail)
+{
+    g_mutex_lock(&m_mutex);
+    if (m_count == RING_SIZE) {
+        m_droppedCount[level]++;
+        g_mutex_unlock(&m_mutex);
+        return;
+    }
+
+    // Strings in the ring keep their capacity. Most logs don't allocate memory here.
+    Entry& entry = m_ring[(m_head + m_count) % RING_SIZE];
+    entry.level = level;
+    entry.className.assign(className);
+    entry.functionName.assign(functionName);
+    entry.who.assign(who);
+    entry.what.assign(what);
+    entry.detail.assign(detail);
+    m_count++;
+    if (m_count > m_maxCount)
+        m_maxCount = m_count;
+    if (m_count == 1)
+        g_cond_signal(&m_cond);
+    g_mutex_unlock(&m_mutex);
+}
+
+void Logger::run()
+{
+    vector<Entry> batch(RING_SIZE);
+
+    g_mutex_lock(&m_mutex);
+    while (true) {
+        while (m_count == 0 && !m_isStopping)
+            g_cond_wait(&m_cond, &m_mutex);
+        if (m_count == 0)
+            break;
+
+        int count = m_count;
+        for (int i = 0; i < count; ++i)
+            swap(batch[i], m_ring[(m_head + i) % RING_SIZE]);
+        m_head = (m_head + count) % RING_SIZE;
+        m_count = 0;
+        g_mutex_unlock(&m_mutex);
+
+        for (int i = 0; i < count; ++i)
+            dispatch(batch[i].level, batch[i].className, batch[i].functionName, batch[i].who, batch[i].what, batch[i].detail);
+        if (m_type == LogType_CONSOLE)
+            fflush(stdout);
+
+        g_mutex_lock(&m_mutex);
+        m_writtenCount += count;
+    }
+    g_mutex_unlock(&m_mutex);
+}
+
+long long Logger::startMeasure(Overhead& overhead)
+{
+    if (overhead.count.fetch_add(1, memory_order_relaxed) % OVERHEAD_SAMPLING != 0)
+        return -1;
+    return g_get_monotonic_time();
+}
+
+void Logger::endMeasure(Overhead& overhead, long long startTime)
+{
+    if (startTime < 0)
+        return;
+
+    long long elapsed = g_get_monotonic_time() - startTime;
+    overhead.sampled.fetch_add(1, memory_order_relaxed);
+    overhead.total.fetch_add(elapsed, memory_order_relaxed);
+    long long max = overhead.max.load(memory_order_relaxed);
+    while (elapsed > max && !overhead.max.compare_exchange_weak(max, elapsed, memory_order_relaxed));
+}
+
+void Logger::dispatch(const enum LogLevel& level, const string& className, const string& functionName, const string& who, const string& what, const string& detail)
+{
     switch (m_type) {
     case LogType_CONSOLE:
         writeConsole(level, className, functionName, who, what, detail);
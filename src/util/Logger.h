@@ -17,9 +17,12 @@
 #ifndef UTIL_LOGGER_H_
 #define UTIL_LOGGER_H_
 
+#include <atomic>
 #include <iostream>
 #include <map>
+#include <vector>
 
+#include <glib.h>
 #include <luna-service2/lunaservice.hpp>
 #include <pbnjson.hpp>
 
@@ -52,12 +55,24 @@ enum LogType {
     LogType_PMLOG
 };
 
+// Arguments are evaluated only if the level is enabled.
+// Use these instead of Logger::debug/info when the message is formatted or concatenated.
+#define LOG_DEBUG(...) \
+    do { if (Logger::isEnabled(LogLevel_DEBUG)) Logger::debug(__VA_ARGS__); } while (0)
+#define LOG_INFO(...) \
+    do { if (Logger::isEnabled(LogLevel_INFO)) Logger::info(__VA_ARGS__); } while (0)
+#define LOG_WARNING(...) \
+    do { if (Logger::isEnabled(LogLevel_WARNING)) Logger::warning(__VA_ARGS__); } while (0)
+#define LOG_ERROR(...) \
+    do { if (Logger::isEnabled(LogLevel_ERROR)) Logger::error(__VA_ARGS__); } while (0)
+
 class Logger {
 public:
     template<typename ... Args>
     static const string format(const string& format, Args ... args)
     {
-        static char buffer[1024];
+        // Logs are written by other threads as well
+        char buffer[1024];
         snprintf(buffer, 1024, format.c_str(), args ... );
         return string(buffer);
     }
@@ -78,6 +93,11 @@ public:
         return s_isVerbose;
     }
 
+    static bool isEnabled(enum LogLevel level)
+    {
+        return level >= getInstance().m_level;
+    }
+
     static void logAPIRequest(const string& className, const string& functionName, Message& request, JValue& requestPayload);
     static void logAPIResponse(const string& className, const string& functionName, Message& request, JValue& responsePayload);
 
@@ -110,20 +130,73 @@ public:
     void setLevel(enum LogLevel level);
     void setType(enum LogType type);
 
+    // Logs are queued in a ring buffer and written by a logger thread.
+    // If the ring is full, new logs are dropped and counted.
+    void startAsync();
+    void stopAsync();
+
+    void toJson(JValue& json);
+
+    // Approximate heap bytes of the ring
+    size_t getMemoryUsage();
+
 private:
     static const string EMPTY;
+    static const int RING_SIZE = 1024;
     static bool s_isVerbose;
 
+    struct Entry {
+        enum LogLevel level;
+        string className;
+        string functionName;
+        string who;
+        string what;
+        string detail;
+    };
+
+    // Time spent by callers (us). Only one of OVERHEAD_SAMPLING calls is timed.
+    // Counters are atomic. Measuring doesn't take the ring lock.
+    static const int OVERHEAD_SAMPLING = 64;
+    struct Overhead {
+        atomic<long long> count;
+        atomic<long long> sampled;
+        atomic<long long> total;
+        atomic<long long> max;
+    };
+
     static const string& toString(const enum LogLevel& level);
+    static gpointer onWriterThread(gpointer data);
 
     Logger();
 
+    void logAPI(const string& className, const string& functionName, const string& who, Message& request, JValue& payload);
     void write(const enum LogLevel& level, const string& className, const string& functionName, const string& who, const string& what, const string& detail);
+    void dispatch(const enum LogLevel& level, const string& className, const string& functionName, const string& who, const string& what, const string& detail);
+    void enqueue(const enum LogLevel& level, const string& className, const string& functionName, const string& who, const string& what, const string& detail);
+    void run();
+    // Returns the start time if this call is sampled. Otherwise, -1
+    long long startMeasure(Overhead& overhead);
+    void endMeasure(Overhead& overhead, long long startTime);
     void writeConsole(const enum LogLevel& level, const string& className, const string& functionName, const string& who, const string& what, const string& detail);
     void writePmlog(const enum LogLevel& level, const string& className, const string& functionName, const string& who, const string& what, const string& detail);
 
     enum LogLevel m_level;
     enum LogType m_type;
+
+    GThread* m_thread;
+    GMutex m_mutex;
+    GCond m_cond;
+    bool m_isStopping;
+    vector<Entry> m_ring;
+    int m_head;
+    int m_count;
+
+    // m_mutex
+    int m_maxCount;
+    long long m_writtenCount;
+    long long m_droppedCount[LogLevel_ERROR + 1];
+    Overhead m_overhead;
+    Overhead m_apiOverhead;
 };
 
 #endif /* UTIL_LOGGER_H_ */
@@ -13,28 +13,60 @@
 
 #include <fcntl.h>
 #include <errno.h>
+#include <signal.h>
+#include <spawn.h>
 #include <string.h>
 #include <unistd.h>
 
+#include "util/Cgroup.h"
 #include "util/NativeProcess.h"
 #include "util/Logger.h"
+#include "util/Time.h"
+#include "util/Tracer.h"
+
+// posix_spawn is used only if inherited descriptors can be closed and working directory can be changed
+// without running any code in the child. Both are available since glibc 2.34.
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 34))
+#define HAS_LIGHTWEIGHT_SPAWN
+#endif
+// glibc 2.39 can spawn the child directly in a cgroup (clone3 with CLONE_INTO_CGROUP)
+#if defined(HAS_LIGHTWEIGHT_SPAWN) && defined(POSIX_SPAWN_SETCGROUP)
+#define HAS_SPAWN_CGROUP
+#endif
 
 const string NativeProcess::CLASS_NAME = "NativeProcess";
+bool NativeProcess::s_useLightweightSpawn = true;
 
-void NativeProcess::convertEnvToStr(map<string, string>& src, vector<string>& dest)
+NativeProcess::EnvironmentBlock NativeProcess::makeEnvironmentBlock(const map<string, string>& environments)
 {
-    for (auto it = src.begin(); it != src.end(); ++it) {
-        dest.push_back(it->first + "=" + it->second);
+    shared_ptr<vector<string>> block = make_shared<vector<string>>();
+    block->reserve(environments.size());
+    for (auto it = environments.begin(); it != environments.end(); ++it) {
+        block->push_back(it->first + "=" + it->second);
     }
+    return block;
+}
+
+bool NativeProcess::isLightweightSpawn()
+{
+#ifdef HAS_LIGHTWEIGHT_SPAWN
+    return s_useLightweightSpawn;
+#else
+    return false;
+#endif
 }
 
 void NativeProcess::prepareSpawn(gpointer user_data)
 {
-    // This function is called in child context.
+    // This function is called in child context. Only async-signal-safe calls are allowed.
+    // Logger can't be used. Its lock could be held by another thread when SAM forked.
     // setpgid is needed to kill all processes which are created by application at once
-    int result = setpgid(getpid(), 0);
-    if (result == -1) {
-        Logger::error(CLASS_NAME, __FUNCTION__, strerror(errno));
+    setpgid(getpid(), 0);
+
+    // Writing "0" to 'cgroup.procs' moves the calling process before exec
+    NativeProcess* process = static_cast<NativeProcess*>(user_data);
+    if (process->m_cgroupFd >= 0 && write(process->m_cgroupFd, "0", 1) == -1) {
+        // The app runs outside of the cgroup. It is still killed with the process group.
     }
 }
 
@@ -43,11 +75,14 @@ NativeProcess::NativeProcess()
       m_command(""),
       m_pid(-1),
       m_stdFd(-1),
-      m_isTracked(false)
+      m_controlReadFd(-1),
+      m_controlWriteFd(-1),
+      m_cgroupFd(-1),
+      m_isTracked(false),
+      m_spawnTime(0)
 {
 
 }
-
 NativeProcess::~NativeProcess()
 {
 
@@ -76,6 +111,20 @@ void NativeProcess::addEnv(const string& variable, const string& value)
     m_environments[variable] = value;
 }
 
+void NativeProcess::getEnvironments(map<string, string>& environments) const
+{
+    if (m_environmentBlock) {
+        for (auto it = m_environmentBlock->begin(); it != m_environmentBlock->end(); ++it) {
+            size_t pos = it->find('=');
+            if (pos != string::npos)
+                environments[it->substr(0, pos)] = it->substr(pos + 1);
+        }
+    }
+    for (auto it = m_environments.begin(); it != m_environments.end(); ++it) {
+        environments[it->first] = it->second;
+    }
+}
+
 void NativeProcess::openStdFile(const string& stdFile)
 {
     closeStdFd();
@@ -87,40 +136,209 @@ void NativeProcess::closeStdFd()
 {
     if (m_stdFd >= 0)
         close(m_stdFd);
+    m_stdFd = -1;
+}
+
+int NativeProcess::openStdPipe()
+{
+    int fds[2];
+
+    closeStdFd();
+    m_stdFile = "";
+    if (pipe2(fds, O_CLOEXEC) == -1) {
+        Logger::error(CLASS_NAME, __FUNCTION__, strerror(errno));
+        return -1;
+    }
+    m_stdFd = fds[1];
+    return fds[0];
+}
+
+bool NativeProcess::openControlChannel()
+{
+    int fds[2];
+
+    closeControlChannel();
+    if (pipe2(fds, O_CLOEXEC) == -1) {
+        Logger::error(CLASS_NAME, __FUNCTION__, strerror(errno));
+        return false;
+    }
+    m_controlReadFd = fds[0];
+    m_controlWriteFd = fds[1];
+    return true;
+}
+
+bool NativeProcess::writeControl(const string& message)
+{
+    if (m_controlWriteFd < 0) {
+        Logger::error(CLASS_NAME, __FUNCTION__, "Control channel is not opened");
+        return false;
+    }
+
+    const char* buffer = message.c_str();
+    size_t remain = message.size();
+    while (remain > 0) {
+        ssize_t written = write(m_controlWriteFd, buffer, remain);
+        if (written == -1) {
+            if (errno == EINTR)
+                continue;
+            Logger::error(CLASS_NAME, __FUNCTION__, strerror(errno));
+            return false;
+        }
+        buffer += written;
+        remain -= written;
+    }
+    return true;
+}
+
+void NativeProcess::closeControlChannel()
+{
+    if (m_controlReadFd >= 0)
+        close(m_controlReadFd);
+    if (m_controlWriteFd >= 0)
+        close(m_controlWriteFd);
+    m_controlReadFd = -1;
+    m_controlWriteFd = -1;
 }
 
 bool NativeProcess::run()
 {
-    const char* argv[MAX_ARGS] = { 0, };
-    const char* envp[MAX_ENVP] = { 0, };
+    TRACE_SCOPE("process", __FUNCTION__, m_command.c_str(), 0);
+    vector<char*> argv;
+    vector<string> overrides;
+    vector<char*> envp;
     string params = "";
-    int index = 0;
 
-    GError* gerr = NULL;
-    argv[0] = m_command.c_str();
-    index = 1;
+    argv.reserve(m_arguments.size() + 2);
+    argv.push_back(const_cast<char*>(m_command.c_str()));
     for (auto it = m_arguments.begin(); it != m_arguments.end(); ++it) {
         params += *it + " ";
-        argv[index++] = it->c_str();
+        argv.push_back(const_cast<char*>(it->c_str()));
+    }
+    argv.push_back(nullptr);
+    makeEnvp(overrides, envp);
+
+    LOG_INFO(CLASS_NAME, __FUNCTION__, m_command, params);
+    long long startTime = Time::getCurrentTimeUs();
+    bool result = isLightweightSpawn() ? spawn(argv.data(), envp.data()) : spawnWithGlib(argv.data(), envp.data());
+    m_spawnTime = Time::getCurrentTimeUs() - startTime;
+
+    if (m_cgroupFd >= 0) {
+        close(m_cgroupFd);
+        m_cgroupFd = -1;
+    }
+
+    // Read end of control channel is owned by the child process now
+    if (m_controlReadFd >= 0) {
+        close(m_controlReadFd);
+        m_controlReadFd = -1;
+    }
+    return result;
+}
+
+void NativeProcess::makeEnvp(vector<string>& overrides, vector<char*>& envp)
+{
+    overrides.reserve(m_environments.size());
+    for (auto it = m_environments.begin(); it != m_environments.end(); ++it) {
+        overrides.push_back(it->first + "=" + it->second);
+    }
+
+    if (m_environmentBlock) {
+        envp.reserve(m_environmentBlock->size() + overrides.size() + 1);
+        for (auto it = m_environmentBlock->begin(); it != m_environmentBlock->end(); ++it) {
+            bool isOverridden = false;
+            for (auto env = m_environments.begin(); env != m_environments.end(); ++env) {
+                if (it->size() > env->first.size() && (*it)[env->first.size()] == '=' &&
+                    it->compare(0, env->first.size(), env->first) == 0) {
+                    isOverridden = true;
+                    break;
+                }
+            }
+            if (!isOverridden)
+                envp.push_back(const_cast<char*>(it->c_str()));
+        }
+    }
+    for (auto it = overrides.begin(); it != overrides.end(); ++it) {
+        envp.push_back(const_cast<char*>(it->c_str()));
+    }
+    envp.push_back(nullptr);
+}
+
+bool NativeProcess::spawn(char** argv, char** envp)
+{
+#ifdef HAS_LIGHTWEIGHT_SPAWN
+    posix_spawnattr_t attr;
+    posix_spawn_file_actions_t actions;
+    sigset_t mask;
+
+    // setpgid is needed to kill all processes which are created by application at once.
+    // posix_spawn does it without callback in the child context
+    sigemptyset(&mask);
+    posix_spawnattr_init(&attr);
+    posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETPGROUP | POSIX_SPAWN_SETSIGMASK);
+    posix_spawnattr_setpgroup(&attr, 0);
+    posix_spawnattr_setsigmask(&attr, &mask);
+
+#ifdef HAS_SPAWN_CGROUP
+    if (!m_cgroup.empty()) {
+        m_cgroupFd = open(m_cgroup.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (m_cgroupFd >= 0) {
+            posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETPGROUP | POSIX_SPAWN_SETSIGMASK | POSIX_SPAWN_SETCGROUP);
+            posix_spawnattr_setcgroup_np(&attr, m_cgroupFd);
+        }
+    }
+#endif
+
+    posix_spawn_file_actions_init(&actions);
+    if (m_controlReadFd >= 0)
+        posix_spawn_file_actions_adddup2(&actions, m_controlReadFd, STDIN_FILENO);
+    if (m_stdFd >= 0) {
+        posix_spawn_file_actions_adddup2(&actions, m_stdFd, STDOUT_FILENO);
+        posix_spawn_file_actions_adddup2(&actions, m_stdFd, STDERR_FILENO);
+    }
+    // g_spawn closes all other descriptors as well
+    posix_spawn_file_actions_addclosefrom_np(&actions, STDERR_FILENO + 1);
+    posix_spawn_file_actions_addchdir_np(&actions, m_workingDirectory.c_str());
+
+    int result = posix_spawn(&m_pid, argv[0], &actions, &attr, argv, envp);
+    posix_spawn_file_actions_destroy(&actions);
+    posix_spawnattr_destroy(&attr);
+
+    if (result != 0) {
+        Logger::error(CLASS_NAME, __FUNCTION__, strerror(result));
+        m_pid = -1;
+        return false;
     }
 
-    vector<string> finalEnvironments;
-    convertEnvToStr(m_environments, finalEnvironments);
-    index = 0;
-    for (auto it = finalEnvironments.begin(); it != finalEnvironments.end(); ++it) {
-        envp[index++] = (const char*)it->c_str();
+    // Without CLONE_INTO_CGROUP, the child is moved after posix_spawn returns.
+    // Children created before that stay outside the cgroup. They are still killed with the process group.
+    if (!m_cgroup.empty() && m_cgroupFd < 0) {
+        Cgroup::attach(m_cgroup, m_pid);
+    }
+    return true;
+#else
+    return spawnWithGlib(argv, envp);
+#endif
+}
+
+bool NativeProcess::spawnWithGlib(char** argv, char** envp)
+{
+    GError* gerr = NULL;
+    if (!m_cgroup.empty()) {
+        m_cgroupFd = open((m_cgroup + "/cgroup.procs").c_str(), O_WRONLY | O_CLOEXEC);
+        if (m_cgroupFd < 0) {
+            Logger::warning(CLASS_NAME, __FUNCTION__, m_cgroup, strerror(errno));
+        }
     }
 
-    Logger::info(CLASS_NAME, __FUNCTION__, m_command, params);
     gboolean result = g_spawn_async_with_fds(
         m_workingDirectory.c_str(),
-        const_cast<char**>(argv),
-        const_cast<char**>(envp),
+        argv,
+        envp,
         G_SPAWN_DO_NOT_REAP_CHILD,
         prepareSpawn,
         this,
         &m_pid,
-        -1,
+        m_controlReadFd,
         m_stdFd,
         m_stdFd,
         &gerr
@@ -144,6 +362,10 @@ bool NativeProcess::term()
         Logger::error(CLASS_NAME, __FUNCTION__, "Process is not running");
         return false;
     }
+    // Descendants which called setsid() are not in the process group
+    if (!m_cgroup.empty() && Cgroup::signal(m_cgroup, SIGTERM) > 0)
+        return true;
+
     int result = killpg(m_pid, SIGTERM);
     if (result == -1) {
         Logger::error(CLASS_NAME, __FUNCTION__, strerror(errno));
@@ -158,6 +380,9 @@ bool NativeProcess::kill()
         Logger::error(CLASS_NAME, __FUNCTION__, "Process is not running");
         return false;
     }
+    if (!m_cgroup.empty() && Cgroup::kill(m_cgroup))
+        return true;
+
     int result = killpg(m_pid, SIGKILL);
     if (result == -1) {
         Logger::error(CLASS_NAME, __FUNCTION__, strerror(errno));
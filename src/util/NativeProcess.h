@@ -15,6 +15,7 @@
 #define UTIL_NATIVEPROCESS_H_
 
 #include <iostream>
+#include <memory>
 #include <vector>
 #include <map>
 #include <glib.h>
@@ -25,6 +26,20 @@ using namespace std;
 
 class NativeProcess {
 public:
+    // Prebuilt "NAME=VALUE" strings. The block is immutable once it is built,
+    // so it can be shared by all processes which are launched with the same plan.
+    typedef shared_ptr<const vector<string>> EnvironmentBlock;
+
+    static EnvironmentBlock makeEnvironmentBlock(const map<string, string>& environments);
+
+    // If enabled, posix_spawn (vfork based) is used instead of g_spawn (fork based).
+    // It is ignored if libc doesn't support required file actions.
+    static void setLightweightSpawn(bool enable)
+    {
+        s_useLightweightSpawn = enable;
+    }
+    static bool isLightweightSpawn();
+
     NativeProcess();
     virtual ~NativeProcess();
 
@@ -47,6 +62,24 @@ public:
     void addEnv(map<string, string>& environments);
     void addEnv(const string& variable, const string& value);
 
+    // Variables which are added by 'addEnv' override the block
+    void setEnvironmentBlock(EnvironmentBlock environmentBlock)
+    {
+        m_environmentBlock = environmentBlock;
+    }
+
+    const vector<string>& getArguments() const
+    {
+        return m_arguments;
+    }
+    void getEnvironments(map<string, string>& environments) const;
+
+    // Time (us) which is spent in spawning the child process
+    long long getSpawnTime() const
+    {
+        return m_spawnTime;
+    }
+
     pid_t getPid() const
     {
         return m_pid;
@@ -64,6 +97,27 @@ public:
 
     void closeStdFd();
 
+    // If it is set, the child process is spawned in the cgroup and
+    // term/kill are applied to all processes in the cgroup
+    void setCgroup(const string& cgroup)
+    {
+        m_cgroup = cgroup;
+    }
+    const string& getCgroup() const
+    {
+        return m_cgroup;
+    }
+
+    // Returns read end of a pipe which is connected to stdout/stderr of the child process.
+    // The caller owns it. It should be opened before 'run()'
+    int openStdPipe();
+
+    // Control channel is a pipe connected to stdin of the child process.
+    // It should be opened before 'run()'
+    bool openControlChannel();
+    bool writeControl(const string& message);
+    void closeControlChannel();
+
     bool run();
     bool term();
     bool kill();
@@ -85,23 +139,32 @@ public:
 
 private:
     static const string CLASS_NAME;
-    static const int MAX_ARGS = 16;
-    static const int MAX_ENVP = 128;
+    static bool s_useLightweightSpawn;
 
-    static void convertEnvToStr(map<string, string>& src, vector<string>& dest);
     static void prepareSpawn(gpointer user_data);
 
+    void makeEnvp(vector<string>& overrides, vector<char*>& envp);
+    bool spawn(char** argv, char** envp);
+    bool spawnWithGlib(char** argv, char** envp);
+
     string m_workingDirectory;
     string m_command;
 
     vector<string> m_arguments;
     map<string, string> m_environments;
+    EnvironmentBlock m_environmentBlock;
 
     pid_t m_pid;
     string m_stdFile;
     gint m_stdFd;
+    gint m_controlReadFd;
+    gint m_controlWriteFd;
+    string m_cgroup;
+    // Valid only while spawning
+    gint m_cgroupFd;
 
     bool m_isTracked;
+    long long m_spawnTime;
 
 };
 
@@ -0,0 +1,162 @@
+// Copyright (c) 2020 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#include "ProcFs.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+ProcFs::ProcFs()
+{
+}
+
+ProcFs::~ProcFs()
+{
+}
+
+long ProcFs::getAvailableMemory()
+{
+    FILE* fp = fopen("/proc/meminfo", "r");
+    if (fp == NULL)
+        return -1;
+
+    char line[128];
+    long available = -1;
+    while (fgets(line, sizeof(line), fp) != NULL) {
+        if (sscanf(line, "MemAvailable: %ld kB", &available) == 1)
+            break;
+    }
+    fclose(fp);
+    return available;
+}
+
+long ProcFs::getProcessRss(pid_t pid)
+{
+    char path[64];
+    snprintf(path, sizeof(path), "/proc/%d/statm", pid);
+
+    FILE* fp = fopen(path, "r");
+    if (fp == NULL)
+        return -1;
+
+    long size = 0;
+    long resident = -1;
+    if (fscanf(fp, "%ld %ld", &size, &resident) != 2)
+        resident = -1;
+    fclose(fp);
+
+    if (resident < 0)
+        return -1;
+    return resident * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+long ProcFs::getProcessPss(pid_t pid)
+{
+    char path[64];
+    snprintf(path, sizeof(path), "/proc/%d/smaps_rollup", pid);
+
+    FILE* fp = fopen(path, "r");
+    if (fp == NULL)
+        return -1;
+
+    char line[128];
+    long pss = -1;
+    while (fgets(line, sizeof(line), fp) != NULL) {
+        if (sscanf(line, "Pss: %ld kB", &pss) == 1)
+            break;
+    }
+    fclose(fp);
+    return pss;
+}
+
+void ProcFs::getProcessTree(pid_t pid, vector<pid_t>& pids)
+{
+    pids.push_back(pid);
+    for (size_t i = 0; i < pids.size(); ++i) {
+        char path[64];
+        snprintf(path, sizeof(path), "/proc/%d/task/%d/children", pids[i], pids[i]);
+
+        FILE* fp = fopen(path, "r");
+        if (fp == NULL)
+            continue;
+        pid_t child = 0;
+        while (fscanf(fp, "%d", &child) == 1)
+            pids.push_back(child);
+        fclose(fp);
+    }
+}
+
+bool ProcFs::getProcessStat(pid_t pid, unsigned long long& cpuTime, long& rss)
+{
+    static const long TICKS_PER_SECOND = sysconf(_SC_CLK_TCK);
+    static const long PAGE_KB = sysconf(_SC_PAGESIZE) / 1024;
+
+    char path[64];
+    snprintf(path, sizeof(path), "/proc/%d/stat", pid);
+
+    // Sampled periodically for all apps. stdio costs more syscalls and an allocation
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+        return false;
+
+    char line[1024];
+    ssize_t length = read(fd, line, sizeof(line) - 1);
+    close(fd);
+    if (length <= 0)
+        return false;
+    line[length] = '\0';
+
+    // 'comm' can have spaces and parentheses. Fields are counted after the last ')'
+    char* fields = strrchr(line, ')');
+    if (fields == NULL)
+        return false;
+
+    unsigned long long utime = 0;
+    unsigned long long stime = 0;
+    long pages = 0;
+    if (sscanf(fields + 2, "%*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %llu %llu %*d %*d %*d %*d %*d %*d %*u %*u %ld",
+               &utime, &stime, &pages) != 3)
+        return false;
+
+    cpuTime = (utime + stime) * 1000000ULL / TICKS_PER_SECOND;
+    rss = pages * PAGE_KB;
+    return true;
+}
+
+unsigned long long ProcFs::getProcessStartTime(pid_t pid)
+{
+    char path[64];
+    snprintf(path, sizeof(path), "/proc/%d/stat", pid);
+
+    FILE* fp = fopen(path, "r");
+    if (fp == NULL)
+        return 0;
+
+    char line[1024];
+    unsigned long long startTime = 0;
+    if (fgets(line, sizeof(line), fp) != NULL) {
+        // 'comm' can have spaces and parentheses. Fields are counted after the last ')'
+        char* fields = strrchr(line, ')');
+        if (fields != NULL) {
+            sscanf(fields + 2, "%*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %*u %*u %*d %*d %*d %*d %*d %*d %llu", &startTime);
+        }
+    }
+    fclose(fp);
+    return startTime;
+}
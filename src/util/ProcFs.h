@@ -0,0 +1,55 @@
+// Copyright (c) 2020 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#ifndef UTIL_PROCFS_H_
+#define UTIL_PROCFS_H_
+
+#include <iostream>
+#include <map>
+#include <vector>
+#include <sys/types.h>
+
+using namespace std;
+
+class ProcFs {
+public:
+    // 'pids' includes 'pid' itself and all descendants.
+    // Children are read from /proc/<pid>/task/<pid>/children. Without it, only 'pid' is included.
+    static void getProcessTree(pid_t pid, vector<pid_t>& pids);
+
+    // Returns 'MemAvailable' in /proc/meminfo (KB). -1 means unknown
+    static long getAvailableMemory();
+
+    // Returns resident set size of the process (KB). -1 means unknown
+    static long getProcessRss(pid_t pid);
+
+    // Returns proportional set size of the process (KB). -1 means unknown
+    static long getProcessPss(pid_t pid);
+
+    // Reads CPU time (utime + stime, us) and resident set size (KB) with a single read of /proc/<pid>/stat
+    static bool getProcessStat(pid_t pid, unsigned long long& cpuTime, long& rss);
+
+    // Returns start time of the process in clock ticks after boot. 0 means unknown.
+    // (pid, start time) identifies a process even if the pid is reused.
+    static unsigned long long getProcessStartTime(pid_t pid);
+
+    ProcFs();
+    virtual ~ProcFs();
+
+};
+
+#endif /* UTIL_PROCFS_H_ */
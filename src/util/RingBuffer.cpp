@@ -0,0 +1,96 @@
+// Copyright (c) 2020 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#include "RingBuffer.h"
+
+#include <string.h>
+
+RingBuffer::RingBuffer(size_t capacity)
+    : m_head(0),
+      m_size(0),
+      m_dropped(0)
+{
+    m_buffer.resize(capacity);
+}
+
+RingBuffer::~RingBuffer()
+{
+}
+
+void RingBuffer::setCapacity(size_t capacity)
+{
+    if (capacity == m_buffer.size())
+        return;
+
+    string data = toString();
+    m_buffer.assign(capacity, 0);
+    m_head = 0;
+    m_size = 0;
+    append(data.c_str(), data.size());
+}
+
+void RingBuffer::append(const char* data, size_t length)
+{
+    size_t capacity = m_buffer.size();
+    if (capacity == 0 || length == 0) {
+        m_dropped += length;
+        return;
+    }
+
+    // Only the tail of large data can be kept
+    if (length > capacity) {
+        m_dropped += length - capacity;
+        data += length - capacity;
+        length = capacity;
+    }
+
+    if (m_size + length > capacity) {
+        size_t overwritten = m_size + length - capacity;
+        m_head = (m_head + overwritten) % capacity;
+        m_size -= overwritten;
+        m_dropped += overwritten;
+    }
+
+    size_t tail = (m_head + m_size) % capacity;
+    size_t first = min(length, capacity - tail);
+    memcpy(&m_buffer[tail], data, first);
+    if (first < length)
+        memcpy(&m_buffer[0], data + first, length - first);
+    m_size += length;
+}
+
+void RingBuffer::clear()
+{
+    m_head = 0;
+    m_size = 0;
+    m_dropped = 0;
+}
+
+string RingBuffer::toString() const
+{
+    string result;
+    size_t capacity = m_buffer.size();
+    if (m_size == 0)
+        return result;
+
+    result.reserve(m_size);
+    size_t first = min(m_size, capacity - m_head);
+    result.append(&m_buffer[m_head], first);
+    if (first < m_size)
+        result.append(&m_buffer[0], m_size - first);
+    return result;
+}
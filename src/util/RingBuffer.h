@@ -0,0 +1,63 @@
+// Copyright (c) 2020 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#ifndef UTIL_RINGBUFFER_H_
+#define UTIL_RINGBUFFER_H_
+
+#include <iostream>
+#include <vector>
+
+using namespace std;
+
+// RingBuffer keeps the last 'capacity' bytes which are appended.
+// Memory is allocated once when capacity is set.
+class RingBuffer {
+public:
+    RingBuffer(size_t capacity = 0);
+    virtual ~RingBuffer();
+
+    void setCapacity(size_t capacity);
+    size_t getCapacity() const
+    {
+        return m_buffer.size();
+    }
+
+    void append(const char* data, size_t length);
+    void clear();
+
+    size_t getSize() const
+    {
+        return m_size;
+    }
+
+    // Bytes which were overwritten since the last clear
+    unsigned long long getDropped() const
+    {
+        return m_dropped;
+    }
+
+    string toString() const;
+
+private:
+    vector<char> m_buffer;
+    size_t m_head;
+    size_t m_size;
+    unsigned long long m_dropped;
+
+};
+
+#endif /* UTIL_RINGBUFFER_H_ */
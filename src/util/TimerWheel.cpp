@@ -0,0 +1,191 @@
+// Copyright (c) 2020 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "TimerWheel.h"
+
+#include <string.h>
+
+TimerWheel::TimerWheel(int tick)
+    : m_tick(tick > 0 ? tick : 1),
+      m_isStarted(false),
+      m_current(0),
+      m_counter(0)
+{
+    memset(m_slots, 0, sizeof(m_slots));
+    memset(m_occupied, 0, sizeof(m_occupied));
+    memset(m_slotExpiry, 0, sizeof(m_slotExpiry));
+}
+
+TimerWheel::~TimerWheel()
+{
+}
+
+unsigned long TimerWheel::add(long long now, int delay, TimerWheelCallback callback)
+{
+    if (!m_isStarted || m_timers.empty()) {
+        // Nothing to fire in between. Jump to now.
+        m_current = now / m_tick;
+        m_isStarted = true;
+    }
+
+    if (delay < 0)
+        delay = 0;
+
+    unsigned long id = ++m_counter;
+    if (id == 0)
+        id = ++m_counter;
+
+    // Rounded up. Timers are never expired earlier than the delay.
+    unsigned long long expiry = (unsigned long long)((now + delay + m_tick - 1) / m_tick);
+    if (expiry <= m_current)
+        expiry = m_current + 1;
+
+    Timer& timer = m_timers[id];
+    timer.id = id;
+    timer.expiry = expiry;
+    timer.callback = callback;
+    place(timer);
+    return id;
+}
+
+bool TimerWheel::remove(unsigned long id)
+{
+    auto it = m_timers.find(id);
+    if (it == m_timers.end())
+        return false;
+
+    unlink(it->second);
+    m_timers.erase(it);
+    return true;
+}
+
+int TimerWheel::advance(long long now)
+{
+    if (!m_isStarted)
+        return 0;
+
+    unsigned long long target = now / m_tick;
+    int count = 0;
+    while (m_current < target) {
+        if (m_timers.empty()) {
+            m_current = target;
+            break;
+        }
+        m_current++;
+
+        // Lower levels wrapped around. Bring timers from upper levels.
+        for (int level = 1; level < LEVELS; ++level) {
+            if ((m_current & ((1ULL << (SLOT_BITS * level)) - 1)) != 0)
+                break;
+            cascade(level);
+        }
+
+        // Timers are taken one by one. Callbacks can remove other timers in the slot.
+        // New timers are never placed in the current slot.
+        Timer** slot = &m_slots[0][m_current & (SLOTS - 1)];
+        while (*slot != nullptr) {
+            Timer& timer = **slot;
+            unlink(timer);
+            if (timer.expiry > m_current) {
+                place(timer);
+                continue;
+            }
+
+            TimerWheelCallback callback = timer.callback;
+            m_timers.erase(timer.id);
+            callback();
+            count++;
+        }
+    }
+    return count;
+}
+
+long long TimerWheel::getNextExpiry() const
+{
+    if (m_timers.empty())
+        return -1;
+
+    // In each level, slots after the current position come first
+    unsigned long long next = 0;
+    for (int level = 0; level < LEVELS; ++level) {
+        uint64_t occupied = m_occupied[level];
+        if (occupied == 0)
+            continue;
+
+        int start = (int)(((m_current >> (SLOT_BITS * level)) + 1) & (SLOTS - 1));
+        uint64_t rotated = (start == 0) ? occupied : (occupied >> start) | (occupied << (SLOTS - start));
+        int slot = (start + __builtin_ctzll(rotated)) & (SLOTS - 1);
+        if (next == 0 || m_slotExpiry[level][slot] < next)
+            next = m_slotExpiry[level][slot];
+    }
+    return (long long)(next * m_tick);
+}
+
+void TimerWheel::place(Timer& timer)
+{
+    // Expired timers are placed in the current slot. advance() handles them right after cascade.
+    unsigned long long delta = timer.expiry > m_current ? timer.expiry - m_current : 0;
+    unsigned long long expiry = m_current + delta;
+
+    int level = 0;
+    while (level < LEVELS - 1 && delta >= (1ULL << (SLOT_BITS * (level + 1))))
+        level++;
+
+    // Too far. It is placed at the end of the wheel and moved again in cascade.
+    unsigned long long max = (1ULL << (SLOT_BITS * LEVELS)) - 1;
+    if (delta > max)
+        expiry = m_current + max;
+
+    timer.level = level;
+    timer.slot = (int)((expiry >> (SLOT_BITS * level)) & (SLOTS - 1));
+
+    Timer*& head = m_slots[timer.level][timer.slot];
+    unsigned long long& slotExpiry = m_slotExpiry[timer.level][timer.slot];
+    if (head == nullptr || timer.expiry < slotExpiry)
+        slotExpiry = timer.expiry;
+    timer.prev = nullptr;
+    timer.next = head;
+    if (head != nullptr)
+        head->prev = &timer;
+    head = &timer;
+    m_occupied[timer.level] |= (1ULL << timer.slot);
+}
+
+void TimerWheel::unlink(Timer& timer)
+{
+    if (timer.prev != nullptr)
+        timer.prev->next = timer.next;
+    else
+        m_slots[timer.level][timer.slot] = timer.next;
+    if (timer.next != nullptr)
+        timer.next->prev = timer.prev;
+
+    if (m_slots[timer.level][timer.slot] == nullptr)
+        m_occupied[timer.level] &= ~(1ULL << timer.slot);
+    timer.prev = nullptr;
+    timer.next = nullptr;
+}
+
+void TimerWheel::cascade(int level)
+{
+    // Timers are always placed in other slots of lower levels (or other slots of the top level)
+    Timer** slot = &m_slots[level][(m_current >> (SLOT_BITS * level)) & (SLOTS - 1)];
+    while (*slot != nullptr) {
+        Timer& timer = **slot;
+        unlink(timer);
+        place(timer);
+    }
+}
@@ -0,0 +1,94 @@
+// Copyright (c) 2020 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef UTIL_TIMERWHEEL_H_
+#define UTIL_TIMERWHEEL_H_
+
+#include <iostream>
+#include <map>
+#include <stdint.h>
+#include <boost/function.hpp>
+
+using namespace std;
+
+typedef boost::function<void()> TimerWheelCallback;
+
+// TimerWheel is a hierarchical timing wheel (4 levels x 64 slots).
+// Adding and removing a timer doesn't depend on the number of timers.
+// Timers in upper levels are moved to lower levels when the lower level wraps around.
+// Each slot is an intrusive list of timers. Each level has a bitmap of occupied slots,
+// so the next expiry is found without scanning timers.
+// It doesn't have its own clock. The owner calls advance() with the current time (ms).
+class TimerWheel {
+public:
+    static const int LEVELS = 4;
+    static const int SLOT_BITS = 6;
+    static const int SLOTS = 1 << SLOT_BITS;
+
+    TimerWheel(int tick = 10);
+    virtual ~TimerWheel();
+
+    // Returns timer id. It is never 0.
+    unsigned long add(long long now, int delay, TimerWheelCallback callback);
+    bool remove(unsigned long id);
+
+    // Calls callbacks of expired timers. Callbacks can add or remove timers.
+    int advance(long long now);
+
+    // Returns the time (ms) when the next timer is expired or -1 if there is no timer.
+    // After a timer is removed, it can be earlier than the actual one until the slot is cascaded.
+    long long getNextExpiry() const;
+
+    size_t size() const
+    {
+        return m_timers.size();
+    }
+
+    int getTick() const
+    {
+        return m_tick;
+    }
+
+private:
+    struct Timer {
+        unsigned long id;
+        unsigned long long expiry;
+        int level;
+        int slot;
+        Timer* prev;
+        Timer* next;
+        TimerWheelCallback callback;
+    };
+
+    void place(Timer& timer);
+    void unlink(Timer& timer);
+    void cascade(int level);
+
+    int m_tick;
+    bool m_isStarted;
+    unsigned long long m_current;
+    unsigned long m_counter;
+
+    map<unsigned long, Timer> m_timers;
+    Timer* m_slots[LEVELS][SLOTS];
+    // Bit N is set if slot N of the level has timers
+    uint64_t m_occupied[LEVELS];
+    // The earliest expiry of each occupied slot. Removal doesn't raise it.
+    unsigned long long m_slotExpiry[LEVELS][SLOTS];
+
+};
+
+#endif /* UTIL_TIMERWHEEL_H_ */
@@ -0,0 +1,229 @@
+// Copyright (c) 2020 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Tracer.h"
+
+#include <stdio.h>
+#include <unistd.h>
+
+#include "util/Logger.h"
+#include "util/Time.h"
+
+bool Tracer::s_isRecording = false;
+unsigned long Tracer::s_lastId = 0;
+unsigned long Tracer::s_currentId = 0;
+
+Tracer::Tracer()
+    : m_count(0),
+      m_droppedCount(0),
+      m_startTime(0),
+      m_stopTime(0),
+      m_dumpThread(nullptr),
+      m_isDumping(false)
+{
+    setClassName("Tracer");
+}
+
+Tracer::~Tracer()
+{
+    if (m_dumpThread != nullptr)
+        g_thread_join(m_dumpThread);
+}
+
+bool Tracer::start(int capacity)
+{
+    if (!isCompiled())
+        return false;
+
+    if (capacity <= 0)
+        capacity = DEFAULT_CAPACITY;
+    if (capacity > MAX_CAPACITY)
+        capacity = MAX_CAPACITY;
+
+    // The previous session is discarded
+    vector<Event>(capacity).swap(m_events);
+    m_count = 0;
+    m_droppedCount = 0;
+    m_startTime = Time::getCurrentTimeUs();
+    m_stopTime = 0;
+    s_isRecording = true;
+
+    LOG_INFO(getClassName(), __FUNCTION__, Logger::format("capacity(%d)", capacity));
+    return true;
+}
+
+void Tracer::stop()
+{
+    if (!s_isRecording)
+        return;
+
+    s_isRecording = false;
+    m_stopTime = Time::getCurrentTimeUs();
+    LOG_INFO(getClassName(), __FUNCTION__, Logger::format("count(%d) dropped(%lld)", (int)m_count, m_droppedCount));
+}
+
+void Tracer::add(char phase, const char* category, const char* name, const char* detail, unsigned long id, unsigned long traceId)
+{
+    if (!s_isRecording)
+        return;
+    if (m_count >= m_events.size()) {
+        m_droppedCount++;
+        return;
+    }
+
+    Event& event = m_events[m_count++];
+    event.phase = phase;
+    event.category = category;
+    event.id = id;
+    event.traceId = traceId;
+    event.time = Time::getCurrentTimeUs();
+    g_strlcpy(event.name, name != nullptr ? name : "", MAX_NAME);
+    g_strlcpy(event.detail, detail != nullptr ? detail : "", MAX_DETAIL);
+}
+
+void Tracer::toJson(JValue& json)
+{
+    json.put("compiled", isCompiled());
+    json.put("recording", s_isRecording);
+    json.put("capacity", (int)m_events.size());
+    json.put("count", (int)m_count);
+    json.put("droppedCount", (int64_t)m_droppedCount);
+    json.put("dumping", m_isDumping.load());
+    if (!m_dumpPath.empty())
+        json.put("dumpPath", m_dumpPath);
+    if (m_startTime > 0)
+        json.put("duration", (int64_t)(((s_isRecording ? Time::getCurrentTimeUs() : m_stopTime) - m_startTime) / 1000));
+}
+
+bool Tracer::dump(const string& path)
+{
+    if (m_isDumping)
+        return false;
+    if (m_dumpThread != nullptr) {
+        g_thread_join(m_dumpThread);
+        m_dumpThread = nullptr;
+    }
+    stop();
+
+    // The worker owns the session. Only 'category' is shared, and it is always a literal.
+    Dump* job = new Dump();
+    job->path = path;
+    job->events.swap(m_events);
+    job->count = m_count;
+    m_count = 0;
+    m_dumpPath = path;
+
+    m_isDumping = true;
+    m_dumpThread = g_thread_new("trace-dump", onDumpThread, job);
+    return true;
+}
+
+gpointer Tracer::onDumpThread(gpointer data)
+{
+    Dump* job = static_cast<Dump*>(data);
+    long long startTime = Time::getCurrentTimeUs();
+    string tmpPath = job->path + ".tmp";
+    int pid = (int)getpid();
+    bool result = false;
+
+    FILE* fp = fopen(tmpPath.c_str(), "w");
+    if (fp != NULL) {
+        result = fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", fp) >= 0;
+        for (size_t i = 0; result && i < job->count; ++i) {
+            if (i > 0 && fputc(',', fp) == EOF)
+                result = false;
+            else
+                result = write(fp, job->events[i], pid);
+        }
+        result = result && fputs("]}\n", fp) >= 0;
+        result = (fclose(fp) == 0) && result;
+        result = result && rename(tmpPath.c_str(), job->path.c_str()) == 0;
+    }
+
+    if (result) {
+        Logger::info(getInstance().getClassName(), __FUNCTION__, job->path,
+                     Logger::format("count(%d) time(%lld ms)", (int)job->count, (Time::getCurrentTimeUs() - startTime) / 1000));
+    } else {
+        unlink(tmpPath.c_str());
+        Logger::warning(getInstance().getClassName(), __FUNCTION__, job->path, "Failed to write trace");
+    }
+    delete job;
+    getInstance().m_isDumping = false;
+    return nullptr;
+}
+
+static bool writeString(FILE* fp, const char* str)
+{
+    if (fputc('"', fp) == EOF)
+        return false;
+    for (const char* c = str; *c != '\0'; ++c) {
+        int result = 0;
+        if (*c == '"' || *c == '\\')
+            result = fprintf(fp, "\\%c", *c);
+        else if ((unsigned char)*c < 0x20)
+            result = fprintf(fp, "\\u%04x", (unsigned char)*c);
+        else
+            result = fputc(*c, fp);
+        if (result < 0)
+            return false;
+    }
+    return fputc('"', fp) != EOF;
+}
+
+bool Tracer::write(FILE* fp, const Event& event, int pid)
+{
+    // Instants without trace ID are not in any async flow. They are thread-scoped instant events.
+    bool result = true;
+    if (event.phase == 'n' && event.id == 0)
+        result = fputs("{\"ph\":\"i\",\"s\":\"t\"", fp) >= 0;
+    else
+        result = fprintf(fp, "{\"ph\":\"%c\"", event.phase) >= 0;
+
+    result = result && fputs(",\"cat\":", fp) >= 0 && writeString(fp, event.category);
+    result = result && fprintf(fp, ",\"ts\":%lld,\"pid\":%d,\"tid\":%d", event.time, pid, pid) >= 0;
+    if (event.phase != 'E')
+        result = result && fputs(",\"name\":", fp) >= 0 && writeString(fp, event.name);
+
+    // Async events are grouped by 'cat' and 'id'
+    if (event.id != 0 && (event.phase == 'b' || event.phase == 'n' || event.phase == 'e'))
+        result = result && fprintf(fp, ",\"id\":\"0x%lx\"", event.id) >= 0;
+
+    result = result && fputs(",\"args\":{", fp) >= 0;
+    if (event.detail[0] != '\0')
+        result = result && fputs("\"detail\":", fp) >= 0 && writeString(fp, event.detail);
+    if (event.traceId != 0)
+        result = result && fprintf(fp, "%s\"traceId\":%lu", event.detail[0] != '\0' ? "," : "", event.traceId) >= 0;
+    return result && fputs("}}", fp) >= 0;
+}
+
+TraceScope::TraceScope(const char* category, const char* name, const char* detail, unsigned long traceId)
+    : m_category(category),
+      m_traceId(traceId != 0 ? traceId : Tracer::getCurrentId()),
+      m_parentId(Tracer::getCurrentId()),
+      m_isRecorded(Tracer::isRecording())
+{
+    Tracer::setCurrentId(m_traceId);
+    if (m_isRecorded)
+        Tracer::getInstance().add('B', m_category, name, detail, 0, m_traceId);
+}
+
+TraceScope::~TraceScope()
+{
+    // 'E' closes the latest 'B'. It doesn't need the name
+    if (m_isRecorded)
+        Tracer::getInstance().add('E', m_category, nullptr, nullptr, 0, m_traceId);
+    Tracer::setCurrentId(m_parentId);
+}
@@ -0,0 +1,185 @@
+// Copyright (c) 2020 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef UTIL_TRACER_H_
+#define UTIL_TRACER_H_
+
+#include <atomic>
+#include <iostream>
+#include <vector>
+#include <glib.h>
+#include <pbnjson.hpp>
+
+#include "interface/ISingleton.h"
+#include "interface/IClassName.h"
+
+using namespace std;
+using namespace pbnjson;
+
+// Tracepoints are compiled only with ENABLE_TRACEPOINTS (cmake option, ON by default).
+// Without it, events are removed but TRACE_SCOPE still sets the current trace ID.
+//  - TRACE_SCOPE   : duration of the current scope. The trace ID is the current one until the scope ends
+//  - TRACE_INSTANT : single point in the flow of the trace ID
+//  - TRACE_ASYNC_* : span which is ended in another callback (e.g. outbound calls, launches)
+// 'name' and 'detail' are copied. They don't need to live after the call.
+#ifdef ENABLE_TRACEPOINTS
+#define TRACE_SCOPE(category, name, detail, traceId) \
+    TraceScope _traceScope((category), (name), (detail), (traceId))
+#define TRACE_INSTANT(category, name, detail, traceId) \
+    do { if (Tracer::isRecording()) Tracer::getInstance().add('n', (category), (name), (detail), (traceId), (traceId)); } while (0)
+#define TRACE_ASYNC_BEGIN(category, name, detail, id, traceId) \
+    do { if (Tracer::isRecording()) Tracer::getInstance().add('b', (category), (name), (detail), (id), (traceId)); } while (0)
+#define TRACE_ASYNC_END(category, name, detail, id, traceId) \
+    do { if (Tracer::isRecording()) Tracer::getInstance().add('e', (category), (name), (detail), (id), (traceId)); } while (0)
+#else
+#define TRACE_SCOPE(category, name, detail, traceId) \
+    TraceIdScope _traceIdScope((traceId))
+#define TRACE_INSTANT(category, name, detail, traceId) do {} while (0)
+#define TRACE_ASYNC_BEGIN(category, name, detail, id, traceId) do {} while (0)
+#define TRACE_ASYNC_END(category, name, detail, id, traceId) do {} while (0)
+#endif
+
+// Tracer records tracepoints of the main loop while a session is started.
+// The session buffer is allocated when the session starts. Recording stops when it is full.
+// The session is dumped as Chrome trace-event JSON, which can be loaded in Perfetto or chrome://tracing.
+// The dump takes over the session buffer and streams it to a file in a worker thread.
+class Tracer : public ISingleton<Tracer>,
+               public IClassName {
+friend class ISingleton<Tracer>;
+public:
+    static const int DEFAULT_CAPACITY = 16384; // events
+    static const int MAX_CAPACITY = 262144;
+    static const int MAX_NAME = 48;
+    static const int MAX_DETAIL = 64;
+
+    static bool isCompiled()
+    {
+#ifdef ENABLE_TRACEPOINTS
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    static bool isRecording()
+    {
+        return s_isRecording;
+    }
+
+    // Trace IDs are used to follow a request across callbacks
+    static unsigned long newId()
+    {
+        return ++s_lastId;
+    }
+    static unsigned long getCurrentId()
+    {
+        return s_currentId;
+    }
+    static void setCurrentId(unsigned long traceId)
+    {
+        s_currentId = traceId;
+    }
+
+    virtual ~Tracer();
+
+    bool start(int capacity);
+    void stop();
+    void add(char phase, const char* category, const char* name, const char* detail, unsigned long id, unsigned long traceId);
+
+    // Stops recording and writes the session to 'path' in background.
+    // Returns false if the previous dump is still in progress.
+    bool dump(const string& path);
+
+    void toJson(JValue& json);
+
+private:
+    struct Event {
+        char phase;
+        const char* category;
+        unsigned long id;
+        unsigned long traceId;
+        long long time;
+        char name[MAX_NAME];
+        char detail[MAX_DETAIL];
+    };
+
+    struct Dump {
+        string path;
+        vector<Event> events;
+        size_t count;
+    };
+
+    static bool s_isRecording;
+    static unsigned long s_lastId;
+    static unsigned long s_currentId;
+
+    static gpointer onDumpThread(gpointer data);
+    static bool write(FILE* fp, const Event& event, int pid);
+
+    Tracer();
+
+    vector<Event> m_events;
+    size_t m_count;
+    long long m_droppedCount;
+    long long m_startTime;
+    long long m_stopTime;
+
+    GThread* m_dumpThread;
+    atomic<bool> m_isDumping;
+    string m_dumpPath;
+
+};
+
+// TraceIdScope only sets the current trace ID until the scope ends
+class TraceIdScope {
+public:
+    TraceIdScope(unsigned long traceId)
+        : m_parentId(Tracer::getCurrentId())
+    {
+        if (traceId != 0)
+            Tracer::setCurrentId(traceId);
+    }
+
+    virtual ~TraceIdScope()
+    {
+        Tracer::setCurrentId(m_parentId);
+    }
+
+private:
+    TraceIdScope(const TraceIdScope&) = delete;
+    TraceIdScope& operator=(const TraceIdScope&) = delete;
+
+    unsigned long m_parentId;
+
+};
+
+class TraceScope {
+public:
+    TraceScope(const char* category, const char* name, const char* detail, unsigned long traceId);
+    virtual ~TraceScope();
+
+private:
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+    const char* m_category;
+    unsigned long m_traceId;
+    unsigned long m_parentId;
+    bool m_isRecorded;
+
+};
+
+#endif /* UTIL_TRACER_H_ */
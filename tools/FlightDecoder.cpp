@@ -0,0 +1,222 @@
+// Copyright (c) 2020 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// sam-flight-decoder prints records of a flight recorder file (PATH_FLIGHT_RECORDER) in time order.
+// It doesn't depend on SAM libraries, so it can be built and used on a host machine.
+//
+// usage: sam-flight-decoder <file> [count]
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <vector>
+
+#include "util/FlightRecord.h"
+
+using namespace std;
+
+static const char* getTypeName(uint8_t type)
+{
+    switch (type) {
+    case FlightRecordType_Start:
+        return "start";
+
+    case FlightRecordType_LifeStatus:
+        return "life";
+
+    case FlightRecordType_ApiRequest:
+        return "api>";
+
+    case FlightRecordType_ApiResponse:
+        return "api<";
+
+    case FlightRecordType_CallRequest:
+        return "call>";
+
+    case FlightRecordType_CallResponse:
+        return "call<";
+
+    case FlightRecordType_ChildExit:
+        return "exit";
+
+    case FlightRecordType_Stall:
+        return "stall";
+
+    default:
+        return "unknown";
+    }
+}
+
+class FlightDecoder {
+public:
+    FlightDecoder()
+        : m_header(nullptr),
+          m_strings(nullptr),
+          m_records(nullptr)
+    {
+    }
+
+    bool load(const char* path)
+    {
+        FILE* file = fopen(path, "rb");
+        if (file == nullptr) {
+            fprintf(stderr, "Failed to open %s: %s\n", path, strerror(errno));
+            return false;
+        }
+
+        char buffer[4096];
+        size_t size = 0;
+        while ((size = fread(buffer, 1, sizeof(buffer), file)) > 0)
+            m_data.insert(m_data.end(), buffer, buffer + size);
+        fclose(file);
+
+        if (m_data.size() < FLIGHT_HEADER_SIZE) {
+            fprintf(stderr, "Too small file: %zu bytes\n", m_data.size());
+            return false;
+        }
+        m_header = (const FlightHeader*)m_data.data();
+        if (m_header->magic != FLIGHT_MAGIC || m_header->version != FLIGHT_VERSION) {
+            fprintf(stderr, "Unsupported file: magic(0x%08x) version(%u)\n", m_header->magic, m_header->version);
+            return false;
+        }
+        if (m_header->recordSize != sizeof(FlightRecord) || m_header->capacity == 0 ||
+            (m_header->capacity & (m_header->capacity - 1)) != 0) {
+            fprintf(stderr, "Invalid layout: recordSize(%u) capacity(%u)\n", m_header->recordSize, m_header->capacity);
+            return false;
+        }
+
+        size_t expected = FLIGHT_HEADER_SIZE + sizeof(FlightString) * m_header->stringCapacity + sizeof(FlightRecord) * m_header->capacity;
+        if (m_data.size() < expected) {
+            fprintf(stderr, "Truncated file: %zu bytes (expected %zu)\n", m_data.size(), expected);
+            return false;
+        }
+        m_strings = (const FlightString*)(m_data.data() + FLIGHT_HEADER_SIZE);
+        m_records = (const FlightRecord*)((const char*)m_strings + sizeof(FlightString) * m_header->stringCapacity);
+        return true;
+    }
+
+    void print(uint64_t count)
+    {
+        uint64_t head = m_header->head;
+        uint64_t first = head > m_header->capacity ? head - m_header->capacity + 1 : 1;
+        if (count > 0 && head >= count && head - count + 1 > first)
+            first = head - count + 1;
+
+        printf("# pid(%d) capacity(%u) strings(%u) records(%llu..%llu)\n",
+               m_header->pid, m_header->capacity, m_header->stringCount,
+               (unsigned long long)first, (unsigned long long)head);
+
+        int tornCount = 0;
+        for (uint64_t seq = first; seq <= head; ++seq) {
+            const FlightRecord& record = m_records[seq & (m_header->capacity - 1)];
+            // The record was being written when SAM stopped
+            if (record.seq != (uint32_t)seq) {
+                tornCount++;
+                continue;
+            }
+            printRecord(record);
+        }
+        if (tornCount > 0)
+            printf("# %d torn records are skipped\n", tornCount);
+    }
+
+private:
+    const char* getString(uint32_t index)
+    {
+        if (index == 0 || index >= m_header->stringCount || index >= m_header->stringCapacity)
+            return "-";
+        // Strings are always terminated by the recorder. This is for broken files
+        static char text[FLIGHT_STRING_SIZE];
+        memcpy(text, m_strings[index].text, FLIGHT_STRING_SIZE);
+        text[FLIGHT_STRING_SIZE - 1] = '\0';
+        return text;
+    }
+
+    void printTime(int64_t time)
+    {
+        int64_t realTime = m_header->startRealTime + (time - m_header->startTime);
+        time_t seconds = (time_t)(realTime / 1000000);
+        struct tm tm;
+        char buffer[32];
+        localtime_r(&seconds, &tm);
+        strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &tm);
+        printf("%s.%06d %10.3f ", buffer, (int)(realTime % 1000000), (time - m_header->startTime) / 1000000.0);
+    }
+
+    void printRecord(const FlightRecord& record)
+    {
+        printTime(record.time);
+        printf("%-7s ", getTypeName(record.type));
+
+        switch (record.type) {
+        case FlightRecordType_Start:
+            printf("pid(%d)\n", record.arg0);
+            break;
+
+        case FlightRecordType_LifeStatus:
+            printf("%s ", getString(record.subject));
+            printf("%s => ", getString(record.arg0));
+            printf("%s pid(%d)\n", getString(record.detail), record.arg1);
+            break;
+
+        case FlightRecordType_ApiRequest:
+        case FlightRecordType_CallRequest:
+            printf("%s size(%d)\n", getString(record.subject), record.arg0);
+            break;
+
+        case FlightRecordType_ApiResponse:
+        case FlightRecordType_CallResponse:
+            printf("%s errorCode(%d) latency(%dms)\n", getString(record.subject), record.arg0, record.arg1);
+            break;
+
+        case FlightRecordType_ChildExit:
+            printf("%s pid(%d) status(%d)\n", getString(record.subject), record.arg0, record.arg1);
+            break;
+
+        case FlightRecordType_Stall:
+            printf("%s duration(%dms)\n", getString(record.subject), record.arg0);
+            break;
+
+        default:
+            printf("type(%u) subject(%u) detail(%u) arg0(%d) arg1(%d)\n",
+                   record.type, record.subject, record.detail, record.arg0, record.arg1);
+            break;
+        }
+    }
+
+    vector<char> m_data;
+    const FlightHeader* m_header;
+    const FlightString* m_strings;
+    const FlightRecord* m_records;
+
+};
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <file> [count]\n", argv[0]);
+        return 1;
+    }
+
+    uint64_t count = argc > 2 ? strtoull(argv[2], nullptr, 10) : 0;
+    FlightDecoder decoder;
+    if (!decoder.load(argv[1]))
+        return 1;
+    decoder.print(count);
+    return 0;
+}
@@ -0,0 +1,92 @@
+// Copyright (c) 2020 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// sam-logger-bench compares the cost paid by callers of synchronous and asynchronous logging.
+// Logs are written in bursts like the main loop does. stdout goes to /dev/null unless 'console' is given,
+// so the result shows the cost of Logger itself rather than the terminal.
+//
+// usage: sam-logger-bench [count] [burst] [console]
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "util/Logger.h"
+
+static const int DEFAULT_COUNT = 100000;
+static const int DEFAULT_BURST = 64;
+// Time between bursts. The logger thread runs here.
+static const int IDLE_TIME = 200; // us
+
+static long long run(int count, int burst)
+{
+    long long total = 0;
+    for (int i = 0; i < count; i += burst) {
+        long long startTime = g_get_monotonic_time();
+        for (int j = i; j < i + burst && j < count; ++j) {
+            Logger::info("LoggerBench", __FUNCTION__, "com.webos.app.bench",
+                         Logger::format("Launch Time: %d ms (%s)", j, "bench"));
+        }
+        total += g_get_monotonic_time() - startTime;
+        usleep(IDLE_TIME);
+    }
+    return total;
+}
+
+static void print(const char* mode, int count, long long total)
+{
+    JValue json = pbnjson::Object();
+    Logger::getInstance().toJson(json);
+
+    long long dropped = 0;
+    for (JValue::KeyValue level : json["droppedCount"].children())
+        dropped += level.second.asNumber<int64_t>();
+    fprintf(stderr, "%-6s count(%d) total(%lld us) perCall(%lld ns) dropped(%lld)\n",
+            mode, count, total, total * 1000 / count, dropped);
+}
+
+int main(int argc, char** argv)
+{
+    int count = argc > 1 ? atoi(argv[1]) : DEFAULT_COUNT;
+    int burst = argc > 2 ? atoi(argv[2]) : DEFAULT_BURST;
+    bool isConsole = argc > 3 && strcmp(argv[3], "console") == 0;
+    if (count <= 0 || burst <= 0) {
+        fprintf(stderr, "usage: %s [count] [burst] [console]\n", argv[0]);
+        return 1;
+    }
+
+    if (!isConsole) {
+        int fd = open("/dev/null", O_WRONLY);
+        if (fd >= 0) {
+            dup2(fd, STDOUT_FILENO);
+            close(fd);
+        }
+    }
+    unsetenv("LOG_SYNC");
+    Logger::getInstance().setLevel(LogLevel_INFO);
+    Logger::getInstance().setType(LogType_CONSOLE);
+
+    long long syncTotal = run(count, burst);
+    print("sync", count, syncTotal);
+
+    Logger::getInstance().startAsync();
+    long long asyncTotal = run(count, burst);
+    Logger::getInstance().stopAsync();
+    print("async", count, asyncTotal);
+    return 0;
+}